@@ -0,0 +1,188 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   include/json_array_index.h
+ * Description: secondary hash indexes over arrays of objects
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_JSON_ARRAY_INDEX_H_INCLUDED
+#define NS_UTIL_JSON_ARRAY_INDEX_H_INCLUDED
+
+#include "json_key_path.h"
+#include "json_types.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace util
+{
+/**
+ * How a change reported to JsonArrayIndexes::prepare() modifies the node at its path.
+ */
+enum class JsonArrayEdit : uint8_t
+{
+    set,     ///< JsonObject::set(): [^] and [$] insert an element
+    append,  ///< the array at the path grows at its end
+    prepend, ///< the array at the path grows at its front
+    insert   ///< the array at the path grows anywhere, or may have been replaced
+};
+
+/**
+ * Secondary hash indexes from the text of one member of the objects in an array to their position, as used to resolve
+ * selectors like users/[id=abc123]. An index is identified by the path of its array, which may only hold string keys
+ * and positions, and the member name.
+ * <br>The indexes do not observe the document: every change must be reported through prepare() and apply(), or through
+ * invalidateAll(). Appends and prepends to the array and changes of one element are applied in O(1); every other
+ * change that may affect an array marks its index stale, and a stale index is rebuilt at the next lookup. Positions
+ * are stored relative to a base that prepends move, so that prepending does not renumber the elements. When several
+ * elements share a text, a lookup yields the first of them, like a scan would.
+ * <br>Copies keep the definitions and rebuild at their first lookup. All members are thread-safe.
+ */
+class JsonArrayIndexes
+{
+  public:
+    using KeySpan = std::span<std::shared_ptr<JsonKey> const>;
+
+    /**
+     * A change of one index, computed by prepare() before the document is modified.
+     */
+    struct Change
+    {
+        enum class Kind : uint8_t
+        {
+            stale,
+            append,
+            prepend,
+            element
+        };
+
+        size_t                     index    = 0;
+        Kind                       kind     = Kind::stale;
+        array_type const          *array    = nullptr;
+        size_t                     size     = 0;
+        size_t                     position = 0;
+        std::optional<std::string> oldText{};
+    };
+
+    JsonArrayIndexes() = default;
+    JsonArrayIndexes(JsonArrayIndexes const &other);
+    JsonArrayIndexes &operator=(JsonArrayIndexes const &other);
+
+    /**
+     * @brief Add an index; it is built now if root holds an array at arrayPath, at its first lookup otherwise.
+     * @param root the document
+     * @param arrayPath key-path of the array; only string keys and positions
+     * @param field member of the elements to index
+     * @return false if the index already exists
+     * @throws std::invalid_argument when arrayPath holds [^], [$] or a selector, or field is not a valid string key
+     */
+    bool create(value_type const &root, JsonKeyPath const &arrayPath, std::string_view field);
+
+    /**
+     * @brief Remove an index.
+     * @return false if there was no such index
+     */
+    bool drop(JsonKeyPath const &arrayPath, std::string_view field);
+
+    /**
+     * @brief Whether no index is defined; then there is nothing to report.
+     */
+    [[nodiscard]] bool empty() const;
+
+    /**
+     * @brief Resolve an index key in an array, through an index if the key is a selector that one covers.
+     * @param base key-path of the node that prefix starts at, empty if that is the root
+     * @param prefix rest of the key-path of the array
+     * @param key the key
+     * @param array the array
+     * @return the position, or -1 if a selector matches no element
+     */
+    [[nodiscard]] int64_t
+        resolve(KeySpan base, KeySpan prefix, JsonIndexKey const &key, array_type const &array) const;
+
+    /**
+     * @brief Compute the changes of the indexes that a modification of the node at path will cause.
+     * @param root the document before the modification
+     * @param path key-path from the root of the modified node
+     * @param edit the kind of modification
+     * @return the changes, to pass to apply() after the modification
+     */
+    [[nodiscard]] std::vector<Change> prepare(value_type const &root, JsonKeyPath const &path, JsonArrayEdit edit);
+
+    /**
+     * @brief Apply changes computed by prepare().
+     * @param changes the changes
+     * @param succeeded false if the modification failed part-way; the affected indexes are then marked stale
+     */
+    void apply(std::vector<Change> const &changes, bool succeeded);
+
+    /**
+     * @brief Mark all indexes stale after an arbitrary modification of the document.
+     */
+    void invalidateAll();
+
+  private:
+    struct StringHash
+    {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view str) const
+        {
+            return std::hash<std::string_view>{}(str);
+        }
+    };
+
+    struct Index
+    {
+        JsonKeyPath                                                           arrayPath;
+        std::string                                                           field;
+        std::unordered_map<std::string, int64_t, StringHash, std::equal_to<>> positions{};
+        int64_t                                                               base       = 0;
+        bool                                                                  stale      = true;
+        bool                                                                  duplicates = false;
+
+        void    rebuild(array_type const &array);
+        void    add(array_type const &array, size_t position);
+        int64_t find(array_type const &array, std::string_view text);
+    };
+
+    mutable std::mutex         mutex_;
+    mutable std::vector<Index> indexes_;
+
+    [[nodiscard]] static bool              covers(Index const &index, KeySpan base, KeySpan prefix);
+    [[nodiscard]] static array_type const *locate(value_type const &root, JsonKeyPath const &arrayPath);
+    [[nodiscard]] int64_t
+        resolveLocked(KeySpan base, KeySpan prefix, JsonIndexKey const &key, array_type const &array) const;
+    [[nodiscard]] std::optional<Change>
+        classify(Index const &index, value_type const &root, JsonKeyPath const &path, JsonArrayEdit edit) const;
+};
+
+} // namespace util
+
+#endif // NS_UTIL_JSON_ARRAY_INDEX_H_INCLUDED
@@ -0,0 +1,291 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   include/json_async.h
+ * Description: coroutine awaitables for background json i/o
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_JSON_ASYNC_H_INCLUDED
+#define NS_UTIL_JSON_ASYNC_H_INCLUDED
+
+#include "json_thread_pool.h"
+#include "json_types.h"
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace util
+{
+/**
+ * Exception thrown by an asynchronous operation whose stop token was triggered.
+ */
+class cancelled_error : public std::runtime_error
+{
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * Settings of an asynchronous operation.
+ */
+struct JsonAsyncOptions
+{
+    JsonThreadPool *pool = nullptr; ///< pool to run on; JsonThreadPool::shared() if nullptr
+    /**
+     * Resumes the awaiting coroutine, e.g. by posting the handle to the event loop it came from. If empty, the
+     * coroutine is resumed on the pool thread that finished the operation.
+     */
+    std::function<void(std::coroutine_handle<>)> executor{};
+    std::stop_token                              stop{};                 ///< checked between chunks
+    size_t                                       chunkSize = 1UL << 20U; ///< bytes read or written at once
+};
+
+/**
+ * A job that is started on a pool but may be run by whoever waits for it first, so waiting never depends on a free
+ * worker.
+ */
+class JsonPendingTask
+{
+  public:
+    JsonPendingTask() = default;
+
+    JsonPendingTask(JsonPendingTask const &)            = delete;
+    JsonPendingTask &operator=(JsonPendingTask const &) = delete;
+
+    /**
+     * @brief Wait for a started job, so it cannot outlive what it refers to; its exception is dropped.
+     */
+    ~JsonPendingTask();
+
+    /**
+     * @brief Queue job on pool; a job started before must have been waited for.
+     */
+    void start(JsonThreadPool &pool, std::move_only_function<void()> job);
+
+    /**
+     * @brief Wait for the job, running it here if no worker has picked it up yet; a no-op if nothing was started.
+     * @throws whatever the job threw
+     */
+    void wait();
+
+    /**
+     * @brief Whether a job was started and not waited for.
+     */
+    [[nodiscard]] bool pending() const;
+
+  private:
+    struct State
+    {
+        enum class Status : uint8_t
+        {
+            queued,
+            running,
+            done
+        };
+
+        std::mutex                       mutex;
+        std::condition_variable          finished;
+        Status                           status = Status::queued;
+        std::move_only_function<void()>  job;
+        std::exception_ptr               error;
+
+        bool claim();
+        void run();
+    };
+
+    std::shared_ptr<State> state_;
+};
+
+/**
+ * Reads a file chunk by chunk, fetching the next chunk on a pool while the caller works on the current one. At most
+ * two chunks are held in memory.
+ */
+class JsonChunkReader
+{
+  public:
+    /**
+     * @brief Open a file.
+     * @param filename name of the file
+     * @param chunkSize bytes per chunk
+     * @param pool pool for reading ahead
+     * @throws std::invalid_argument when the file cannot be opened for reading
+     */
+    JsonChunkReader(std::string const &filename, size_t chunkSize, JsonThreadPool &pool);
+
+    JsonChunkReader(JsonChunkReader const &)            = delete;
+    JsonChunkReader &operator=(JsonChunkReader const &) = delete;
+    ~JsonChunkReader()                                  = default;
+
+    /**
+     * @brief Get the next chunk.
+     * @return the chunk, valid until the next call; empty at the end of the file
+     */
+    std::string_view next();
+
+  private:
+    std::ifstream   ifs_;
+    size_t          chunkSize_;
+    JsonThreadPool &pool_;
+    std::string     current_;
+    std::string     ahead_;
+    bool            started_ = false;
+    JsonPendingTask readAhead_; ///< last, so an outstanding read-ahead finishes before the buffers are destroyed
+
+    void read(std::string &chunk);
+};
+
+/**
+ * Hands out the json text of a value chunk by chunk: compact text is serialised as the chunks are requested, so it is
+ * never held in full; text rendered beforehand, e.g. indented, is cut into chunks.
+ */
+class JsonChunkSerializer
+{
+  public:
+    /**
+     * @brief Serialise value compactly; value must outlive the serializer and stay unchanged.
+     */
+    JsonChunkSerializer(value_type const &value, size_t chunkSize);
+
+    /**
+     * @brief Cut rendered text into chunks.
+     */
+    JsonChunkSerializer(std::string text, size_t chunkSize);
+
+    /**
+     * @brief Produce the next chunk.
+     * @param chunk buffer replaced by the next chunk
+     * @return false at the end of the text, then chunk is unspecified
+     */
+    bool next(std::string &chunk);
+
+  private:
+    boost::json::serializer serializer_;
+    std::string             text_;
+    size_t                  textPos_ = 0;
+    bool                    rendered_;
+    size_t                  chunkSize_;
+};
+
+/**
+ * Awaitable running an operation on a thread pool; the operation starts when it is awaited, not when it is created.
+ * @tparam T result of the operation
+ */
+template<typename T>
+class [[nodiscard]] JsonAsync
+{
+  public:
+    using Work = std::move_only_function<T(std::stop_token const &)>;
+
+    /**
+     * @brief Wrap an operation.
+     * @param work the operation; gets the stop token of options and should check it between chunks
+     * @param options pool, executor and cancellation
+     */
+    JsonAsync(Work work, JsonAsyncOptions options)
+        : work_(std::move(work))
+        , options_(std::move(options))
+    {
+    }
+
+    JsonAsync(JsonAsync &&) noexcept            = default;
+    JsonAsync &operator=(JsonAsync &&) noexcept = default;
+
+    [[nodiscard]] bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> awaiter)
+    {
+        auto &pool = options_.pool == nullptr ? JsonThreadPool::shared() : *options_.pool;
+        pool.submit([this, awaiter] {
+            try
+            {
+                if (options_.stop.stop_requested())
+                {
+                    throw cancelled_error("operation cancelled");
+                }
+                if constexpr (std::is_void_v<T>)
+                {
+                    work_(options_.stop);
+                    result_.emplace();
+                }
+                else
+                {
+                    result_.emplace(work_(options_.stop));
+                }
+            }
+            catch (...)
+            {
+                error_ = std::current_exception();
+            }
+            // this awaitable may be gone as soon as the coroutine runs again, so nothing of it may be used after
+            auto executor = std::move(options_.executor);
+            if (executor)
+            {
+                executor(awaiter);
+            }
+            else
+            {
+                awaiter.resume();
+            }
+        });
+    }
+
+    T await_resume()
+    {
+        if (error_)
+        {
+            std::rethrow_exception(error_);
+        }
+        if constexpr (!std::is_void_v<T>)
+        {
+            return std::move(*result_);
+        }
+    }
+
+  private:
+    using Result = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+    Work                  work_;
+    JsonAsyncOptions      options_;
+    std::optional<Result> result_;
+    std::exception_ptr    error_;
+};
+
+} // namespace util
+
+#endif // NS_UTIL_JSON_ASYNC_H_INCLUDED
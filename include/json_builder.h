@@ -0,0 +1,193 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   include/json_builder.h
+ * Description: streaming construction of json documents and text
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_JSON_BUILDER_H_INCLUDED
+#define NS_UTIL_JSON_BUILDER_H_INCLUDED
+
+#include "json_types.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace util
+{
+/**
+ * Builds a json value front to back: beginObject()/beginArray() open a container, key() names the next member of an
+ * object, value() adds a value and end() closes the innermost container. Containers are written directly into the
+ * tree, reserving the size hints given when they are opened, and a closed container is moved into its parent, so
+ * there are no path lookups and no element-by-element growth as with set(path, value, true).
+ * <br>Calls out of order, e.g. value() in an object without key(), throw std::invalid_argument.
+ * @code
+ * JsonBuilder builder;
+ * builder.beginObject(2).key("id").value(7).key("tags").beginArray(2).value("a").value("b").end().end();
+ * value_type doc = builder.release(); // {"id":7,"tags":["a","b"]}
+ * @endcode
+ */
+class JsonBuilder
+{
+  public:
+    /**
+     * @brief Create a builder.
+     * @param storage memory resource for the built value
+     */
+    explicit JsonBuilder(storage_type storage = {});
+
+    /**
+     * @brief Open an object.
+     * @param sizeHint expected number of members
+     * @return this builder
+     */
+    JsonBuilder &beginObject(size_t sizeHint = 0);
+
+    /**
+     * @brief Open an array.
+     * @param sizeHint expected number of elements
+     * @return this builder
+     */
+    JsonBuilder &beginArray(size_t sizeHint = 0);
+
+    /**
+     * @brief Name the next member of the innermost object.
+     * @param name the key
+     * @return this builder
+     */
+    JsonBuilder &key(std::string_view name);
+
+    /**
+     * @brief Add a value, which may also be a complete object or array.
+     * @param val the value
+     * @return this builder
+     */
+    JsonBuilder &value(value_type val);
+
+    /**
+     * @brief Close the innermost container.
+     * @return this builder
+     */
+    JsonBuilder &end();
+
+    /**
+     * @brief Whether a complete value has been built.
+     */
+    [[nodiscard]] bool complete() const;
+
+    /**
+     * @brief Take the built value; the builder starts over.
+     * @return the value
+     * @throws std::invalid_argument when the value is not complete
+     */
+    [[nodiscard]] value_type release();
+
+  private:
+    struct Frame
+    {
+        value_type  container{};
+        std::string key{};
+        bool        hasKey = false;
+    };
+
+    storage_type       storage_;
+    std::vector<Frame> frames_;
+    value_type         result_;
+    bool               complete_ = false;
+
+    void checkCanAdd() const;
+    void add(value_type &&val);
+};
+
+/**
+ * Writes compact json text with the interface of JsonBuilder, without building a document. Strings are escaped and
+ * numbers formatted as they are written, so memory is the output plus one entry per open container.
+ * <br>Calls out of order throw std::invalid_argument.
+ */
+class JsonWriter
+{
+  public:
+    /**
+     * @brief Create a writer that appends to out.
+     * @param out the text buffer; must outlive the writer
+     */
+    explicit JsonWriter(std::string &out);
+
+    /**
+     * @brief Open an object.
+     * @param sizeHint ignored; accepted so that JsonWriter and JsonBuilder can be used interchangeably
+     * @return this writer
+     */
+    JsonWriter &beginObject(size_t sizeHint = 0);
+
+    /**
+     * @brief Open an array.
+     * @param sizeHint ignored; accepted so that JsonWriter and JsonBuilder can be used interchangeably
+     * @return this writer
+     */
+    JsonWriter &beginArray(size_t sizeHint = 0);
+
+    /**
+     * @brief Write the key of the next member of the innermost object.
+     * @param name the key
+     * @return this writer
+     */
+    JsonWriter &key(std::string_view name);
+
+    /**
+     * @brief Write a value, which may also be a complete object or array.
+     * @param val the value
+     * @return this writer
+     */
+    JsonWriter &value(value_type const &val);
+
+    /**
+     * @brief Close the innermost container.
+     * @return this writer
+     */
+    JsonWriter &end();
+
+    /**
+     * @brief Whether a complete value has been written.
+     */
+    [[nodiscard]] bool complete() const;
+
+  private:
+    struct Frame
+    {
+        bool   isObject = false;
+        size_t count    = 0;
+        bool   hasKey   = false;
+    };
+
+    std::string       &out_;
+    std::vector<Frame> frames_;
+    bool               complete_ = false;
+
+    void beforeValue();
+    void writeString(std::string_view str);
+};
+
+} // namespace util
+
+#endif // NS_UTIL_JSON_BUILDER_H_INCLUDED
@@ -0,0 +1,181 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   include/json_column.h
+ * Description: numeric columns extracted from json arrays
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_JSON_COLUMN_H_INCLUDED
+#define NS_UTIL_JSON_COLUMN_H_INCLUDED
+
+#include "json_key_path.h"
+#include "json_types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace util
+{
+/**
+ * Implementation of the aggregations of JsonColumn.
+ */
+enum class JsonColumnKernel : uint8_t
+{
+    automatic, ///< AVX2 where the CPU supports it, scalar otherwise
+    scalar     ///< portable loop, e.g. to compare against
+};
+
+/**
+ * @brief Whether JsonColumnKernel::automatic uses AVX2 on this machine.
+ * @return true if the library was built for x86 and the CPU supports AVX2
+ */
+[[nodiscard]] bool json_column_vectorized();
+
+/**
+ * A numeric field of all elements of an array, stored contiguously for aggregation.
+ * <br>Element i of the array becomes slot i of the column. A slot is valid when the field exists and holds a finite
+ * number, which for int64_t must also be integral and in range; otherwise it is null, its bit in the validity bitmap is
+ * clear and its value is 0.
+ * <br>The aggregations give the same result with either kernel: the scalar kernel accumulates in the same four lanes
+ * and the same order as the vectorized one.
+ * @tparam T double or int64_t
+ */
+template<typename T>
+class JsonColumn
+{
+    static_assert(std::is_same_v<T, double> || std::is_same_v<T, int64_t>, "JsonColumn holds double or int64_t");
+
+    std::vector<T>        values_;
+    std::vector<uint64_t> validity_;
+    size_t                validCount_ = 0;
+
+  public:
+    JsonColumn() = default;
+
+    /**
+     * @brief Extract field from each element of array.
+     * @param array the elements
+     * @param field key-path relative to each element; the empty path takes the elements themselves. Selectors are
+     * resolved by scanning.
+     * @return the column, one slot per element
+     */
+    [[nodiscard]] static JsonColumn extract(array_type const &array, JsonKeyPath const &field);
+
+    /**
+     * @brief Make room for capacity slots.
+     */
+    void reserve(size_t capacity);
+
+    /**
+     * @brief Append a valid slot.
+     */
+    void push_back(T value);
+
+    /**
+     * @brief Append a null slot.
+     */
+    void pushNull();
+
+    [[nodiscard]] size_t size() const
+    {
+        return values_.size();
+    }
+
+    [[nodiscard]] bool empty() const
+    {
+        return values_.empty();
+    }
+
+    [[nodiscard]] size_t validCount() const
+    {
+        return validCount_;
+    }
+
+    [[nodiscard]] size_t nullCount() const
+    {
+        return values_.size() - validCount_;
+    }
+
+    /**
+     * @brief The slots, with 0 in null slots.
+     */
+    [[nodiscard]] std::span<T const> values() const
+    {
+        return values_;
+    }
+
+    /**
+     * @brief The validity bitmap: bit i % 64 of word i / 64 is set if slot i is valid.
+     */
+    [[nodiscard]] std::span<uint64_t const> validity() const
+    {
+        return validity_;
+    }
+
+    [[nodiscard]] bool isValid(size_t slot) const
+    {
+        return ((validity_[slot / 64] >> (slot % 64)) & 1U) != 0;
+    }
+
+    /**
+     * @brief Retrieve a slot.
+     * @return the value, or std::nullopt for a null slot
+     */
+    [[nodiscard]] std::optional<T> operator[](size_t slot) const
+    {
+        return isValid(slot) ? std::optional<T>{values_[slot]} : std::nullopt;
+    }
+
+    /**
+     * @brief Sum of the valid slots; int64_t sums wrap around on overflow.
+     * @return the sum, 0 if there are none
+     */
+    [[nodiscard]] T sum(JsonColumnKernel kernel = JsonColumnKernel::automatic) const;
+
+    /**
+     * @brief Smallest valid slot.
+     * @return the minimum, or std::nullopt if there are no valid slots
+     */
+    [[nodiscard]] std::optional<T> min(JsonColumnKernel kernel = JsonColumnKernel::automatic) const;
+
+    /**
+     * @brief Largest valid slot.
+     * @return the maximum, or std::nullopt if there are no valid slots
+     */
+    [[nodiscard]] std::optional<T> max(JsonColumnKernel kernel = JsonColumnKernel::automatic) const;
+
+    /**
+     * @brief Arithmetic mean of the valid slots, as sum() / validCount().
+     * @return the mean, or std::nullopt if there are no valid slots
+     */
+    [[nodiscard]] std::optional<double> mean(JsonColumnKernel kernel = JsonColumnKernel::automatic) const;
+};
+
+extern template class JsonColumn<double>;
+extern template class JsonColumn<int64_t>;
+
+} // namespace util
+
+#endif // NS_UTIL_JSON_COLUMN_H_INCLUDED
@@ -0,0 +1,48 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   include/json_compression.h
+ * Description: settings for reading and writing compressed json files
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_JSON_COMPRESSION_H_INCLUDED
+#define NS_UTIL_JSON_COMPRESSION_H_INCLUDED
+
+#include <cstddef>
+
+namespace util
+{
+/**
+ * Settings of JsonObject::loadCompressed() and JsonObject::writeCompressed(), available when built with
+ * JSONOBJECT_ENABLE_ZLIB.
+ * <br>(De)compression runs on its own thread and exchanges text with the parsing or serialising thread through a ring
+ * of ringSlots buffers of chunkSize bytes, so memory for the text stays bounded and both sides work concurrently.
+ */
+struct JsonCompressionOptions
+{
+    int    level     = -1;          ///< zlib compression level 0 to 9 for writing; -1 for the zlib default
+    size_t chunkSize = 256UL << 10U; ///< bytes of uncompressed text per buffer
+    size_t ringSlots = 4;            ///< buffers between the two threads
+};
+
+} // namespace util
+
+#endif // NS_UTIL_JSON_COMPRESSION_H_INCLUDED
@@ -0,0 +1,94 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   include/json_error.h
+ * Description: error codes for exception-free json access
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_JSON_ERROR_H_INCLUDED
+#define NS_UTIL_JSON_ERROR_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+namespace util
+{
+/**
+ * Reasons for a failed path parse, lookup, update or conversion.
+ */
+enum class json_errc : uint8_t
+{
+    empty_path,          ///< the path string is empty
+    invalid_key,         ///< a segment is neither a valid string key nor a valid index key
+    missing_key,         ///< a string key does not exist in its object
+    index_out_of_bounds, ///< an index key addresses a non-existing element
+    expected_object,     ///< a string key was applied to a non-object
+    expected_array,      ///< an index key was applied to a non-array
+    type_mismatch,       ///< the value cannot be converted to the requested type
+    out_of_range         ///< the numeric value does not fit into the requested type
+};
+
+/**
+ * Short, static description of an error code.
+ */
+constexpr std::string_view to_string(json_errc code)
+{
+    switch (code)
+    {
+        case json_errc::empty_path:
+            return "empty path";
+        case json_errc::invalid_key:
+            return "invalid key";
+        case json_errc::missing_key:
+            return "missing key";
+        case json_errc::index_out_of_bounds:
+            return "index out of bounds";
+        case json_errc::expected_object:
+            return "expected object";
+        case json_errc::expected_array:
+            return "expected array";
+        case json_errc::type_mismatch:
+            return "type mismatch";
+        case json_errc::out_of_range:
+            return "out of range";
+    }
+    return "unknown error";
+}
+
+/**
+ * Error of an exception-free operation: what went wrong and at which segment of the path. Trivially copyable, so
+ * reporting it never allocates.
+ */
+struct JsonPathError
+{
+    static constexpr size_t noSegment = std::numeric_limits<size_t>::max();
+
+    json_errc code;
+    size_t    segment = noSegment; ///< index of the failing path segment, noSegment if not related to a segment
+
+    friend bool operator==(JsonPathError const &lhs, JsonPathError const &rhs) = default;
+};
+
+} // namespace util
+
+#endif // NS_UTIL_JSON_ERROR_H_INCLUDED
@@ -0,0 +1,205 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   include/json_event_parser.h
+ * Description: event-driven json parser with incremental path tracking
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_JSON_EVENT_PARSER_H_INCLUDED
+#define NS_UTIL_JSON_EVENT_PARSER_H_INCLUDED
+
+#include "json_key_path.h"
+#include "json_traversal.h"
+#include "json_types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace util
+{
+class JsonEventParser;
+
+/**
+ * What a handler wants to happen after an event.
+ */
+enum class JsonParseAction : uint8_t
+{
+    proceed,
+    skip,    ///< after a begin or key event: no events for the container or the member value
+    capture, ///< after a begin or key event: build the container or the member value and hand it to onSubtree()
+    stop     ///< end parsing; the parser reports false from then on
+};
+
+/**
+ * Receiver of the events of a JsonEventParser; override the events of interest. The parser passed to each event
+ * gives the path of the current node.
+ * <br>skip and capture returned from events other than begin and key events are treated as proceed.
+ */
+class JsonEventHandler
+{
+  public:
+    virtual ~JsonEventHandler() = default;
+
+    /**
+     * @brief An object starts; the path is the path of the object.
+     */
+    virtual JsonParseAction onObjectBegin(JsonEventParser const & /*parser*/)
+    {
+        return JsonParseAction::proceed;
+    }
+
+    /**
+     * @brief An object ends; the path is the path of the object.
+     */
+    virtual JsonParseAction onObjectEnd(JsonEventParser const & /*parser*/)
+    {
+        return JsonParseAction::proceed;
+    }
+
+    /**
+     * @brief An array starts; the path is the path of the array.
+     */
+    virtual JsonParseAction onArrayBegin(JsonEventParser const & /*parser*/)
+    {
+        return JsonParseAction::proceed;
+    }
+
+    /**
+     * @brief An array ends; the path is the path of the array.
+     */
+    virtual JsonParseAction onArrayEnd(JsonEventParser const & /*parser*/)
+    {
+        return JsonParseAction::proceed;
+    }
+
+    /**
+     * @brief A member of an object starts; the path already ends in key.
+     */
+    virtual JsonParseAction onKey(JsonEventParser const & /*parser*/, std::string_view /*key*/)
+    {
+        return JsonParseAction::proceed;
+    }
+
+    /**
+     * @brief A string, number, boolean or null; the path is the path of the value.
+     */
+    virtual JsonParseAction onValue(JsonEventParser const & /*parser*/, value_type const & /*value*/)
+    {
+        return JsonParseAction::proceed;
+    }
+
+    /**
+     * @brief A value that was asked to be captured is complete; the path is the path of the value.
+     */
+    virtual JsonParseAction onSubtree(JsonEventParser const & /*parser*/, value_type && /*subtree*/)
+    {
+        return JsonParseAction::proceed;
+    }
+};
+
+/**
+ * Event-driven (SAX) parser on top of boost::json::basic_parser. Input can be written in chunks of any size; the
+ * parser keeps only the current path and the state of the open containers, so its memory is proportional to the
+ * depth of the document, not to its size, unless subtrees are captured.
+ */
+class JsonEventParser
+{
+  public:
+    /**
+     * @brief Create a parser.
+     * @param handler receiver of the events; must outlive the parser
+     * @param options parse options, e.g. max_depth
+     * @param storage memory resource for captured subtrees
+     */
+    explicit JsonEventParser(
+        JsonEventHandler                &handler,
+        boost::json::parse_options const &options = {},
+        storage_type                      storage = {}
+    );
+
+    JsonEventParser(JsonEventParser const &)            = delete;
+    JsonEventParser &operator=(JsonEventParser const &) = delete;
+    ~JsonEventParser();
+
+    /**
+     * @brief Parse the next chunk of input.
+     * @param chunk the chunk
+     * @return false if the handler stopped parsing
+     * @throws std::invalid_argument when the input is not valid json or data follows the document
+     */
+    bool write(std::string_view chunk);
+
+    /**
+     * @brief Signal the end of input.
+     * @return false if the handler stopped parsing
+     * @throws std::invalid_argument when the input is not valid json or incomplete
+     */
+    bool finish();
+
+    /**
+     * @brief Path from the root to the current node; valid during an event.
+     */
+    [[nodiscard]] std::span<JsonPathSegment const> path() const;
+
+    /**
+     * @brief Number of containers around the current node; 0 for the root.
+     */
+    [[nodiscard]] size_t depth() const;
+
+    /**
+     * @brief Path to the current node as JsonKeyPath; allocates.
+     * @throws std::invalid_argument when a key cannot be expressed as a string-key of a JsonKeyPath
+     */
+    [[nodiscard]] JsonKeyPath keyPath() const;
+
+    /**
+     * @brief Parse a complete text.
+     * @return false if the handler stopped parsing
+     * @throws std::invalid_argument when the input is not valid json or data follows the document
+     */
+    static bool parse(std::string_view text, JsonEventHandler &handler, boost::json::parse_options const &options = {});
+
+    /**
+     * @brief Parse a file chunk by chunk.
+     * @return false if the handler stopped parsing
+     * @throws std::invalid_argument when the file cannot be read or is not valid json
+     */
+    static bool parseFile(
+        std::string const                &filename,
+        JsonEventHandler                 &handler,
+        boost::json::parse_options const &options   = {},
+        size_t                            chunkSize = 64UL << 10U
+    );
+
+  private:
+    class Adapter;
+    struct Impl;
+
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace util
+
+#endif // NS_UTIL_JSON_EVENT_PARSER_H_INCLUDED
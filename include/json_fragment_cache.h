@@ -0,0 +1,124 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   include/json_fragment_cache.h
+ * Description: cache of serialized json subtrees
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_JSON_FRAGMENT_CACHE_H_INCLUDED
+#define NS_UTIL_JSON_FRAGMENT_CACHE_H_INCLUDED
+
+#include "json_key_path.h"
+#include "json_types.h"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace util
+{
+/**
+ * Cache of the compact serialisation of every array and object of a document, organised as a tree that mirrors the
+ * document. Every cached container holds only its own text, i.e. punctuation, keys and scalars, and the positions at
+ * which the text of its container children is spliced in, so the cache holds about as many bytes as the output.
+ * After a change only the changed node and its ancestors re-render their own text, and the output is assembled in one
+ * pass over the tree, so the cost of serialising is the size of the re-rendered nodes plus one copy of the output.
+ * <br>The cache does not observe the document: every modification must be reported through invalidate() or
+ * invalidateAll(). Copies start empty. All members are thread-safe.
+ */
+class JsonFragmentCache
+{
+  public:
+    JsonFragmentCache() = default;
+    JsonFragmentCache(JsonFragmentCache const &other);
+    JsonFragmentCache &operator=(JsonFragmentCache const &other);
+
+    /**
+     * @brief Serialise a document compactly, reusing the cached fragments of unchanged subtrees.
+     * @param root the document; must be the document whose modifications were reported to this cache
+     * @return the same text as to_json_string(root)
+     */
+    [[nodiscard]] std::string serialize(value_type const &root);
+
+    /**
+     * @brief Report a modification of the node at path, as done by JsonObject::set().
+     * Drops the cached text of the node and of all its ancestors; prepending to an array drops all its elements.
+     * @param path key-path of the modified node
+     */
+    void invalidate(JsonKeyPath const &path);
+
+    /**
+     * @brief Report an arbitrary modification of the document.
+     */
+    void invalidateAll();
+
+    /**
+     * @brief Bytes of text the cache holds for the document of the last serialize(); about the size of its output.
+     */
+    [[nodiscard]] size_t cachedBytes();
+
+  private:
+    struct StringHash
+    {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view str) const
+        {
+            return std::hash<std::string_view>{}(str);
+        }
+    };
+
+    struct Node;
+    using NodePtr = std::unique_ptr<Node>;
+
+    struct Splice
+    {
+        size_t offset; ///< position in the text of the parent
+        Node  *child;
+    };
+
+    struct Node
+    {
+        std::string                                                           text; ///< without the container children
+        std::vector<Splice>                                                   splices;
+        size_t                                                                size  = 0; ///< length of the output
+        bool                                                                  valid = false;
+        boost::json::kind                                                     kind  = boost::json::kind::null;
+        std::unordered_map<std::string, NodePtr, StringHash, std::equal_to<>> members;
+        std::vector<NodePtr>                                                  elements;
+    };
+
+    std::mutex mutex_;
+    Node       root_;
+
+    static void   render(Node &node, value_type const &value);
+    static void   appendChild(Node &node, NodePtr &child, value_type const &value);
+    static void   emit(std::string &out, Node const &node);
+    static size_t bytes(Node const &node);
+};
+
+} // namespace util
+
+#endif // NS_UTIL_JSON_FRAGMENT_CACHE_H_INCLUDED
@@ -0,0 +1,217 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   include/json_frozen_object.h
+ * Description: immutable, contiguous copy of a json object for fast lookups
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_JSON_FROZEN_OBJECT_H_INCLUDED
+#define NS_UTIL_JSON_FROZEN_OBJECT_H_INCLUDED
+
+#include "json_key_intern.h"
+#include "json_key_path.h"
+#include "json_object.h"
+#include "json_types.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace util
+{
+/**
+ * An immutable copy of a json value, laid out for lookups.
+ * All nodes live in one contiguous vector, in traversal order, and the children of each container are adjacent.
+ * Strings live in a single arena. Objects with up to smallObjectSize members are sorted inline arrays searched by
+ * binary search; larger objects carry a perfect hash table over their keys, so each lookup probes exactly one slot.
+ * A large object for which no table is found, e.g. because two of its keys have the same hash, is sorted as well.
+ * When built with a key intern table, keys are handles into the table instead of text in the arena, and lookups compare
+ * handles only: keys of a path interned in the same table are used as they are, other keys are first looked up in the
+ * table once, and a key the table does not know is missing without searching the object.
+ * <br>Copies share the same immutable data, so copying is cheap and concurrent reads are safe.
+ */
+class FrozenJsonObject
+{
+  public:
+    /**
+     * Objects with more members than this use a perfect hash table.
+     */
+    static constexpr size_t smallObjectSize = 8;
+
+    /**
+     * @brief Freeze a json value.
+     * @param json the value to copy
+     * @param keyTable optional intern table for the object keys
+     */
+    explicit FrozenJsonObject(value_type const& json, std::shared_ptr<JsonKeyInternTable> keyTable = nullptr);
+
+    /**
+     * @brief Get a value from this object given a path.
+     * @param path key-path as string
+     * @param defaultValue optional default value to return, if given path is compatible with object
+     * @return the value if possible
+     * @throws std::invalid_argument when the path is incorrect, the value cannot be found or the path is incompatible
+     *                               with the object
+     * @see JsonObject::get(std::string_view, std::optional<value_type> const&)
+     */
+    [[nodiscard]] value_type
+        get(std::string_view path, std::optional<value_type> const& defaultValue = std::optional<value_type>{}) const;
+
+    /**
+     * @brief Get a value from this object given a path.
+     * @param path key-path as JsonKeyPath
+     * @param defaultValue optional default value to return, if given path is compatible with object
+     * @return the value if possible
+     * @see JsonObject::get(JsonKeyPath const&, std::optional<value_type> const&)
+     */
+    [[nodiscard]] value_type
+        get(JsonKeyPath const& path, std::optional<value_type> const& defaultValue = std::optional<value_type>{}) const;
+
+    /**
+     * @brief Get a value from this object given a path, converted to T. A std::string_view refers into this object.
+     * @param path key-path as string
+     * @return the converted value
+     * @see JsonObject::get<T>(std::string_view)
+     */
+    template<typename T>
+    [[nodiscard]] T get(std::string_view path) const;
+
+    /**
+     * @brief Get a value from this object given a path, converted to T.
+     * @param path key-path as JsonKeyPath
+     * @return the converted value
+     * @see JsonObject::get<T>(std::string_view)
+     */
+    template<typename T>
+    [[nodiscard]] T get(JsonKeyPath const& path) const;
+
+    /**
+     * @brief Get a value from this object given a path, converted to T, or the default if it does not exist.
+     * @param path key-path as string
+     * @param defaultValue value to return, if the given path is compatible with the object but does not exist
+     * @return the converted value or the default
+     */
+    template<typename T>
+    [[nodiscard]] T get(std::string_view path, std::type_identity_t<T> const& defaultValue) const;
+
+    /**
+     * @brief Get a value from this object given a path, converted to T, or the default if it does not exist.
+     * @param path key-path as JsonKeyPath
+     * @param defaultValue value to return, if the given path is compatible with the object but does not exist
+     * @return the converted value or the default
+     */
+    template<typename T>
+    [[nodiscard]] T get(JsonKeyPath const& path, std::type_identity_t<T> const& defaultValue) const;
+
+    /**
+     * @brief Copy the frozen data back into a mutable json value.
+     * @return the json value; members of small objects are in key order, or in handle order with an intern table
+     */
+    [[nodiscard]] value_type toValue() const;
+
+    /**
+     * @brief Number of nodes (values of any kind) in the layout.
+     */
+    [[nodiscard]] size_t nodeCount() const;
+
+    /**
+     * @brief Bytes held by the layout, not counting keys owned by a shared intern table.
+     */
+    [[nodiscard]] size_t memoryUsage() const;
+
+  private:
+    static constexpr uint32_t npos = static_cast<uint32_t>(-1);
+
+    struct Data;
+    class Builder;
+    std::shared_ptr<Data const> data_;
+
+    [[nodiscard]] JsonKeyPath      makePath(std::string_view path) const;
+    [[nodiscard]] uint32_t         locate(JsonKeyPath const& path, bool allowMissing) const;
+    [[nodiscard]] int64_t          select(uint32_t array, JsonIndexKey const& selector) const;
+    [[nodiscard]] bool             isNull(uint32_t node) const;
+    [[nodiscard]] std::string_view stringAt(uint32_t node) const;
+    [[nodiscard]] value_type       materialize(uint32_t node) const;
+
+    template<typename T>
+    [[nodiscard]] T convert(uint32_t node) const;
+};
+
+template<typename T>
+T FrozenJsonObject::convert(uint32_t node) const
+{
+    if constexpr (is_optional_v<T>)
+    {
+        if (isNull(node))
+        {
+            return std::nullopt;
+        }
+        return convert<typename T::value_type>(node);
+    }
+    else if constexpr (std::same_as<T, std::string_view> || std::same_as<T, std::string>)
+    {
+        return T{stringAt(node)};
+    }
+    else
+    {
+        return value_as<T>(materialize(node));
+    }
+}
+
+template<typename T>
+T FrozenJsonObject::get(std::string_view path) const
+{
+    return get<T>(makePath(path));
+}
+
+template<typename T>
+T FrozenJsonObject::get(JsonKeyPath const& path) const
+{
+    if constexpr (is_optional_v<T>)
+    {
+        uint32_t const node = locate(path, true);
+        return node == npos ? T{} : convert<T>(node);
+    }
+    else
+    {
+        return convert<T>(locate(path, false));
+    }
+}
+
+template<typename T>
+T FrozenJsonObject::get(std::string_view path, std::type_identity_t<T> const& defaultValue) const
+{
+    return get<T>(makePath(path), defaultValue);
+}
+
+template<typename T>
+T FrozenJsonObject::get(JsonKeyPath const& path, std::type_identity_t<T> const& defaultValue) const
+{
+    uint32_t const node = locate(path, true);
+    return node == npos ? defaultValue : convert<T>(node);
+}
+
+} // namespace util
+
+#endif // NS_UTIL_JSON_FROZEN_OBJECT_H_INCLUDED
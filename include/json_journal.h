@@ -0,0 +1,297 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   include/json_journal.h
+ * Description: append-only journal of json object updates
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_JSON_JOURNAL_H_INCLUDED
+#define NS_UTIL_JSON_JOURNAL_H_INCLUDED
+
+#include "json_key_path.h"
+#include "json_types.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace util
+{
+/**
+ * Settings of a JsonJournal.
+ */
+struct JsonJournalOptions
+{
+    /**
+     * Longest time a record stays in memory before it is written and synced together with all records appended in the
+     * meantime.
+     */
+    std::chrono::milliseconds commitInterval{5};
+    /**
+     * Buffered bytes that trigger a commit before the interval is over.
+     */
+    size_t maxBatchBytes = 1UL << 20U;
+    /**
+     * If true, then appending blocks until the record is synced to disk; concurrent appenders share one sync.
+     */
+    bool waitForSync = false;
+    /**
+     * Journal size after which the background thread compacts the journal into a new snapshot; 0 never.
+     */
+    size_t compactAfterBytes = 64UL << 20U;
+};
+
+/**
+ * Identity of a snapshot as recorded in the header of its journal: size and FNV-1a hash of the snapshot text with
+ * line breaks removed, as JsonObject::load() reads it. Can be computed chunk by chunk.
+ */
+struct JsonSnapshotDigest
+{
+    uint64_t size = 0;
+    uint64_t hash = 14'695'981'039'346'656'037ULL;
+
+    /**
+     * @brief Add the next chunk of the snapshot text.
+     */
+    void update(std::string_view text);
+
+    /**
+     * @brief Digest of a complete snapshot text.
+     */
+    [[nodiscard]] static JsonSnapshotDigest of(std::string_view text);
+
+    bool operator==(JsonSnapshotDigest const &) const = default;
+};
+
+/**
+ * One replayed journal record.
+ */
+struct JsonJournalRecord
+{
+    enum class Operation : uint8_t
+    {
+        set,
+        clear,
+        replace,
+        insert
+    };
+
+    Operation   operation = Operation::set;
+    std::string path; ///< key-path of a set or an insert, empty for the root
+    value_type  value; ///< value of a set, the whole document of a replace or the array of inserted values
+    size_t      index = 0; ///< position of the first inserted value
+    bool        force = false;
+};
+
+/**
+ * Write-ahead log of updates to a json document stored in a snapshot file.
+ * The journal lives next to the snapshot, in "<snapshot>.journal". It holds one json record per line; the first line
+ * identifies the snapshot it applies to by size and hash, so a journal left over from an interrupted compaction is
+ * recognised as stale and ignored.
+ * <br>Records are buffered and committed in groups by a background thread: one write and one fdatasync cover all
+ * records appended within the commit interval. The same thread compacts the journal once it is due, by loading the
+ * snapshot and the committed records with the loader, so appending never waits for a compaction.
+ * <br>Appending does not throw: once a commit or a compaction fails, further records are dropped and failure()
+ * reports the error until compact() writes a snapshot of the whole document.
+ */
+class JsonJournal
+{
+  public:
+    /**
+     * Function that loads a snapshot file and replays its journal, as JsonObject::load() does.
+     */
+    using Loader = std::function<value_type(std::string const &snapshotFile)>;
+
+    /**
+     * @brief Open the journal of a snapshot file for appending; nothing is written before compact().
+     * @param snapshotFile name of the snapshot file
+     * @param options commit and compaction settings
+     * @param loader used to compact in the background; without it the owner has to call compact() when due
+     * @throws std::invalid_argument when the journal cannot be opened for writing
+     */
+    explicit JsonJournal(std::string snapshotFile, JsonJournalOptions options = {}, Loader loader = {});
+
+    JsonJournal(JsonJournal const &)            = delete;
+    JsonJournal &operator=(JsonJournal const &) = delete;
+
+    /**
+     * @brief Commit all buffered records and close the journal.
+     */
+    ~JsonJournal();
+
+    /**
+     * @brief Append the record of a successful JsonObject::set(); dropped after a failure.
+     */
+    void appendSet(JsonKeyPath const &path, value_type const &value, bool force);
+
+    /**
+     * @brief Append the record of JsonObject::clear(); dropped after a failure.
+     */
+    void appendClear();
+
+    /**
+     * @brief Append the record of values inserted into an array, e.g. by JsonObject::insertRange(); dropped after a
+     * failure.
+     * @param path resolved key-path of the array
+     * @param index position of the first inserted value
+     * @param values the inserted values
+     * @param force whether missing containers on the path were created
+     */
+    void appendInsert(JsonKeyPath const &path, size_t index, std::span<value_type const> values, bool force);
+
+    /**
+     * @brief Append a record that replaces the whole document, e.g. after JsonObject::load(); dropped after a failure.
+     */
+    void appendReplace(value_type const &document);
+
+    /**
+     * @brief Write and sync all buffered records now.
+     * @throws std::runtime_error when writing or syncing fails
+     */
+    void flush();
+
+    /**
+     * @brief Atomically replace the snapshot by document and start an empty journal for it.
+     * @param document the current state, including every appended record
+     * @throws std::runtime_error when writing fails; the previous snapshot and journal then stay valid
+     */
+    void compact(value_type const &document);
+
+    /**
+     * @brief Error of the commit or compaction that failed, after which records are dropped.
+     * @return the error message, or an empty string while every record was written
+     */
+    [[nodiscard]] std::string failure() const;
+
+    /**
+     * @brief Whether the journal has grown beyond JsonJournalOptions::compactAfterBytes.
+     */
+    [[nodiscard]] bool compactionDue() const;
+
+    /**
+     * @brief Bytes appended since the last compaction.
+     */
+    [[nodiscard]] size_t journalBytes() const;
+
+    /**
+     * @brief Name of the journal of a snapshot file.
+     */
+    [[nodiscard]] static std::string journalFileName(std::string const &snapshotFile);
+
+    /**
+     * @brief Replay the journal of a snapshot.
+     * @param snapshotFile name of the snapshot file
+     * @param snapshot digest of the snapshot as loaded, used to check that the journal belongs to it
+     * @param apply called for each record, in order
+     * @return number of records replayed; 0 if there is no journal or it belongs to another snapshot
+     * @throws std::invalid_argument when a record other than an incomplete last one cannot be parsed
+     */
+    static size_t replay(
+        std::string const                                    &snapshotFile,
+        JsonSnapshotDigest const                             &snapshot,
+        std::function<void(JsonJournalRecord const &)> const &apply
+    );
+
+  private:
+    std::string        snapshotFile_;
+    std::string        journalFile_;
+    JsonJournalOptions options_;
+    Loader             loader_;
+    int                fd_ = -1;
+
+    mutable std::mutex      mutex_;     ///< guards the buffer and the counters
+    std::mutex              writeMutex_; ///< serialises commits, so batches reach the file in order
+    std::condition_variable wakeFlusher_;
+    std::condition_variable synced_;
+    std::string             buffer_;
+    uint64_t                appendedSeq_  = 0;
+    uint64_t                syncedSeq_    = 0;
+    size_t                  journalBytes_ = 0;
+    std::string             failure_;
+    bool                    stopping_ = false;
+    std::jthread            flusher_;
+
+    void append(std::string record);
+    void commit();
+    void compactFromFiles();
+    void replaceSnapshot(std::string const &snapshotText, bool coversBuffer);
+    void run(std::stop_token const &stop);
+};
+
+/**
+ * Owner of the journal of a document. It is not copied with the document: a copy is not journaled, as both would
+ * append to the same file, and a journaled document that is assigned to stops journaling.
+ */
+class JsonJournalHandle
+{
+    std::unique_ptr<JsonJournal> journal_;
+
+  public:
+    JsonJournalHandle() = default;
+
+    JsonJournalHandle(JsonJournalHandle const & /*other*/)
+    {
+    }
+
+    JsonJournalHandle &operator=(JsonJournalHandle const &other)
+    {
+        if (this != &other)
+        {
+            journal_.reset();
+        }
+        return *this;
+    }
+
+    JsonJournalHandle(JsonJournalHandle &&) noexcept            = default;
+    JsonJournalHandle &operator=(JsonJournalHandle &&) noexcept = default;
+    ~JsonJournalHandle()                                        = default;
+
+    void reset(std::unique_ptr<JsonJournal> journal = nullptr)
+    {
+        journal_ = std::move(journal);
+    }
+
+    [[nodiscard]] JsonJournal *get() const
+    {
+        return journal_.get();
+    }
+
+    JsonJournal *operator->() const
+    {
+        return journal_.get();
+    }
+
+    explicit operator bool() const
+    {
+        return journal_ != nullptr;
+    }
+};
+
+} // namespace util
+
+#endif // NS_UTIL_JSON_JOURNAL_H_INCLUDED
@@ -0,0 +1,144 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   include/json_key_intern.h
+ * Description: table of interned json object keys, shared across documents
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_JSON_KEY_INTERN_H_INCLUDED
+#define NS_UTIL_JSON_KEY_INTERN_H_INCLUDED
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+namespace util
+{
+/**
+ * Handle of a key stored in a JsonKeyInternTable. Handles from the same table compare equal if and only if the keys
+ * are equal, so comparing them is a pointer comparison.
+ * <br>A handle does not own the table and is valid only while the table lives; holders such as JsonStringKey and
+ * FrozenJsonObject keep a std::shared_ptr to it.
+ */
+class InternedKey
+{
+    std::string const *key_ = nullptr;
+
+    friend class JsonKeyInternTable;
+
+    explicit InternedKey(std::string const *key)
+        : key_(key)
+    {
+    }
+
+  public:
+    InternedKey() = default;
+
+    [[nodiscard]] bool valid() const
+    {
+        return key_ != nullptr;
+    }
+
+    [[nodiscard]] std::string const &str() const
+    {
+        return *key_;
+    }
+
+    [[nodiscard]] std::string_view view() const
+    {
+        return key_ == nullptr ? std::string_view{} : std::string_view{*key_};
+    }
+
+    friend bool operator==(InternedKey lhs, InternedKey rhs)
+    {
+        return lhs.key_ == rhs.key_;
+    }
+
+    [[nodiscard]] size_t hash() const
+    {
+        return std::hash<void const *>{}(key_);
+    }
+};
+
+/**
+ * Thread-safe, append-only table of keys. Each distinct key is stored exactly once, at a stable address, and is
+ * referenced by InternedKey handles for the lifetime of the table. Keys are never removed, so a table is meant for a
+ * bounded set of names, e.g. shared by the frozen copies of many documents of the same shape.
+ */
+class JsonKeyInternTable
+{
+    struct StringHash
+    {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view str) const
+        {
+            return std::hash<std::string_view>{}(str);
+        }
+    };
+
+    mutable std::shared_mutex                                      mutex_;
+    std::unordered_set<std::string, StringHash, std::equal_to<>> keys_;
+    size_t                                                         bytes_ = 0;
+
+  public:
+    JsonKeyInternTable()                                      = default;
+    JsonKeyInternTable(JsonKeyInternTable const &)            = delete;
+    JsonKeyInternTable &operator=(JsonKeyInternTable const &) = delete;
+
+    /**
+     * @brief Get the handle for a key, adding the key to the table if it is not yet known.
+     * @param key the key
+     * @return handle of the stored key
+     */
+    InternedKey intern(std::string_view key);
+
+    /**
+     * @brief Get the handle for a key, if it is known.
+     * @param key the key
+     * @return handle of the stored key, or std::nullopt if the key has never been interned
+     */
+    [[nodiscard]] std::optional<InternedKey> find(std::string_view key) const;
+
+    /**
+     * @brief Number of distinct keys in the table.
+     */
+    [[nodiscard]] size_t size() const;
+
+    /**
+     * @brief Number of characters stored for all keys.
+     */
+    [[nodiscard]] size_t bytes() const;
+
+    /**
+     * @brief Process-wide table, for callers that do not need separate key spaces.
+     */
+    static std::shared_ptr<JsonKeyInternTable> const &shared();
+};
+
+} // namespace util
+
+#endif // NS_UTIL_JSON_KEY_INTERN_H_INCLUDED
@@ -26,12 +26,18 @@
 #ifndef NS_UTIL_JSON_KEY_PATH_H_INCLUDED
 #define NS_UTIL_JSON_KEY_PATH_H_INCLUDED
 
+#include "json_error.h"
+#include "json_key_intern.h"
+
 #include <boost/json.hpp>
+#include <expected>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
 
@@ -53,31 +59,133 @@ class JsonKey
  */
 class JsonStringKey : public JsonKey
 {
-    std::string key_;
+    std::string                               key_;
+    InternedKey                               interned_;
+    std::shared_ptr<JsonKeyInternTable const> table_; ///< keeps the table of interned_ alive
+
+    static char const *invalidReason(std::string_view key);
+    static void        validate(std::string_view key);
 
   public:
-    explicit JsonStringKey(std::string const &key);
+    /**
+     * @brief Construct a key owning a copy of its text; keys of up to the small-string size do not allocate.
+     * @param key the key
+     * @throws std::invalid_argument when the key is not a valid string key
+     */
+    explicit JsonStringKey(std::string_view key);
+
+    /**
+     * @brief Check whether a string is a valid string key, without throwing.
+     * @param key the candidate key
+     * @return true if JsonStringKey(key) would succeed
+     */
+    [[nodiscard]] static bool isValid(std::string_view key);
+
+    /**
+     * @brief Construct a key that refers to its text in an intern table instead of owning a copy. The key shares
+     * ownership of the table, so that its handle stays valid.
+     * @param key the key
+     * @param table table to intern the key in
+     * @throws std::invalid_argument when the key is not a valid string key or table is nullptr
+     */
+    JsonStringKey(std::string_view key, std::shared_ptr<JsonKeyInternTable> const &table);
+
     [[nodiscard]] std::string        toString() const override;
     [[nodiscard]] bool               isIndex() const override;
     [[nodiscard]] std::string const &getKey() const;
+
+    /**
+     * @brief Handle of the key in its intern table.
+     * @return the handle, or an invalid handle if the key was not interned
+     */
+    [[nodiscard]] InternedKey getInterned() const;
+
+    /**
+     * @brief The table the key is interned in.
+     * @return the table, or nullptr if the key was not interned
+     */
+    [[nodiscard]] JsonKeyInternTable const *internTable() const;
 };
 
 /**
  * Json index key implementation for list indices.
+ * Besides positions and the symbols [^] and [$], an index key can be a selector [field=value], which addresses the
+ * first element of the array that is an object whose member field has the text value.
  */
 class JsonIndexKey : public JsonKey
 {
-    int64_t index_{};
-    bool    isStartSymbol_ = false;
-    bool    isEndSymbol_   = false;
+    struct Selector
+    {
+        std::string field;
+        std::string value;
+    };
+
+    int64_t                         index_{};
+    bool                            isStartSymbol_ = false;
+    bool                            isEndSymbol_   = false;
+    std::shared_ptr<Selector const> selector_;
+
+    static char const *invalidReason(std::string_view idx);
 
   public:
-    explicit JsonIndexKey(std::string const &idx);
+    explicit JsonIndexKey(std::string_view idx);
+    explicit JsonIndexKey(size_t idx);
+
+    /**
+     * @brief Check whether a string is a valid index key, without throwing.
+     * @param idx the candidate key
+     * @return true if JsonIndexKey(idx) would succeed
+     */
+    [[nodiscard]] static bool isValid(std::string_view idx);
     [[nodiscard]] std::string toString() const override;
     [[nodiscard]] bool        isIndex() const override;
     [[nodiscard]] bool        isStartSymbol() const;
     [[nodiscard]] bool        isEndSymbol() const;
-    [[nodiscard]] int64_t     getIndex(boost::json::array const &array) const;
+
+    /**
+     * @brief Whether the key is a selector [field=value].
+     */
+    [[nodiscard]] bool isSelector() const;
+
+    /**
+     * @brief Member name of a selector; empty for other keys.
+     */
+    [[nodiscard]] std::string_view selectorField() const;
+
+    /**
+     * @brief Text a selector compares the member with; empty for other keys.
+     */
+    [[nodiscard]] std::string_view selectorValue() const;
+
+    /**
+     * @brief Resolve the index in the given array; selectors scan the elements.
+     * @param array the array
+     * @return the index, -1 for [$] of an empty array or a selector that matches no element
+     */
+    [[nodiscard]] int64_t getIndex(boost::json::array const &array) const;
+
+    /**
+     * @brief Resolve the index for a container of the given size.
+     * @param size number of elements in the container
+     * @return the index, -1 for [$] of an empty container and for selectors, which need the elements
+     */
+    [[nodiscard]] int64_t getIndex(size_t size) const;
+
+    /**
+     * @brief Text that selectors compare members with: strings as they are, integers and booleans as json text.
+     * @param member the member of an array element
+     * @return the text, or std::nullopt for other kinds, which no selector matches
+     */
+    [[nodiscard]] static std::optional<std::string> selectorText(boost::json::value const &member);
+
+    /**
+     * @brief Text of the member field of an array element, as selectors compare it.
+     * @param element the array element
+     * @param field the member name
+     * @return the text, or std::nullopt if element is not an object, has no such member or the kind has no text
+     */
+    [[nodiscard]] static std::optional<std::string> selectorText(boost::json::value const &element,
+                                                                 std::string_view          field);
 };
 
 /**
@@ -87,8 +195,45 @@ class JsonKeyPath
 {
     std::vector<std::shared_ptr<JsonKey>> keys_;
 
+    void parse(std::string_view path, std::shared_ptr<JsonKeyInternTable> const &table);
+
   public:
-    explicit JsonKeyPath(std::string const &path);
+    /**
+     * @brief Construct the empty path, which addresses the root of a json object.
+     */
+    JsonKeyPath() = default;
+
+    /**
+     * @brief Construct a path by slicing the given text; no intermediate strings are created.
+     * @param path the path as string
+     * @throws std::invalid_argument when the path is invalid
+     */
+    explicit JsonKeyPath(std::string_view path);
+
+    /**
+     * @brief Construct a path whose string keys are interned in table; the keys keep the table alive.
+     * @param path the path as string
+     * @param table table to intern the string keys in, nullptr for none
+     * @throws std::invalid_argument when the path is invalid
+     */
+    JsonKeyPath(std::string_view path, std::shared_ptr<JsonKeyInternTable> const &table);
+
+    /**
+     * @brief Parse a path without throwing; a failure does not allocate.
+     * @param path the path as string
+     * @param table optional table to intern the string keys in
+     * @return the path, or json_errc::empty_path, or json_errc::invalid_key with the index of the offending segment
+     */
+    [[nodiscard]] static std::expected<JsonKeyPath, JsonPathError>
+        tryParse(std::string_view path, std::shared_ptr<JsonKeyInternTable> const &table = nullptr);
+
+    /**
+     * @brief Append a key to the end of the path.
+     * @param key the key to append
+     * @return reference to this path
+     */
+    JsonKeyPath &append(std::shared_ptr<JsonKey> key);
+
     [[nodiscard]] size_t                                       size() const;
     [[nodiscard]] std::vector<std::shared_ptr<JsonKey>> const &getKeys() const;
     [[nodiscard]] std::string                                  toString() const;
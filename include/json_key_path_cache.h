@@ -0,0 +1,152 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   include/json_key_path_cache.h
+ * Description: bounded, thread-safe cache of parsed key-paths
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_JSON_KEY_PATH_CACHE_H_INCLUDED
+#define NS_UTIL_JSON_KEY_PATH_CACHE_H_INCLUDED
+
+#include "json_error.h"
+#include "json_key_intern.h"
+#include "json_key_path.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace util
+{
+/**
+ * Counters of a JsonKeyPathCache.
+ */
+struct JsonKeyPathCacheStats
+{
+    uint64_t hits      = 0;
+    uint64_t misses    = 0; ///< lookups that parsed the path, including invalid paths
+    uint64_t evictions = 0;
+    size_t   size      = 0; ///< paths currently cached
+};
+
+/**
+ * Bounded cache from path strings to parsed, immutable JsonKeyPaths, for paths that are built at run time and used
+ * repeatedly. The cache is split into shards, each with its own lock and least-recently-used order, so that threads
+ * looking up different paths rarely wait for each other. Lookups take a std::string_view and do not allocate on a hit.
+ * <br>Paths are parsed with the intern table the cache was created with; invalid paths are not cached.
+ */
+class JsonKeyPathCache
+{
+  public:
+    using PathPtr = std::shared_ptr<JsonKeyPath const>;
+
+    /**
+     * @brief Create a cache.
+     * @param capacity maximum number of cached paths, spread evenly over the shards
+     * @param table intern table to parse string keys into, nullptr for none
+     * @param shards number of independently locked parts
+     */
+    explicit JsonKeyPathCache(
+        size_t                              capacity = 4096,
+        std::shared_ptr<JsonKeyInternTable> table    = nullptr,
+        size_t                              shards   = 16
+    );
+
+    JsonKeyPathCache(JsonKeyPathCache const &)            = delete;
+    JsonKeyPathCache &operator=(JsonKeyPathCache const &) = delete;
+    ~JsonKeyPathCache();
+
+    /**
+     * @brief Get the parsed path, parsing and caching it if it is not cached.
+     * @param path key-path as string
+     * @return the parsed path; stays valid when it is evicted
+     * @throws std::invalid_argument when the path is invalid
+     */
+    [[nodiscard]] PathPtr get(std::string_view path);
+
+    /**
+     * @brief Get the parsed path without throwing on an invalid path.
+     * @param path key-path as string
+     * @return the parsed path, or the error of JsonKeyPath::tryParse()
+     */
+    [[nodiscard]] std::expected<PathPtr, JsonPathError> tryGet(std::string_view path);
+
+    /**
+     * @brief Drop all cached paths; the counters are kept.
+     */
+    void clear();
+
+    /**
+     * @brief Counters summed over all shards.
+     */
+    [[nodiscard]] JsonKeyPathCacheStats stats() const;
+
+    /**
+     * @brief Maximum number of cached paths.
+     */
+    [[nodiscard]] size_t capacity() const;
+
+    /**
+     * @brief The intern table that paths are parsed with, nullptr for none.
+     */
+    [[nodiscard]] JsonKeyInternTable *table() const;
+
+    /**
+     * @brief Process-wide cache for paths without intern table.
+     */
+    static std::shared_ptr<JsonKeyPathCache> const &shared();
+
+  private:
+    struct Entry
+    {
+        std::string text;
+        PathPtr     path;
+    };
+
+    struct alignas(64) Shard
+    {
+        std::mutex                                                       mutex;
+        std::list<Entry>                                                 lru;   ///< most recently used first
+        std::unordered_map<std::string_view, std::list<Entry>::iterator> index; ///< views of Entry::text
+        uint64_t                                                         hits      = 0;
+        uint64_t                                                         misses    = 0;
+        uint64_t                                                         evictions = 0;
+    };
+
+    std::shared_ptr<JsonKeyInternTable> table_;
+    size_t                              shardCount_;
+    size_t                              shardCapacity_;
+    std::unique_ptr<Shard[]>            shards_;
+
+    Shard  &shardOf(std::string_view path) const;
+    PathPtr find(Shard &shard, std::string_view path) const;
+    PathPtr insert(Shard &shard, std::string_view path, PathPtr parsed) const;
+};
+
+} // namespace util
+
+#endif // NS_UTIL_JSON_KEY_PATH_CACHE_H_INCLUDED
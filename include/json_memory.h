@@ -0,0 +1,86 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   include/json_memory.h
+ * Description: memory accounting for json documents
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_JSON_MEMORY_H_INCLUDED
+#define NS_UTIL_JSON_MEMORY_H_INCLUDED
+
+#include <atomic>
+#include <boost/json/memory_resource.hpp>
+#include <boost/json/storage_ptr.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace util
+{
+/**
+ * Memory held by a json document.
+ */
+struct JsonMemoryUsage
+{
+    size_t liveBytes     = 0; ///< bytes currently allocated
+    size_t peakBytes     = 0; ///< highest value of liveBytes so far
+    size_t allocations   = 0; ///< number of allocations so far
+    size_t deallocations = 0; ///< number of deallocations so far
+};
+
+/**
+ * A memory resource that forwards to an upstream resource and counts what passes through it.
+ * Counters are relaxed atomics, so the resource can stay on in production and be shared between threads.
+ * <br>Create it with boost::json::make_shared_resource<TrackingMemoryResource>() and pass the storage to JsonObject.
+ */
+class TrackingMemoryResource : public boost::json::memory_resource
+{
+    boost::json::storage_ptr upstream_;
+    std::atomic<size_t>      liveBytes_{0};
+    std::atomic<size_t>      peakBytes_{0};
+    std::atomic<size_t>      allocations_{0};
+    std::atomic<size_t>      deallocations_{0};
+
+  public:
+    /**
+     * @brief Construct a tracking resource.
+     * @param upstream resource that performs the allocations; the default resource if not given
+     */
+    explicit TrackingMemoryResource(boost::json::storage_ptr upstream = {});
+
+    /**
+     * @brief Current counters.
+     */
+    [[nodiscard]] JsonMemoryUsage usage() const;
+
+    /**
+     * @brief Set the peak to the current number of live bytes.
+     */
+    void resetPeak();
+
+  protected:
+    void* do_allocate(size_t bytes, size_t align) override;
+    void  do_deallocate(void* ptr, size_t bytes, size_t align) override;
+    bool  do_is_equal(boost::json::memory_resource const& other) const noexcept override;
+};
+
+} // namespace util
+
+#endif // NS_UTIL_JSON_MEMORY_H_INCLUDED
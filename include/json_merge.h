@@ -0,0 +1,106 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   include/json_merge.h
+ * Description: deep merge of layered json documents
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_JSON_MERGE_H_INCLUDED
+#define NS_UTIL_JSON_MERGE_H_INCLUDED
+
+#include "json_thread_pool.h"
+#include "json_types.h"
+
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace util
+{
+/**
+ * Exception thrown by a merge with JsonConflictPolicy::error when layers disagree.
+ */
+class merge_conflict_error : public std::runtime_error
+{
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * How two arrays at the same path are merged.
+ */
+enum class JsonArrayMergePolicy : uint8_t
+{
+    replace, ///< the arrays conflict like scalars
+    concat,  ///< the elements of the later layer are appended
+    byIndex  ///< elements at the same index are merged, extra elements are appended
+};
+
+/**
+ * How two values at the same path are merged that cannot be merged member-wise.
+ */
+enum class JsonConflictPolicy : uint8_t
+{
+    lastWins,  ///< the later layer overrides
+    firstWins, ///< the earlier layer is kept
+    error      ///< differing values throw merge_conflict_error
+};
+
+/**
+ * Settings of a merge.
+ */
+struct JsonMergePolicy
+{
+    JsonArrayMergePolicy arrays    = JsonArrayMergePolicy::replace;
+    JsonConflictPolicy   conflicts = JsonConflictPolicy::lastWins;
+    /**
+     * Merge the top-level members of object layers on a pool, with the calling thread taking part, so a merge on a
+     * worker of the pool does not wait for it. Only done if the first layer uses the default storage, as other memory
+     * resources need not be thread-safe.
+     */
+    bool            parallel = true;
+    JsonThreadPool *pool     = nullptr; ///< pool for the parallel merge; JsonThreadPool::shared() if nullptr
+};
+
+/**
+ * @brief Deep merge layers, later layers on top of earlier ones: objects are merged member by member, arrays and
+ * other values as the policy says. The result uses the storage of the first layer.
+ * @param layers the layers, lowest first; they are copied from
+ * @param policy array and conflict policies
+ * @return the merged value; an empty object if there are no layers
+ * @throws merge_conflict_error on a conflict with JsonConflictPolicy::error
+ */
+value_type json_merge(std::span<value_type const *const> layers, JsonMergePolicy const &policy = {});
+
+/**
+ * @brief Deep merge layers, moving values out of them instead of copying.
+ * @see json_merge(std::span<value_type const *const>, JsonMergePolicy const &)
+ * @param layers the layers, lowest first; left in a valid but unspecified state
+ * @param policy array and conflict policies
+ * @return the merged value; an empty object if there are no layers
+ * @throws merge_conflict_error on a conflict with JsonConflictPolicy::error
+ */
+value_type json_merge(std::vector<value_type> &&layers, JsonMergePolicy const &policy = {});
+
+} // namespace util
+
+#endif // NS_UTIL_JSON_MERGE_H_INCLUDED
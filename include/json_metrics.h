@@ -0,0 +1,198 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   include/json_metrics.h
+ * Description: opt-in operation metrics for json objects
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_JSON_METRICS_H_INCLUDED
+#define NS_UTIL_JSON_METRICS_H_INCLUDED
+
+#include "json_types.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <string_view>
+
+/**
+ * Metrics are only recorded when the library and its users are compiled with JSONOBJECT_ENABLE_METRICS defined
+ * (CMake option JSONOBJECT_ENABLE_METRICS). Otherwise the macros below expand to nothing and the snapshot is all zeros.
+ */
+#if defined(JSONOBJECT_ENABLE_METRICS)
+#define JSONOBJECT_METRICS_SCOPE(operation) ::util::JsonMetricsScope const jsonObjectMetricsScope{operation}
+#define JSONOBJECT_METRICS_ADD(counter, amount) ::util::JsonMetrics::add(counter, amount)
+#else
+#define JSONOBJECT_METRICS_SCOPE(operation) static_cast<void>(0)
+#define JSONOBJECT_METRICS_ADD(counter, amount) static_cast<void>(0)
+#endif
+
+namespace util
+{
+/**
+ * Instrumented operations.
+ */
+enum class JsonOperation : uint8_t
+{
+    keyPathParse, ///< constructing a JsonKeyPath from a string
+    find,         ///< traversing the tree to the addressed node
+    get,          ///< JsonObject::get with a JsonKeyPath: traversal plus copy or conversion of the result
+    set,          ///< JsonObject::set with a JsonKeyPath
+    load,         ///< JsonObject::load, including parsing
+    write,        ///< JsonObject::write, including serialisation
+    toString      ///< JsonObject::toString
+};
+
+/**
+ * Plain event counters.
+ */
+enum class JsonCounter : uint8_t
+{
+    bytesParsed,       ///< characters of json text parsed
+    bytesSerialized,   ///< characters of json text produced
+    defaultFallbacks,  ///< calls of get that returned the default value
+    keyPathCacheHits,  ///< path strings found in a JsonKeyPathCache
+    keyPathCacheMisses ///< path strings parsed because they were not in a JsonKeyPathCache
+};
+
+inline constexpr size_t jsonOperationCount     = 7;
+inline constexpr size_t jsonCounterCount       = 5;
+inline constexpr size_t jsonLatencyBucketCount = 32;
+
+/**
+ * Name of an operation, as used in JsonMetricsSnapshot::toJson().
+ */
+std::string_view to_string(JsonOperation operation);
+
+/**
+ * Name of a counter, as used in JsonMetricsSnapshot::toJson().
+ */
+std::string_view to_string(JsonCounter counter);
+
+/**
+ * Aggregated statistics of one operation.
+ */
+struct JsonOperationStats
+{
+    uint64_t calls      = 0;
+    uint64_t exceptions = 0; ///< calls that were left by an exception
+    uint64_t totalNanos = 0;
+    /**
+     * Bucket 0 counts calls that took 0ns, bucket i (i > 0) those that took [2^(i-1), 2^i) nanoseconds; the last bucket
+     * also holds everything slower.
+     */
+    std::array<uint64_t, jsonLatencyBucketCount> latencyHistogram{};
+};
+
+/**
+ * Point-in-time sum of the metrics of all threads since the last reset.
+ */
+struct JsonMetricsSnapshot
+{
+    std::array<JsonOperationStats, jsonOperationCount> operations{};
+    std::array<uint64_t, jsonCounterCount>             counters{};
+
+    [[nodiscard]] JsonOperationStats const &operator[](JsonOperation operation) const;
+    [[nodiscard]] uint64_t                  operator[](JsonCounter counter) const;
+
+    /**
+     * @brief Render the snapshot for a metrics pipeline.
+     * @return an object with one member per operation (calls, exceptions, total_ns, latency_log2_ns) and per counter
+     */
+    [[nodiscard]] value_type toJson() const;
+};
+
+/**
+ * Process-wide metrics registry. Each thread updates its own block of counters with relaxed atomic stores, so
+ * recording never takes a lock; snapshot() sums the blocks of all live and finished threads.
+ */
+class JsonMetrics
+{
+  public:
+#if defined(JSONOBJECT_ENABLE_METRICS)
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+
+    /**
+     * @brief Record one call of an operation.
+     * @param operation the operation
+     * @param nanos duration of the call
+     * @param threw whether the call was left by an exception
+     */
+    static void record(JsonOperation operation, uint64_t nanos, bool threw);
+
+    /**
+     * @brief Increase a counter.
+     * @param counter the counter
+     * @param amount the increment
+     */
+    static void add(JsonCounter counter, uint64_t amount);
+
+    /**
+     * @brief Sum up the metrics of all threads.
+     * @return the metrics since the last reset
+     */
+    [[nodiscard]] static JsonMetricsSnapshot snapshot();
+
+    /**
+     * @brief Start counting from zero; subsequent snapshots only cover events after the reset.
+     */
+    static void reset();
+};
+
+/**
+ * Records the duration of the enclosing scope, and whether it was left by an exception.
+ */
+class JsonMetricsScope
+{
+    JsonOperation                         operation_;
+    int                                   exceptions_;
+    std::chrono::steady_clock::time_point start_;
+
+  public:
+    explicit JsonMetricsScope(JsonOperation operation)
+        : operation_(operation)
+        , exceptions_(std::uncaught_exceptions())
+        , start_(std::chrono::steady_clock::now())
+    {
+    }
+
+    JsonMetricsScope(JsonMetricsScope const &)            = delete;
+    JsonMetricsScope &operator=(JsonMetricsScope const &) = delete;
+
+    ~JsonMetricsScope()
+    {
+        auto const elapsed = std::chrono::steady_clock::now() - start_;
+        JsonMetrics::record(
+            operation_,
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()),
+            std::uncaught_exceptions() > exceptions_
+        );
+    }
+};
+
+} // namespace util
+
+#endif // NS_UTIL_JSON_METRICS_H_INCLUDED
@@ -26,11 +26,50 @@
 #ifndef NS_UTIL_JSON_OBJECT_H_INCLUDED
 #define NS_UTIL_JSON_OBJECT_H_INCLUDED
 
+#include "json_array_index.h"
+#include "json_async.h"
+#include "json_column.h"
+#include "json_compression.h"
+#include "json_fragment_cache.h"
+#include "json_journal.h"
 #include "json_key_path.h"
+#include "json_key_path_cache.h"
+#include "json_memory.h"
+#include "json_merge.h"
+#include "json_metrics.h"
+#include "json_parallel.h"
+#include "json_projection.h"
+#include "json_traversal.h"
 #include "json_types.h"
 
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <expected>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <version>
+
+#if defined(__cpp_lib_format)
+#include <format>
+#endif
+
 namespace util
 {
+class FrozenJsonObject;
+class JsonCursor;
 
 struct expected_object_error : public std::runtime_error
 {
@@ -47,6 +86,11 @@ struct missing_key_error : public std::runtime_error
     using std::runtime_error::runtime_error;
 };
 
+struct invalid_cursor_error : public std::runtime_error
+{
+    using std::runtime_error::runtime_error;
+};
+
 /**
  * A class to handle json objects.
  * Keys in the object are addressed by paths constructed from index-keys and string-keys_.
@@ -74,14 +118,116 @@ struct missing_key_error : public std::runtime_error
  */
 class JsonObject
 {
-    value_type json_{};
+    value_type                               json_{};
+    std::shared_ptr<JsonKeyPathCache>        pathCache_{JsonKeyPathCache::shared()};
+    mutable std::optional<JsonFragmentCache> fragments_;
+    JsonArrayIndexes                         indexes_;
+    JsonJournalHandle                        journal_;
+    // generation of the last edit that shifted the elements of each array, and of the last change of the whole tree;
+    // cursors compare them with the generation they were created at
+    std::unordered_map<array_type const*, uint64_t> shiftedArrays_;
+    uint64_t                                        generation_{0};
+    uint64_t                                        resetGeneration_{0};
 
   public:
     JsonObject();
-    explicit JsonObject(std::string const& jsonStr);
+    explicit JsonObject(std::string_view jsonStr);
+
+    /**
+     * @brief Construct an empty object whose nodes are allocated from storage.
+     * @param storage memory resource for the whole document, e.g. a TrackingMemoryResource
+     */
+    explicit JsonObject(storage_type storage);
+
+    /**
+     * @brief Parse a json string into nodes allocated from storage.
+     * @param jsonStr the json text
+     * @param storage memory resource for the whole document, e.g. a TrackingMemoryResource
+     */
+    JsonObject(std::string_view jsonStr, storage_type storage);
 
     void clear();
 
+    /**
+     * @brief Retrieve the memory resource of the document.
+     * @return the storage all nodes are allocated from
+     */
+    [[nodiscard]] storage_type const& storage() const;
+
+    /**
+     * @brief Memory held by the document, if it was constructed with a TrackingMemoryResource.
+     * @return the counters of the resource, or std::nullopt for any other resource
+     */
+    [[nodiscard]] std::optional<JsonMemoryUsage> memoryUsage() const;
+
+    /**
+     * @brief Bytes needed by each top-level member, largest first, to find bloated parts of a document.
+     * Measured by copying each member into a fresh TrackingMemoryResource, so it costs a copy of the document and
+     * does not include spare capacity of the original containers. The key and the slot of the member in the top-level
+     * table are included.
+     * @return pairs of key and bytes; empty if the document is not an object
+     */
+    [[nodiscard]] std::vector<std::pair<std::string, size_t>> memoryByTopLevelKey() const;
+
+    /**
+     * @brief Set the cache that string paths given to get(), set() and the other path-based functions are parsed
+     * through. By default all objects share JsonKeyPathCache::shared().
+     * @param cache the cache, nullptr to parse every path string anew
+     */
+    void useKeyPathCache(std::shared_ptr<JsonKeyPathCache> cache);
+
+    /**
+     * @brief Retrieve the cache of parsed paths in use.
+     * @return the cache, or nullptr if caching is switched off
+     */
+    [[nodiscard]] std::shared_ptr<JsonKeyPathCache> const& keyPathCache() const;
+
+    /**
+     * @brief Switch caching of serialised subtrees on or off. With the cache on, compact toString() and write() (indent
+     * 0) re-render only the subtrees changed by set() since the previous call and splice in the cached text of all
+     * others. Mutable access through get() drops the whole cache.
+     * @param enable true to switch the cache on
+     */
+    void enableFragmentCache(bool enable = true);
+
+    /**
+     * @brief Switch on journaling: the document is written to filename as a snapshot, and from then on every set() and
+     * clear() is appended to the journal "<filename>.journal" instead of rewriting the file. load() replays the
+     * journal on top of the snapshot; loading into a journaled object journals the loaded document. Once the journal
+     * exceeds JsonJournalOptions::compactAfterBytes the journal's thread compacts it into a new snapshot. Journal
+     * errors do not fail set(): journaling stops and journal()->failure() reports the error until compactJournal()
+     * succeeds. Changes made through the mutable get() are not journaled; call compactJournal() after them.
+     * @param filename name of the snapshot file
+     * @param options commit and compaction settings
+     * @throws std::invalid_argument when the journal cannot be opened for writing
+     * @throws std::runtime_error when the snapshot cannot be written
+     */
+    void enableJournal(std::string const& filename, JsonJournalOptions const& options = {});
+
+    /**
+     * @brief Commit the journal and switch journaling off.
+     */
+    void disableJournal();
+
+    /**
+     * @brief Write and sync all journal records appended so far; a no-op without journal.
+     * @throws std::runtime_error when writing or syncing fails
+     */
+    void flushJournal();
+
+    /**
+     * @brief Write the document as a new snapshot and start an empty journal, clearing a recorded journal failure; a
+     * no-op without journal.
+     * @throws std::runtime_error when writing fails; the previous snapshot and journal then stay valid
+     */
+    void compactJournal();
+
+    /**
+     * @brief Retrieve the journal in use.
+     * @return the journal, or nullptr if journaling is switched off
+     */
+    [[nodiscard]] JsonJournal const* journal() const;
+
     /**
      * @brief Retrieve the underlying object.
      * @return the underlying object
@@ -97,7 +243,7 @@ class JsonObject
      *                               with the object
      */
     [[nodiscard]] value_type
-        get(std::string const& path, std::optional<value_type> const& defaultValue = std::optional<value_type>{}) const;
+        get(std::string_view path, std::optional<value_type> const& defaultValue = std::optional<value_type>{}) const;
 
     /**
      * @brief Get a value from this object given a path.
@@ -110,9 +256,71 @@ class JsonObject
     [[nodiscard]] value_type
         get(JsonKeyPath const& path, std::optional<value_type> const& defaultValue = std::optional<value_type>{}) const;
 
+    /**
+     * @brief Get a value from this object given a path, converted to T without copying the json value.
+     * T can be any type supported by value_as(). If T is a std::optional, then a missing key or index yields
+     * std::nullopt, as long as the path is compatible with the object.
+     * @param path key-path as string
+     * @return the converted value
+     * @throws std::invalid_argument when the path is incorrect, the value cannot be found or the path is incompatible
+     *                               with the object, or when the value cannot be converted to T
+     * @throws std::out_of_range when a numeric value does not fit into T
+     */
+    template<typename T>
+    [[nodiscard]] T get(std::string_view path) const;
+
+    /**
+     * @brief Get a value from this object given a path, converted to T without copying the json value.
+     * @param path key-path as JsonKeyPath
+     * @return the converted value
+     * @see get<T>(std::string_view)
+     */
+    template<typename T>
+    [[nodiscard]] T get(JsonKeyPath const& path) const;
+
+    /**
+     * @brief Get a value from this object given a path, converted to T, or the default if it does not exist.
+     * @param path key-path as string
+     * @param defaultValue value to return, if the given path is compatible with the object but does not exist
+     * @return the converted value or the default
+     * @see get<T>(std::string_view)
+     */
+    template<typename T>
+    [[nodiscard]] T get(std::string_view path, std::type_identity_t<T> const& defaultValue) const;
+
+    /**
+     * @brief Get a value from this object given a path, converted to T, or the default if it does not exist.
+     * @param path key-path as JsonKeyPath
+     * @param defaultValue value to return, if the given path is compatible with the object but does not exist
+     * @return the converted value or the default
+     * @see get<T>(std::string_view)
+     */
+    template<typename T>
+    [[nodiscard]] T get(JsonKeyPath const& path, std::type_identity_t<T> const& defaultValue) const;
+
     void checkBounds(std::optional<util::value_type> const& defaultValue, int64_t idx, util::value_type const* current)
         const;
 
+    /**
+     * @brief Get a value from this object given a path, converted to T, without throwing on a failed lookup or
+     * conversion. Errors carry the index of the failing path segment and never allocate. If T is a std::optional,
+     * then a missing key or index yields std::nullopt instead of an error.
+     * @param path key-path as JsonKeyPath
+     * @return the converted value, or the error: missing_key, index_out_of_bounds, expected_object or expected_array
+     *         for the path, type_mismatch or out_of_range (segment JsonPathError::noSegment) for the conversion
+     */
+    template<typename T = value_type>
+    [[nodiscard]] std::expected<T, JsonPathError> tryGet(JsonKeyPath const& path) const;
+
+    /**
+     * @brief Get a value from this object given a path string, converted to T, without throwing.
+     * @param path key-path as string
+     * @return the converted value, or the error; an unparsable path yields empty_path or invalid_key
+     * @see tryGet(JsonKeyPath const&)
+     */
+    template<typename T = value_type>
+    [[nodiscard]] std::expected<T, JsonPathError> tryGet(std::string_view path) const;
+
     /**
      * @brief Set the value in the json object, if possible
      * @param path key-path as string
@@ -120,7 +328,7 @@ class JsonObject
      * @param force if true, then create missing keys, as long as compatible
      * @throws std::invalid_argument when the path is incorrect or the path is incompatible with the object
      */
-    void set(std::string const& path, value_type const& value, bool force = false);
+    void set(std::string_view path, value_type const& value, bool force = false);
 
     /**
      * @brief Set the value in the json object, if possible
@@ -131,6 +339,280 @@ class JsonObject
      */
     void set(JsonKeyPath const& path, value_type const& value, bool force = false);
 
+    /**
+     * @brief Set the value in the json object, if possible, without throwing on an incompatible path.
+     * Containers created for force are kept when a later segment fails, as with set().
+     * @param path key-path as JsonKeyPath
+     * @param value value to set
+     * @param force if true, then create missing keys, as long as compatible
+     * @return nothing, or the error: expected_object, expected_array, missing_key or index_out_of_bounds
+     */
+    std::expected<void, JsonPathError> trySet(JsonKeyPath const& path, value_type const& value, bool force = false);
+
+    /**
+     * @brief Set the value in the json object given a path string, without throwing on an invalid or incompatible
+     * path.
+     * @see trySet(JsonKeyPath const&, value_type const&, bool)
+     */
+    std::expected<void, JsonPathError> trySet(std::string_view path, value_type const& value, bool force = false);
+
+    /**
+     * @brief Pin the node at path, so that many reads and writes below it do not walk the full path each time.
+     * @param path key-path as JsonKeyPath; the empty path pins the root
+     * @return the cursor; it must not outlive this object
+     * @throws std::invalid_argument when the path is incorrect or the node does not exist
+     * @see JsonCursor
+     */
+    [[nodiscard]] JsonCursor cursor(JsonKeyPath const& path = {});
+
+    /**
+     * @brief Pin the node at path.
+     * @param path key-path as string
+     * @see cursor(JsonKeyPath const&)
+     */
+    [[nodiscard]] JsonCursor cursor(std::string_view path);
+
+    /**
+     * @brief Index the objects of an array by the text of one member, so that selectors like users/[id=abc123] find
+     * their element in O(1) instead of scanning the array. The index is kept up to date by set(), appendRange() and
+     * prependRange(); other changes of the array make the next lookup rebuild it. Strings are indexed as they are,
+     * integers and booleans as json text; elements without the member or with other kinds are not indexed.
+     * @param arrayPath key-path of the array; only string keys and positions, the array need not exist yet
+     * @param field the member to index
+     * @return false if the index already exists
+     * @throws std::invalid_argument when arrayPath holds [^], [$] or a selector, or field is not a valid string key
+     */
+    bool createIndex(JsonKeyPath const& arrayPath, std::string_view field);
+
+    /**
+     * @brief Index the objects of an array by the text of one member.
+     * @param arrayPath key-path of the array as string
+     * @param field the member to index
+     * @see createIndex(JsonKeyPath const&, std::string_view)
+     */
+    bool createIndex(std::string_view arrayPath, std::string_view field);
+
+    /**
+     * @brief Remove an index created by createIndex(); selectors scan the array again.
+     * @param arrayPath key-path of the array
+     * @param field the indexed member
+     * @return false if there was no such index
+     */
+    bool dropIndex(JsonKeyPath const& arrayPath, std::string_view field);
+
+    /**
+     * @brief Remove an index created by createIndex().
+     * @param arrayPath key-path of the array as string
+     * @param field the indexed member
+     * @see dropIndex(JsonKeyPath const&, std::string_view)
+     */
+    bool dropIndex(std::string_view arrayPath, std::string_view field);
+
+    /**
+     * @brief Append values to the array at path, moving them in with at most one reallocation.
+     * @param path key-path as string, addressing an array
+     * @param values values to append, in order
+     * @param force if true, then create missing keys and replace a non-array at path by an array
+     * @throws std::invalid_argument when the path is incorrect or the path is incompatible with the object
+     */
+    void appendRange(std::string_view path, std::vector<value_type> values, bool force = false);
+
+    /**
+     * @brief Append values to the array at path, moving them in with at most one reallocation.
+     * @see appendRange(std::string_view, std::vector<value_type>, bool)
+     */
+    void appendRange(JsonKeyPath const& path, std::vector<value_type> values, bool force = false);
+
+    /**
+     * @brief Insert values at the front of the array at path, in their order, shifting the existing elements once.
+     * @param path key-path as string, addressing an array
+     * @param values values to prepend, in order
+     * @param force if true, then create missing keys and replace a non-array at path by an array
+     * @throws std::invalid_argument when the path is incorrect or the path is incompatible with the object
+     */
+    void prependRange(std::string_view path, std::vector<value_type> values, bool force = false);
+
+    /**
+     * @brief Insert values at the front of the array at path, in their order, shifting the existing elements once.
+     * @see prependRange(std::string_view, std::vector<value_type>, bool)
+     */
+    void prependRange(JsonKeyPath const& path, std::vector<value_type> values, bool force = false);
+
+    /**
+     * @brief Insert values before position index of the array at path, shifting the elements behind it once.
+     * @param path key-path as string, addressing an array
+     * @param index position of the first inserted value; the size of the array appends
+     * @param values values to insert, in order
+     * @param force if true, then create missing keys, replace a non-array at path by an array and pad the array with
+     * null up to index
+     * @throws std::invalid_argument when the path is incorrect, the path is incompatible with the object or index is
+     * beyond the end of the array when not forced
+     */
+    void insertRange(std::string_view path, size_t index, std::vector<value_type> values, bool force = false);
+
+    /**
+     * @brief Insert values before position index of the array at path, shifting the elements behind it once.
+     * @see insertRange(std::string_view, size_t, std::vector<value_type>, bool)
+     */
+    void insertRange(JsonKeyPath const& path, size_t index, std::vector<value_type> values, bool force = false);
+
+    /**
+     * @brief Reserve room for capacity elements in the array at path, so that appending up to it does not reallocate.
+     * @param path key-path as string, addressing an array
+     * @param capacity number of elements
+     * @param force if true, then create missing keys and replace a non-array at path by an array
+     * @throws std::invalid_argument when the path is incorrect or the path is incompatible with the object
+     */
+    void reserve(std::string_view path, size_t capacity, bool force = false);
+
+    /**
+     * @brief Reserve room for capacity elements in the array at path, so that appending up to it does not reallocate.
+     * @see reserve(std::string_view, size_t, bool)
+     */
+    void reserve(JsonKeyPath const& path, size_t capacity, bool force = false);
+
+    /**
+     * @brief Call fn for each element of the array at path, splitting the array into chunks processed in parallel.
+     * <br>Elements are passed by reference; fn is shared by all threads, so it must be safe to call concurrently. The
+     * object must not be changed before the call returns.
+     * @param path key-path as string, addressing an array
+     * @param fn called as fn(element) or fn(element, index)
+     * @param options the pool and the chunking
+     * @throws expected_array_error when there is no array at path
+     * @throws the first exception thrown by fn
+     */
+    template<typename Fn>
+    void forEach(std::string_view path, Fn fn, JsonParallelOptions const& options = {}) const;
+
+    /**
+     * @brief Call fn for each element of the array at path, splitting the array into chunks processed in parallel.
+     * @see forEach(std::string_view, Fn, JsonParallelOptions const&)
+     */
+    template<typename Fn>
+    void forEach(JsonKeyPath const& path, Fn fn, JsonParallelOptions const& options = {}) const;
+
+    /**
+     * @brief Change each element of the array at path, splitting the array into chunks processed in parallel.
+     * <br>New values are allocated from the storage of the object, so the chunks run on the calling thread only unless
+     * the storage is the default one or options.storageThreadSafe is set. The array is journaled and its indexes are
+     * updated as a whole, also when fn throws part way.
+     * @param path key-path as string, addressing an array
+     * @param fn called as fn(element); either changes the element in place and returns nothing, or returns the
+     * replacement of the element
+     * @param options the pool and the chunking
+     * @throws expected_array_error when there is no array at path
+     * @throws the first exception thrown by fn; elements processed before remain changed
+     */
+    template<typename Fn>
+    void transform(std::string_view path, Fn fn, JsonParallelOptions const& options = {});
+
+    /**
+     * @brief Change each element of the array at path, splitting the array into chunks processed in parallel.
+     * @see transform(std::string_view, Fn, JsonParallelOptions const&)
+     */
+    template<typename Fn>
+    void transform(JsonKeyPath const& path, Fn fn, JsonParallelOptions const& options = {});
+
+    /**
+     * @brief Fold the elements of the array at path, splitting the array into chunks processed in parallel.
+     * <br>Each chunk is folded from identity by fn; the results of the chunks are then combined in the order of the
+     * chunks, so combine needs to be associative but not commutative.
+     * @param path key-path as string, addressing an array
+     * @param identity start value of each chunk and of the result
+     * @param fn called as fn(accumulated, element), returning the new accumulated value
+     * @param combine called as combine(left, right) to join the results of adjacent chunks
+     * @param options the pool and the chunking
+     * @return the folded value; identity for an empty array
+     * @throws expected_array_error when there is no array at path
+     * @throws the first exception thrown by fn
+     */
+    template<typename T, typename Fn, typename Combine = std::plus<>>
+    [[nodiscard]] T reduce(
+        std::string_view           path,
+        T                          identity,
+        Fn                         fn,
+        Combine                    combine = {},
+        JsonParallelOptions const& options = {}
+    ) const;
+
+    /**
+     * @brief Fold the elements of the array at path, splitting the array into chunks processed in parallel.
+     * @see reduce(std::string_view, T, Fn, Combine, JsonParallelOptions const&)
+     */
+    template<typename T, typename Fn, typename Combine = std::plus<>>
+    [[nodiscard]] T reduce(
+        JsonKeyPath const&         path,
+        T                          identity,
+        Fn                         fn,
+        Combine                    combine = {},
+        JsonParallelOptions const& options = {}
+    ) const;
+
+    /**
+     * @brief Extract a numeric field of all elements of the array at path into a contiguous column, in one pass.
+     * @param arrayPath key-path as string, addressing an array
+     * @param fieldPath key-path as string relative to each element, e.g. "latency_ms"; empty for the elements
+     * themselves
+     * @return the column with one slot per element; elements without a suitable number give null slots
+     * @throws expected_array_error when there is no array at arrayPath
+     */
+    template<typename T>
+    [[nodiscard]] JsonColumn<T> column(std::string_view arrayPath, std::string_view fieldPath = {}) const;
+
+    /**
+     * @brief Extract a numeric field of all elements of the array at path into a contiguous column, in one pass.
+     * @see column(std::string_view, std::string_view)
+     */
+    template<typename T>
+    [[nodiscard]] JsonColumn<T> column(JsonKeyPath const& arrayPath, JsonKeyPath const& fieldPath = {}) const;
+
+    /**
+     * @brief Start a non-recursive depth-first traversal of the document.
+     * @return the traversal; the object must not be changed while it is in use
+     */
+    [[nodiscard]] JsonTraversal traverse() const;
+
+    /**
+     * @brief Walk the document depth-first without recursion.
+     * @param visitor called for each enter, leave and value step; returns whether to proceed, skip the members of an
+     * entered container or stop
+     * @return false if the visitor stopped the traversal
+     */
+    template<JsonVisitor Visitor>
+    bool visit(Visitor&& visitor) const
+    {
+        return json_visit(json_, std::forward<Visitor>(visitor));
+    }
+
+    /**
+     * @brief Deep merge layers, later layers on top of earlier ones; objects are merged member by member, arrays and
+     * other values as the policy says. Top-level members are merged in parallel.
+     * @param layers the layers, lowest first; they are copied from
+     * @param policy array and conflict policies
+     * @return the merged object, using the storage of the first layer
+     * @throws merge_conflict_error on a conflict with JsonConflictPolicy::error
+     */
+    [[nodiscard]] static JsonObject merge(std::span<JsonObject const> layers, JsonMergePolicy const& policy = {});
+
+    /**
+     * @brief Deep merge layers, moving values out of them instead of copying.
+     * @see merge(std::span<JsonObject const>, JsonMergePolicy const&)
+     * @param layers the layers, lowest first; left in a valid but unspecified state
+     * @param policy array and conflict policies
+     * @return the merged object, using the storage of the first layer
+     * @throws merge_conflict_error on a conflict with JsonConflictPolicy::error
+     */
+    [[nodiscard]] static JsonObject merge(std::vector<JsonObject>&& layers, JsonMergePolicy const& policy = {});
+
+    /**
+     * @brief Create an immutable copy laid out for fast lookups; requires json_frozen_object.h.
+     * <br>With an intern table, the keys of the copy are handles into the table instead of strings, so copies frozen
+     * with the same table share one copy of every key name, and are looked up by handle.
+     * @param keyTable optional intern table for the object keys
+     * @return the frozen copy
+     */
+    [[nodiscard]] FrozenJsonObject freeze(std::shared_ptr<JsonKeyInternTable> keyTable = nullptr) const;
+
     /**
      * @brief Make a string of the object.
      * @param indent indentation spaces
@@ -138,11 +620,746 @@ class JsonObject
      */
     [[nodiscard]] std::string toString(size_t indent = 4) const;
 
+    /**
+     * @brief Compute the exact length of toString(indent) without building the string, e.g. to allocate a buffer once.
+     * @param indent indentation spaces; 0 for compact text
+     * @return the number of characters
+     */
+    [[nodiscard]] size_t serializedSize(size_t indent = 4) const;
+
+    /**
+     * @brief Write the text of toString(indent) into a caller-provided buffer, without allocating.
+     * @param buffer the buffer, at least serializedSize(indent) characters long; no terminating '\0' is written
+     * @param indent indentation spaces; 0 for compact text
+     * @return the number of characters written
+     * @throws std::length_error when the buffer is too small; its contents are then unspecified
+     */
+    size_t serializeTo(std::span<char> buffer, size_t indent = 4) const;
+
+    /**
+     * @brief Write the text of toString(indent) to an output iterator, e.g. std::back_inserter or the iterator of a
+     * std::format_to() call. Raw pointers are not accepted, as nothing would bound them; wrap them in a std::span.
+     * @param out the iterator
+     * @param indent indentation spaces; 0 for compact text
+     * @return the iterator past the last character written
+     */
+    template<std::output_iterator<char const&> Out>
+        requires(!std::is_pointer_v<Out>)
+    Out serializeTo(Out out, size_t indent = 4) const;
+
+    /**
+     * @brief Load a json file, and replay the journal next to it if there is one that belongs to it.
+     * @param filename name of the file
+     * @throws std::invalid_argument when the file cannot be read or the journal is corrupt
+     */
     void load(std::string const& filename);
 
     void write(std::string const& filename, size_t indent = 4) const;
+
+    /**
+     * @brief Load only the given paths of a json file; everything else is skipped without being parsed.
+     * @see JsonProjection for the shape of the result
+     * @param filename name of the file
+     * @param paths the paths to keep
+     * @param storage memory resource for the result
+     * @return an object holding the values at the paths that exist in the file
+     * @throws std::invalid_argument when the file cannot be read or is not valid json
+     */
+    [[nodiscard]] static JsonObject
+        loadProjected(std::string const& filename, std::span<JsonKeyPath const> paths, storage_type storage = {});
+
+    /**
+     * @brief Parse only the given paths of a json text; everything else is skipped without being parsed.
+     * @see JsonProjection for the shape of the result
+     * @param text the json text
+     * @param paths the paths to keep
+     * @param storage memory resource for the result
+     * @return an object holding the values at the paths that exist in the text
+     * @throws std::invalid_argument when the text is not valid json
+     */
+    [[nodiscard]] static JsonObject
+        parseProjected(std::string_view text, std::span<JsonKeyPath const> paths, storage_type storage = {});
+
+#if defined(JSONOBJECT_ENABLE_ZLIB)
+    /**
+     * @brief Load a gzip- or zlib-compressed json file without decompressing it to disk. One thread decompresses while
+     * this thread parses, so loading takes about as long as the slower of the two.
+     * @param filename name of the compressed file
+     * @param options chunk size and number of buffers between the threads
+     * @throws std::invalid_argument when the file cannot be opened for reading, is not valid compressed data or does
+     *                               not contain valid json
+     */
+    void loadCompressed(std::string const& filename, JsonCompressionOptions const& options = {});
+
+    /**
+     * @brief Write the object to a gzip-compressed json file. This thread serialises while another one compresses and
+     * writes; compact output (indent 0) is never held in full.
+     * @param filename name of the file
+     * @param indent indentation spaces
+     * @param options compression level, chunk size and number of buffers between the threads
+     * @throws std::invalid_argument when the file cannot be opened for writing
+     * @throws std::runtime_error when compressing or writing fails
+     */
+    void writeCompressed(std::string const& filename, size_t indent = 0, JsonCompressionOptions const& options = {})
+        const;
+#endif
+
+    /**
+     * @brief Load a json file on a thread pool, as load() does: co_await JsonObject::loadAsync(filename).
+     * The file is read in chunks of JsonAsyncOptions::chunkSize, the next chunk being read while the current one is
+     * parsed, so only two chunks of text are in memory besides the document.
+     * @param filename name of the file
+     * @param options pool, executor that resumes the caller, stop token and chunk size
+     * @return awaitable yielding the loaded object
+     * @throws std::invalid_argument when the file cannot be read or the journal is corrupt
+     * @throws cancelled_error when the stop token is triggered before the file is parsed
+     */
+    [[nodiscard]] static JsonAsync<JsonObject> loadAsync(std::string filename, JsonAsyncOptions options = {});
+
+    /**
+     * @brief Write the object to a json file on a thread pool, as write() does: co_await obj.writeAsync(filename).
+     * The object must neither be changed nor destroyed before the write completes. Compact output (indent 0) is
+     * serialised chunk by chunk while the previous chunk is written; indented output is rendered first. The file is
+     * written under a temporary name and renamed when complete, so a cancelled write leaves the old file in place.
+     * @param filename name of the file
+     * @param indent indentation spaces
+     * @param options pool, executor that resumes the caller, stop token and chunk size
+     * @return awaitable completing when the file is written
+     * @throws std::invalid_argument when the file cannot be opened for writing
+     * @throws cancelled_error when the stop token is triggered before the file is complete
+     */
+    [[nodiscard]] JsonAsync<void>
+        writeAsync(std::string filename, size_t indent = 4, JsonAsyncOptions options = {}) const;
+
+  private:
+    friend class JsonCursor;
+
+    [[nodiscard]] JsonKeyPathCache::PathPtr makePath(std::string_view path) const;
+    [[nodiscard]] std::expected<JsonKeyPathCache::PathPtr, JsonPathError> tryMakePath(std::string_view path) const;
+
+    /**
+     * @brief Find the node addressed by path inside the tree.
+     * @param root node the path is relative to
+     * @param path key-path as JsonKeyPath
+     * @param allowMissing if true, then a missing key or index returns nullptr instead of throwing
+     * @param base key-path of root, so that selectors can use the array indexes; empty if root is the document
+     * @return pointer to the node in the tree, or nullptr if it does not exist and allowMissing is set
+     * @throws std::invalid_argument when the path is incompatible with the object or an index is out of bounds
+     * @throws missing_key_error when a key is missing and allowMissing is not set
+     */
+    [[nodiscard]] value_type const*
+        find(value_type const& root, JsonKeyPath const& path, bool allowMissing, JsonArrayIndexes::KeySpan base = {})
+            const;
+
+    /**
+     * @brief Find the node addressed by path inside the tree, without throwing.
+     * @param root node the path is relative to
+     * @param path key-path as JsonKeyPath
+     * @param base key-path of root, so that selectors can use the array indexes; empty if root is the document
+     * @return pointer to the node in the tree, or the error and the failing segment
+     */
+    [[nodiscard]] std::expected<value_type const*, JsonPathError>
+        locate(value_type const& root, JsonKeyPath const& path, JsonArrayIndexes::KeySpan base = {}) const;
+
+    std::expected<void, JsonPathError> trySetInternal(
+        value_type&               root,
+        JsonKeyPath const&        path,
+        value_type const&         value,
+        bool                      force,
+        JsonArrayIndexes::KeySpan base = {}
+    );
+
+    /**
+     * @brief Set a value from the root, keeping the array indexes, the fragment cache and the journal up to date.
+     * @see trySet(JsonKeyPath const&, value_type const&, bool)
+     */
+    std::expected<void, JsonPathError> trySetTracked(JsonKeyPath const& path, value_type const& value, bool force);
+
+    /**
+     * @brief Set a value below a node of the tree, keeping the array indexes, the fragment cache and the journal up to
+     * date.
+     * @param node the node the path is relative to
+     * @param prefix resolved key-path of node, without [^] or [$]
+     * @param path key-path relative to node
+     * @param value value to set
+     * @param force if true, then create missing keys, as long as compatible
+     * @return nothing, or the error and the failing segment of path
+     */
+    std::expected<void, JsonPathError> trySetBelow(
+        value_type&        node,
+        JsonKeyPath const& prefix,
+        JsonKeyPath const& path,
+        value_type const&  value,
+        bool               force
+    );
+    void journalSet(JsonKeyPath const& path, value_type const& value, bool force, bool succeeded);
+
+    /**
+     * @brief Record that the elements of arr moved to other indices, so cursors through arr become invalid. Once too
+     * many arrays are recorded this falls back to resetCursors().
+     */
+    void shifted(array_type const& arr);
+
+    /**
+     * @brief Record that the whole tree may have changed, so all cursors become invalid.
+     */
+    void resetCursors();
+    void replayInsert(JsonJournalRecord const& record);
+    void finishLoad(std::string const& filename, JsonSnapshotDigest const& snapshot);
+
+    /**
+     * @brief Find the array addressed by path, creating it if forced.
+     * @param path key-path as JsonKeyPath
+     * @param force if true, then create missing keys and replace non-containers on the way
+     * @param resolved receives path with [^] and [$] replaced by the indices they resolved to
+     * @return the array, or the error and the failing segment
+     */
+    std::expected<array_type*, JsonPathError> locateArray(JsonKeyPath const& path, bool force, JsonKeyPath& resolved);
+
+    /**
+     * @brief Find the array addressed by path for reading.
+     * @throws expected_array_error when there is no array at path
+     */
+    [[nodiscard]] array_type const& arrayAt(JsonKeyPath const& path) const;
+
+    /**
+     * @brief Apply change to the array at path, then update the indexes, the fragment cache and the journal, also when
+     * change throws.
+     * @throws expected_array_error when there is no array at path
+     */
+    void transformArray(JsonKeyPath const& path, std::function<void(array_type&)> const& change);
+
+    /**
+     * @brief Whether new values may be allocated from the storage of the object on several threads at once.
+     */
+    [[nodiscard]] bool storageThreadSafe(JsonParallelOptions const& options) const;
+
+    /**
+     * @brief Serialise as toString(indent) does, handing the text to sink in pieces of at most a few KiB.
+     */
+    void serializeChunks(size_t indent, std::function<void(std::string_view)> const& sink) const;
+
+    /**
+     * @brief Insert count values into the array at path, then update the indexes, the fragment cache and the journal.
+     * @param change inserts the values and returns the index of the first one
+     */
+    template<typename Change>
+    void changeArray(JsonKeyPath const& path, bool force, JsonArrayEdit edit, size_t count, Change&& change);
+
+    [[noreturn]] void
+        throwLookupError(value_type const& root, JsonKeyPath const& path, JsonPathError const& error) const;
+    [[noreturn]] void throwSetError(JsonKeyPath const& path, JsonPathError const& error) const;
+};
+
+/**
+ * Collects values to prepend to an array and inserts them all with one shift of the existing elements: a commit of k
+ * values into an array of n costs O(n + k) instead of the O(n * k) of k calls to set("…/[^]", value), and only the k
+ * values are journaled. That is O(1) per value when each batch is at least as large as the array. Values pushed
+ * later end up further to the front, exactly as with repeated set("…/[^]", value). Nothing is visible in the object
+ * before commit(); values not committed when the batch is destroyed are discarded.
+ */
+class JsonPrependBatch
+{
+    JsonObject&             object_;
+    JsonKeyPath             path_;
+    bool                    force_;
+    std::vector<value_type> values_;
+
+  public:
+    /**
+     * @brief Start a batch for the array at path.
+     * @param object the object holding the array; must outlive the batch
+     * @param path key-path of the array
+     * @param force passed on to prependRange() by commit()
+     */
+    JsonPrependBatch(JsonObject& object, JsonKeyPath path, bool force = false)
+        : object_(object)
+        , path_(std::move(path))
+        , force_(force)
+    {
+    }
+
+    /**
+     * @brief Queue a value to go in front of all values queued before it.
+     * @param value the value
+     */
+    void push(value_type value)
+    {
+        values_.push_back(std::move(value));
+    }
+
+    /**
+     * @brief Number of values queued and not yet committed.
+     */
+    [[nodiscard]] size_t size() const
+    {
+        return values_.size();
+    }
+
+    /**
+     * @brief Prepend all queued values to the array; the batch can be used again afterwards.
+     * @throws std::invalid_argument when the path is incorrect or the path is incompatible with the object
+     */
+    void commit()
+    {
+        std::ranges::reverse(values_);
+        object_.prependRange(path_, std::exchange(values_, {}), force_);
+    }
+};
+
+/**
+ * A position inside a JsonObject. The cursor keeps the nodes from the root down to the pinned node, so that relative
+ * reads and writes only walk the relative path, and parent() and the sibling functions cost O(1) walks. Relative
+ * paths follow the same rules as the paths of JsonObject, and the empty path addresses the pinned node itself.
+ * <br><br>A cursor holds pointers into the tree: changes that restructure one of its containers, e.g. prepending or
+ * inserting into an array on its path, replacing an ancestor, clearing or loading the object or taking the mutable
+ * json with get(), invalidate it. The object counts the edits that shift the elements of an array, so a shift is
+ * detected even when the element the cursor points at is still in place. Writes through the cursor below its node
+ * keep it valid. Builds without NDEBUG check the cursor on every access and throw invalid_cursor_error once it is
+ * invalid; release builds do not check, but isValid() is always available. The object must outlive the cursor and
+ * must not be moved.
+ */
+class JsonCursor
+{
+    JsonObject*              object_;
+    JsonKeyPath              path_;
+    std::vector<value_type*> nodes_;
+    uint64_t                 generation_;
+
+    void                            descend(JsonKeyPath const& path);
+    void                            check() const;
+    [[nodiscard]] value_type const* find(JsonKeyPath const& path, bool allowMissing) const;
+    [[nodiscard]] std::optional<JsonCursor> sibling(std::ptrdiff_t offset) const;
+
+  public:
+    /**
+     * @brief Pin the node at path.
+     * @param object the object; must outlive the cursor
+     * @param path key-path as JsonKeyPath; [^] and [$] are resolved to the index they address now
+     * @throws std::invalid_argument when the path is incorrect or the node does not exist
+     */
+    JsonCursor(JsonObject& object, JsonKeyPath const& path);
+
+    /**
+     * @brief The pinned node.
+     * @throws invalid_cursor_error when the cursor was invalidated (checked only without NDEBUG)
+     */
+    [[nodiscard]] value_type const& value() const;
+
+    /**
+     * @brief Key-path of the pinned node from the root, with [^] and [$] resolved to indices.
+     */
+    [[nodiscard]] JsonKeyPath const& path() const;
+
+    /**
+     * @brief Number of keys between the root and the pinned node.
+     */
+    [[nodiscard]] size_t depth() const;
+
+    /**
+     * @brief Check that no array on the path was shifted since the cursor was created, and that the nodes the cursor
+     * holds are still the nodes its path addresses, walking from the root.
+     * @return true if the cursor can be used
+     */
+    [[nodiscard]] bool isValid() const;
+
+    /**
+     * @brief Get a value relative to the pinned node.
+     * @param path key-path relative to the pinned node
+     * @param defaultValue optional default value to return, if given path is compatible with the node
+     * @return the value if possible
+     * @throws std::invalid_argument when the path is incorrect, the value cannot be found or the path is incompatible
+     *                               with the node
+     * @see JsonObject::get(JsonKeyPath const&, std::optional<value_type> const&)
+     */
+    [[nodiscard]] value_type
+        get(JsonKeyPath const& path, std::optional<value_type> const& defaultValue = std::optional<value_type>{}) const;
+
+    /**
+     * @brief Get a value relative to the pinned node.
+     * @param path key-path relative to the pinned node as string
+     * @see get(JsonKeyPath const&, std::optional<value_type> const&)
+     */
+    [[nodiscard]] value_type
+        get(std::string_view path, std::optional<value_type> const& defaultValue = std::optional<value_type>{}) const;
+
+    /**
+     * @brief Get a value relative to the pinned node, converted to T without copying the json value.
+     * @param path key-path relative to the pinned node
+     * @see JsonObject::get<T>(JsonKeyPath const&)
+     */
+    template<typename T>
+    [[nodiscard]] T get(JsonKeyPath const& path) const;
+
+    /**
+     * @brief Get a value relative to the pinned node, converted to T without copying the json value.
+     * @param path key-path relative to the pinned node as string
+     * @see JsonObject::get<T>(JsonKeyPath const&)
+     */
+    template<typename T>
+    [[nodiscard]] T get(std::string_view path) const;
+
+    /**
+     * @brief Get a value relative to the pinned node, converted to T, or the default if it does not exist.
+     * @param path key-path relative to the pinned node
+     * @param defaultValue value to return, if the given path is compatible with the node but does not exist
+     * @see JsonObject::get<T>(JsonKeyPath const&, std::type_identity_t<T> const&)
+     */
+    template<typename T>
+    [[nodiscard]] T get(JsonKeyPath const& path, std::type_identity_t<T> const& defaultValue) const;
+
+    /**
+     * @brief Get a value relative to the pinned node, converted to T, or the default if it does not exist.
+     * @param path key-path relative to the pinned node as string
+     * @param defaultValue value to return, if the given path is compatible with the node but does not exist
+     * @see JsonObject::get<T>(JsonKeyPath const&, std::type_identity_t<T> const&)
+     */
+    template<typename T>
+    [[nodiscard]] T get(std::string_view path, std::type_identity_t<T> const& defaultValue) const;
+
+    /**
+     * @brief Set a value relative to the pinned node; the object's fragment cache and journal see the full path.
+     * @param path key-path relative to the pinned node
+     * @param value value to set
+     * @param force if true, then create missing keys, as long as compatible
+     * @throws std::invalid_argument when the path is incorrect or the path is incompatible with the node
+     * @see JsonObject::set(JsonKeyPath const&, value_type const&, bool)
+     */
+    void set(JsonKeyPath const& path, value_type const& value, bool force = false);
+
+    /**
+     * @brief Set a value relative to the pinned node.
+     * @param path key-path relative to the pinned node as string
+     * @see set(JsonKeyPath const&, value_type const&, bool)
+     */
+    void set(std::string_view path, value_type const& value, bool force = false);
+
+    /**
+     * @brief Pin a node relative to this one.
+     * @param path key-path relative to the pinned node
+     * @return the new cursor; this cursor is not changed
+     * @throws std::invalid_argument when the path is incorrect or the node does not exist
+     */
+    [[nodiscard]] JsonCursor cursor(JsonKeyPath const& path) const;
+
+    /**
+     * @brief Pin a node relative to this one.
+     * @param path key-path relative to the pinned node as string
+     * @see cursor(JsonKeyPath const&)
+     */
+    [[nodiscard]] JsonCursor cursor(std::string_view path) const;
+
+    /**
+     * @brief Whether the pinned node is not the root.
+     */
+    [[nodiscard]] bool hasParent() const;
+
+    /**
+     * @brief Cursor at the container of the pinned node.
+     * @throws std::invalid_argument when the cursor is at the root
+     */
+    [[nodiscard]] JsonCursor parent() const;
+
+    /**
+     * @brief Cursor at the next element of the same array, or the next member of the same object in member order.
+     * @return the cursor, or std::nullopt if the pinned node is the last one or the root
+     * @throws std::invalid_argument when the member's key cannot be part of a path, e.g. a numeric-only key
+     */
+    [[nodiscard]] std::optional<JsonCursor> nextSibling() const;
+
+    /**
+     * @brief Cursor at the previous element of the same array, or the previous member of the same object.
+     * @return the cursor, or std::nullopt if the pinned node is the first one or the root
+     * @throws std::invalid_argument when the member's key cannot be part of a path
+     */
+    [[nodiscard]] std::optional<JsonCursor> previousSibling() const;
 };
 
+template<typename T>
+T JsonObject::get(std::string_view path) const
+{
+    return get<T>(*makePath(path));
+}
+
+template<typename T>
+T JsonObject::get(JsonKeyPath const& path) const
+{
+    JSONOBJECT_METRICS_SCOPE(JsonOperation::get);
+    if constexpr (is_optional_v<T>)
+    {
+        value_type const* found = find(json_, path, true);
+        return found == nullptr ? T{} : value_as<T>(*found);
+    }
+    else
+    {
+        return value_as<T>(*find(json_, path, false));
+    }
+}
+
+template<typename T>
+T JsonObject::get(std::string_view path, std::type_identity_t<T> const& defaultValue) const
+{
+    return get<T>(*makePath(path), defaultValue);
+}
+
+template<typename T>
+T JsonObject::get(JsonKeyPath const& path, std::type_identity_t<T> const& defaultValue) const
+{
+    JSONOBJECT_METRICS_SCOPE(JsonOperation::get);
+    value_type const* found = find(json_, path, true);
+    if (found == nullptr)
+    {
+        JSONOBJECT_METRICS_ADD(JsonCounter::defaultFallbacks, 1);
+        return defaultValue;
+    }
+    return value_as<T>(*found);
+}
+
+template<typename T>
+std::expected<T, JsonPathError> JsonObject::tryGet(JsonKeyPath const& path) const
+{
+    JSONOBJECT_METRICS_SCOPE(JsonOperation::get);
+    auto found = locate(json_, path);
+    if (!found)
+    {
+        if constexpr (is_optional_v<T>)
+        {
+            auto const code = found.error().code;
+            if (code == json_errc::missing_key || code == json_errc::index_out_of_bounds)
+            {
+                return T{};
+            }
+        }
+        return std::unexpected(found.error());
+    }
+    auto converted = try_value_as<T>(**found);
+    if (!converted)
+    {
+        return std::unexpected(JsonPathError{converted.error()});
+    }
+    return std::move(*converted);
+}
+
+template<typename T>
+std::expected<T, JsonPathError> JsonObject::tryGet(std::string_view path) const
+{
+    auto parsed = tryMakePath(path);
+    if (!parsed)
+    {
+        return std::unexpected(parsed.error());
+    }
+    return tryGet<T>(**parsed);
+}
+
+template<typename Fn>
+void JsonObject::forEach(std::string_view path, Fn fn, JsonParallelOptions const& options) const
+{
+    forEach(*makePath(path), std::move(fn), options);
+}
+
+template<typename Fn>
+void JsonObject::forEach(JsonKeyPath const& path, Fn fn, JsonParallelOptions const& options) const
+{
+    auto const& array = arrayAt(path);
+    json_parallel_for(
+        array.size(),
+        [&array, &fn](size_t begin, size_t end) {
+            for (size_t index = begin; index < end; ++index)
+            {
+                if constexpr (std::invocable<Fn&, value_type const&, size_t>)
+                {
+                    fn(array[index], index);
+                }
+                else
+                {
+                    fn(array[index]);
+                }
+            }
+        },
+        options
+    );
+}
+
+template<typename Fn>
+void JsonObject::transform(std::string_view path, Fn fn, JsonParallelOptions const& options)
+{
+    transform(*makePath(path), std::move(fn), options);
+}
+
+template<typename Fn>
+void JsonObject::transform(JsonKeyPath const& path, Fn fn, JsonParallelOptions const& options)
+{
+    auto parallel = options;
+    if (!storageThreadSafe(options))
+    {
+        parallel.minParallelSize = std::numeric_limits<size_t>::max();
+    }
+    transformArray(path, [&fn, &parallel](array_type& array) {
+        json_parallel_for(
+            array.size(),
+            [&array, &fn](size_t begin, size_t end) {
+                for (size_t index = begin; index < end; ++index)
+                {
+                    if constexpr (std::is_void_v<std::invoke_result_t<Fn&, value_type&>>)
+                    {
+                        fn(array[index]);
+                    }
+                    else
+                    {
+                        array[index] = fn(array[index]);
+                    }
+                }
+            },
+            parallel
+        );
+    });
+}
+
+template<typename T, typename Fn, typename Combine>
+T JsonObject::reduce(
+    std::string_view           path,
+    T                          identity,
+    Fn                         fn,
+    Combine                    combine,
+    JsonParallelOptions const& options
+) const
+{
+    return reduce(*makePath(path), std::move(identity), std::move(fn), std::move(combine), options);
+}
+
+template<typename T, typename Fn, typename Combine>
+T JsonObject::reduce(
+    JsonKeyPath const&         path,
+    T                          identity,
+    Fn                         fn,
+    Combine                    combine,
+    JsonParallelOptions const& options
+) const
+{
+    auto const&         array = arrayAt(path);
+    std::mutex          partialsMutex;
+    std::map<size_t, T> partials; // by first index of the chunk, so that they are combined in order
+    json_parallel_for(
+        array.size(),
+        [&](size_t begin, size_t end) {
+            T accumulated = identity;
+            for (size_t index = begin; index < end; ++index)
+            {
+                accumulated = fn(std::move(accumulated), array[index]);
+            }
+            std::lock_guard lock{partialsMutex};
+            partials.emplace(begin, std::move(accumulated));
+        },
+        options
+    );
+    for (auto& [begin, partial] : partials)
+    {
+        identity = combine(std::move(identity), std::move(partial));
+    }
+    return identity;
+}
+
+template<typename T>
+JsonColumn<T> JsonObject::column(std::string_view arrayPath, std::string_view fieldPath) const
+{
+    return column<T>(*makePath(arrayPath), fieldPath.empty() ? JsonKeyPath{} : *makePath(fieldPath));
+}
+
+template<typename T>
+JsonColumn<T> JsonObject::column(JsonKeyPath const& arrayPath, JsonKeyPath const& fieldPath) const
+{
+    return JsonColumn<T>::extract(arrayAt(arrayPath), fieldPath);
+}
+
+template<std::output_iterator<char const&> Out>
+    requires(!std::is_pointer_v<Out>)
+Out JsonObject::serializeTo(Out out, size_t indent) const
+{
+    size_t written = 0;
+    serializeChunks(indent, [&out, &written](std::string_view piece) {
+        out = std::ranges::copy(piece, std::move(out)).out;
+        written += piece.size();
+    });
+    JSONOBJECT_METRICS_ADD(JsonCounter::bytesSerialized, written);
+    return out;
+}
+
+template<typename T>
+T JsonCursor::get(JsonKeyPath const& path) const
+{
+    JSONOBJECT_METRICS_SCOPE(JsonOperation::get);
+    if constexpr (is_optional_v<T>)
+    {
+        value_type const* found = find(path, true);
+        return found == nullptr ? T{} : value_as<T>(*found);
+    }
+    else
+    {
+        return value_as<T>(*find(path, false));
+    }
+}
+
+template<typename T>
+T JsonCursor::get(std::string_view path) const
+{
+    return get<T>(*object_->makePath(path));
+}
+
+template<typename T>
+T JsonCursor::get(JsonKeyPath const& path, std::type_identity_t<T> const& defaultValue) const
+{
+    JSONOBJECT_METRICS_SCOPE(JsonOperation::get);
+    value_type const* found = find(path, true);
+    if (found == nullptr)
+    {
+        JSONOBJECT_METRICS_ADD(JsonCounter::defaultFallbacks, 1);
+        return defaultValue;
+    }
+    return value_as<T>(*found);
+}
+
+template<typename T>
+T JsonCursor::get(std::string_view path, std::type_identity_t<T> const& defaultValue) const
+{
+    return get<T>(*object_->makePath(path), defaultValue);
+}
+
 } // namespace util
 
+#if defined(__cpp_lib_format)
+/**
+ * Formats a JsonObject as JsonObject::toString() does: "{}" with an indentation of 4, "{:0}" compact and "{:N}" with an
+ * indentation of N spaces.
+ */
+template<>
+struct std::formatter<util::JsonObject>
+{
+    size_t indent = 4;
+
+    constexpr auto parse(std::format_parse_context& ctx)
+    {
+        auto it = ctx.begin();
+        if (it != ctx.end() && *it >= '0' && *it <= '9')
+        {
+            indent = 0;
+            for (; it != ctx.end() && *it >= '0' && *it <= '9'; ++it)
+            {
+                indent = indent * 10 + static_cast<size_t>(*it - '0');
+            }
+        }
+        if (it != ctx.end() && *it != '}')
+        {
+            throw std::format_error("JsonObject format spec is an indentation width");
+        }
+        return it;
+    }
+
+    template<typename FormatContext>
+    auto format(util::JsonObject const& object, FormatContext& ctx) const
+    {
+        return object.serializeTo(ctx.out(), indent);
+    }
+};
+#endif
+
 #endif // NS_UTIL_JSON_OBJECT_H_INCLUDED
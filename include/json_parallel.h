@@ -0,0 +1,71 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   include/json_parallel.h
+ * Description: chunked parallel loops over array elements
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_JSON_PARALLEL_H_INCLUDED
+#define NS_UTIL_JSON_PARALLEL_H_INCLUDED
+
+#include "json_thread_pool.h"
+
+#include <cstddef>
+#include <functional>
+
+namespace util
+{
+/**
+ * Options of the parallel array operations of JsonObject.
+ */
+struct JsonParallelOptions
+{
+    /// pool whose workers help; nullptr means JsonThreadPool::shared()
+    JsonThreadPool *pool = nullptr;
+
+    /// elements per chunk; 0 picks about eight chunks per worker, but at least minChunkSize elements
+    size_t chunkSize = 0;
+
+    /// arrays with fewer elements are processed on the calling thread only
+    size_t minParallelSize = 4096;
+
+    /// set if the memory resource of the document may allocate from several threads at once; the default resource
+    /// always can. JsonObject::transform() runs serially otherwise, as the new values are allocated from it.
+    bool storageThreadSafe = false;
+
+    static constexpr size_t minChunkSize = 256;
+};
+
+/**
+ * @brief Run body over [0, count) in chunks, on the calling thread and the workers of the pool.
+ * Chunks are handed out from a shared counter, so threads that finish early take over the remaining work. The calling
+ * thread always takes part and does not wait for workers that have not started yet, so the call cannot deadlock when
+ * the pool is busy, also not when it is made from one of its workers.
+ * @param count number of elements
+ * @param body called with the half-open range [begin, end) of each chunk, possibly from several threads at once
+ * @param options the pool and the chunking
+ * @throws the first exception thrown by body; the remaining chunks are then skipped
+ */
+void json_parallel_for(size_t count, std::function<void(size_t, size_t)> const &body, JsonParallelOptions const &options);
+
+} // namespace util
+
+#endif // NS_UTIL_JSON_PARALLEL_H_INCLUDED
@@ -0,0 +1,99 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   include/json_projection.h
+ * Description: parse only selected paths of a json text
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_JSON_PROJECTION_H_INCLUDED
+#define NS_UTIL_JSON_PROJECTION_H_INCLUDED
+
+#include "json_key_path.h"
+#include "json_types.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace util
+{
+/**
+ * A set of key-paths compiled into a tree, for parsing only the parts of a json text that the paths address.
+ * Values outside the paths are skipped by matching braces and brackets: their strings are not unescaped, their numbers
+ * not converted and nothing is allocated for them. Values at the paths are parsed completely.
+ * <br>The result has the shape of the full document along the paths: objects hold only the selected members, arrays
+ * keep the positions of the selected elements, unselected positions before them being null. A path that does not
+ * exist in the text, or that does not fit its containers, selects nothing; containers in which nothing was selected are
+ * left out. A path that is a prefix of another selects its whole value.
+ * <br>Syntax errors inside skipped values are only detected as far as needed to find the end of the value.
+ */
+class JsonProjection
+{
+  public:
+    /**
+     * @brief Compile the paths; the empty path selects the whole document.
+     * @param paths the paths to keep
+     */
+    explicit JsonProjection(std::span<JsonKeyPath const> paths);
+
+    /**
+     * @brief Parse the selected paths of a json text.
+     * @param text the json text
+     * @param storage memory resource for the result
+     * @return the projected document; an empty object if nothing was selected
+     * @throws std::invalid_argument when the text is not valid json
+     */
+    [[nodiscard]] value_type parse(std::string_view text, storage_type storage = {}) const;
+
+    /**
+     * @brief Parse the selected paths of a json file. The file is mapped into memory, not read into a buffer.
+     * @param filename name of the file
+     * @param storage memory resource for the result
+     * @return the projected document; an empty object if nothing was selected
+     * @throws std::invalid_argument when the file cannot be read or is not valid json
+     */
+    [[nodiscard]] value_type parseFile(std::string const &filename, storage_type storage = {}) const;
+
+  private:
+    static constexpr uint32_t npos = static_cast<uint32_t>(-1);
+
+    struct Node
+    {
+        bool                                          whole = false; ///< select the complete value
+        std::vector<std::pair<std::string, uint32_t>> members;       ///< sorted by key
+        std::vector<std::pair<size_t, uint32_t>>      elements;      ///< sorted by index
+        uint32_t                                      last = npos;   ///< child for [$]
+    };
+
+    class Scanner;
+
+    std::vector<Node> nodes_;
+
+    uint32_t child(uint32_t parent, JsonKey const &key);
+};
+
+} // namespace util
+
+#endif // NS_UTIL_JSON_PROJECTION_H_INCLUDED
@@ -0,0 +1,172 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   include/json_schema.h
+ * Description: precompiled json schema validator
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_JSON_SCHEMA_H_INCLUDED
+#define NS_UTIL_JSON_SCHEMA_H_INCLUDED
+
+#include "json_key_path.h"
+#include "json_types.h"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace util
+{
+/**
+ * A single failed check of a schema.
+ */
+struct JsonSchemaViolation
+{
+    JsonKeyPath path;    ///< location of the failing value; truncated at keys that cannot be expressed as JsonKeyPath
+    std::string message; ///< description of the failed check
+};
+
+/**
+ * A json schema compiled into a flat check program.
+ * Supported keywords: type, enum, const, minimum, maximum, exclusiveMinimum, exclusiveMaximum, multipleOf,
+ * minLength, maxLength, pattern, items, prefixItems, minItems, maxItems, uniqueItems, properties, required,
+ * additionalProperties, minProperties, maxProperties, allOf, anyOf, oneOf, not, $ref (local json pointers),
+ * $defs and definitions. Other keywords are ignored, as the specification requires for unknown keywords.
+ * <br>Property names are interned once per schema and required properties are checked with precomputed bitsets, so
+ * validating an object is a single pass over its members.
+ */
+class JsonSchema
+{
+  public:
+    /**
+     * @brief Compile a schema.
+     * @param schema the schema document
+     * @throws std::invalid_argument when the schema is malformed or a $ref cannot be resolved
+     */
+    explicit JsonSchema(value_type const &schema);
+
+    /**
+     * @brief Compile a schema from its json text.
+     * @param schemaStr the schema document as string
+     * @throws std::invalid_argument when the schema is malformed or a $ref cannot be resolved
+     */
+    explicit JsonSchema(std::string const &schemaStr);
+
+    /**
+     * @brief Compile a schema from its json text.
+     * @param schemaStr the schema document as string
+     * @throws std::invalid_argument when the schema is malformed or a $ref cannot be resolved
+     */
+    explicit JsonSchema(char const *schemaStr);
+
+    /**
+     * @brief Check whether a value conforms to the schema; stops at the first failed check. Failed checks do not build
+     * messages, so the only allocations are std::regex_search for patterns and the seen-bits of objects whose schema
+     * lists more than 64 properties.
+     * @param value the value to check
+     * @return true if valid, false otherwise
+     */
+    [[nodiscard]] bool isValid(value_type const &value) const;
+
+    /**
+     * @brief Validate a value and collect all violations.
+     * @param value the value to check
+     * @return list of violations, empty if the value is valid
+     */
+    [[nodiscard]] std::vector<JsonSchemaViolation> validate(value_type const &value) const;
+
+  private:
+    static constexpr uint32_t npos = static_cast<uint32_t>(-1);
+
+    struct Property
+    {
+        uint32_t name;   ///< interned property name
+        uint32_t schema; ///< node index, npos for "anything"
+    };
+
+    struct Node
+    {
+        bool                        alwaysFalse = false;
+        uint8_t                     typeMask    = 0; ///< 0: any type
+        std::vector<value_type>     enumValues;
+        bool                        hasEnum = false;
+        std::optional<double>       minimum;
+        std::optional<double>       maximum;
+        std::optional<double>       exclusiveMinimum;
+        std::optional<double>       exclusiveMaximum;
+        std::optional<double>       multipleOf;
+        std::optional<size_t>       minLength;
+        std::optional<size_t>       maxLength;
+        std::shared_ptr<std::regex> pattern;
+        std::string                 patternSource;
+        std::vector<uint32_t>       prefixItems;
+        uint32_t                    items = npos;
+        std::optional<size_t>       minItems;
+        std::optional<size_t>       maxItems;
+        bool                        uniqueItems = false;
+        std::vector<Property>       properties; ///< sorted by interned name
+        std::vector<uint64_t>       required;   ///< bitset over properties
+        bool                        additionalAllowed = true;
+        uint32_t                    additional        = npos;
+        std::optional<size_t>       minProperties;
+        std::optional<size_t>       maxProperties;
+        std::vector<uint32_t>       allOf;
+        std::vector<uint32_t>       anyOf;
+        std::vector<uint32_t>       oneOf;
+        uint32_t                    not_ = npos;
+    };
+
+    struct StringHash
+    {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view str) const
+        {
+            return std::hash<std::string_view>{}(str);
+        }
+    };
+
+    struct Context;
+
+    value_type                                                               document_;
+    std::vector<Node>                                                        nodes_;
+    std::vector<std::string>                                                 names_;
+    std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>>   nameIds_;
+    std::unordered_map<std::string, uint32_t>                                refs_;
+    uint32_t                                                                 root_ = npos;
+
+    uint32_t compile(value_type const &schema);
+    uint32_t compileRef(std::string const &ref);
+    uint32_t intern(std::string_view name);
+    bool     check(uint32_t node, value_type const &value, Context &ctx) const;
+    bool     checkObject(Node const &node, object_type const &obj, Context &ctx) const;
+    bool     checkArray(Node const &node, array_type const &arr, Context &ctx) const;
+};
+
+} // namespace util
+
+#endif // NS_UTIL_JSON_SCHEMA_H_INCLUDED
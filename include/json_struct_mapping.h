@@ -0,0 +1,326 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   include/json_struct_mapping.h
+ * Description: compile-time mapping of C++ structs to json key paths, with direct parsing and serialization
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_JSON_STRUCT_MAPPING_H_INCLUDED
+#define NS_UTIL_JSON_STRUCT_MAPPING_H_INCLUDED
+
+#include "json_types.h"
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace util
+{
+/**
+ * Describes where a member of struct S lives in a json document.
+ */
+template<typename S, typename M>
+struct JsonField
+{
+    std::string_view path;
+    M S::           *member;
+};
+
+/**
+ * @brief Describe a mapped member; use in the fields-tuple of a JsonMapping specialisation.
+ * @param path key-path of the member, using the same syntax as JsonKeyPath; [$] is not allowed
+ * @param member pointer to the member
+ * @return the field description
+ */
+template<typename S, typename M>
+constexpr JsonField<S, M> jsonField(std::string_view path, M S::*member)
+{
+    return JsonField<S, M>{path, member};
+}
+
+/**
+ * Mapping of a struct to json, to be specialised for each mapped struct, for example:
+ * <pre>
+ * template<>
+ * struct util::JsonMapping<Point>
+ * {
+ *     static constexpr auto fields = std::make_tuple(
+ *         util::jsonField("pos/x", &Point::x),
+ *         util::jsonField("pos/y", &Point::y),
+ *         util::jsonField("label", &Point::label)
+ *     );
+ * };
+ * </pre>
+ * Members can be bool, arithmetic, std::string, or std::optional of these.
+ */
+template<typename S>
+struct JsonMapping;
+
+/**
+ * A scalar as delivered by the parser. Strings are views into the parser buffers and are only valid during the call.
+ */
+struct JsonScalar
+{
+    value_type       value{};  ///< null, bool or number; never allocates
+    std::string_view text{};   ///< string content, if isString is set
+    bool             isString = false;
+};
+
+using JsonFieldSetter = void (*)(void *target, JsonScalar const &scalar);
+using JsonFieldWriter = void (*)(void const *source, std::string &out);
+
+/**
+ * Compiled form of a set of field paths: a trie over the key-path segments, used for matching while parsing and
+ * for emitting the document structure while serializing.
+ */
+class JsonStructLayout
+{
+  public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    struct Node
+    {
+        std::vector<std::pair<std::string, size_t>> keyChildren;
+        std::vector<std::pair<size_t, size_t>>      indexChildren;
+        size_t                                      field = npos;
+    };
+
+    /**
+     * @brief Compile the layout.
+     * @param paths key-paths of the fields, in field order
+     * @throws std::invalid_argument when a path is invalid, uses [$], is duplicated, is the prefix of another path, or
+     *                               when a container would have to be both an object and an array
+     */
+    explicit JsonStructLayout(std::span<std::string_view const> paths);
+
+    [[nodiscard]] size_t                   fieldCount() const;
+    [[nodiscard]] std::vector<Node> const &nodes() const;
+    [[nodiscard]] size_t                   keyChild(size_t node, std::string_view key) const;
+    [[nodiscard]] size_t                   indexChild(size_t node, size_t index) const;
+
+  private:
+    std::vector<Node> nodes_;
+    size_t            fieldCount_ = 0;
+};
+
+/**
+ * @brief Parse json text and deliver the mapped scalars to the setters; unmapped subtrees are skipped without
+ *        building any values.
+ * @param json json text
+ * @param layout compiled layout
+ * @param setters one setter per field of the layout
+ * @param target opaque pointer handed to the setters
+ * @throws std::invalid_argument when the text is not valid json, when a container is found where a mapped scalar is
+ *                               expected, or when a setter rejects a value
+ */
+void parse_struct(
+    std::string_view                   json,
+    JsonStructLayout const            &layout,
+    std::span<JsonFieldSetter const>   setters,
+    void                              *target
+);
+
+/**
+ * @brief Write the json text for the mapped fields. Gaps in mapped arrays are filled with null.
+ * @param layout compiled layout
+ * @param writers one writer per field of the layout
+ * @param source opaque pointer handed to the writers
+ * @return compact json text
+ */
+std::string
+    serialize_struct(JsonStructLayout const &layout, std::span<JsonFieldWriter const> writers, void const *source);
+
+/**
+ * @brief Append a string as quoted and escaped json string.
+ * @param out string to append to
+ * @param str the raw string
+ */
+void append_json_string(std::string &out, std::string_view str);
+
+template<typename M>
+void assign_json_scalar(M &member, JsonScalar const &scalar)
+{
+    if (scalar.isString)
+    {
+        if constexpr (std::same_as<M, std::string>)
+        {
+            member.assign(scalar.text);
+        }
+        else if constexpr (is_optional_v<M>)
+        {
+            if constexpr (std::same_as<typename M::value_type, std::string>)
+            {
+                member.emplace(scalar.text);
+            }
+            else
+            {
+                throw std::invalid_argument("json value is a string");
+            }
+        }
+        else
+        {
+            throw std::invalid_argument("json value is a string");
+        }
+    }
+    else
+    {
+        member = value_as<M>(scalar.value);
+    }
+}
+
+template<typename M>
+void append_json_scalar(std::string &out, M const &member)
+{
+    if constexpr (is_optional_v<M>)
+    {
+        if (!member)
+        {
+            out += "null";
+        }
+        else
+        {
+            append_json_scalar(out, *member);
+        }
+    }
+    else if constexpr (std::same_as<M, bool>)
+    {
+        out += member ? "true" : "false";
+    }
+    else if constexpr (std::is_arithmetic_v<M>)
+    {
+        if constexpr (std::is_floating_point_v<M>)
+        {
+            if (!std::isfinite(member))
+            {
+                out += "null";
+                return;
+            }
+        }
+        std::array<char, 32> buf{};
+        auto [ptr, ec] = std::to_chars(buf.data(), buf.data() + buf.size(), member);
+        out.append(buf.data(), ptr);
+    }
+    else
+    {
+        static_assert(std::is_convertible_v<M const &, std::string_view>, "unsupported member type for JsonMapping");
+        append_json_string(out, member);
+    }
+}
+
+template<typename S, size_t I>
+void set_json_field(void *target, JsonScalar const &scalar)
+{
+    constexpr auto field = std::get<I>(JsonMapping<S>::fields);
+    assign_json_scalar(static_cast<S *>(target)->*field.member, scalar);
+}
+
+template<typename S, size_t I>
+void write_json_field(void const *source, std::string &out)
+{
+    constexpr auto field = std::get<I>(JsonMapping<S>::fields);
+    append_json_scalar(out, static_cast<S const *>(source)->*field.member);
+}
+
+/**
+ * Per-struct compiled mapping, built once on first use.
+ */
+template<typename S>
+struct JsonStructMapping
+{
+    static constexpr size_t size = std::tuple_size_v<std::remove_cvref_t<decltype(JsonMapping<S>::fields)>>;
+
+    std::array<std::string_view, size> paths;
+    std::array<JsonFieldSetter, size>  setters;
+    std::array<JsonFieldWriter, size>  writers;
+    JsonStructLayout                   layout;
+
+    JsonStructMapping()
+        : JsonStructMapping(std::make_index_sequence<size>{})
+    {
+    }
+
+    static JsonStructMapping const &instance()
+    {
+        static JsonStructMapping const mapping;
+        return mapping;
+    }
+
+  private:
+    template<size_t... I>
+    explicit JsonStructMapping(std::index_sequence<I...> /*unused*/)
+        : paths{std::get<I>(JsonMapping<S>::fields).path...}
+        , setters{&set_json_field<S, I>...}
+        , writers{&write_json_field<S, I>...}
+        , layout(paths)
+    {
+    }
+};
+
+/**
+ * @brief Parse json text directly into a mapped struct, without building a JsonObject.
+ * Members whose path is not present in the text keep their previous values.
+ * @param json json text
+ * @param target struct to fill
+ * @throws std::invalid_argument see parse_struct()
+ */
+template<typename S>
+void struct_from_json(std::string_view json, S &target)
+{
+    auto const &mapping = JsonStructMapping<S>::instance();
+    parse_struct(json, mapping.layout, mapping.setters, &target);
+}
+
+/**
+ * @brief Parse json text directly into a value-initialised mapped struct.
+ * @param json json text
+ * @return the filled struct
+ * @throws std::invalid_argument see parse_struct()
+ */
+template<typename S>
+S struct_from_json(std::string_view json)
+{
+    S target{};
+    struct_from_json(json, target);
+    return target;
+}
+
+/**
+ * @brief Serialize a mapped struct to compact json text.
+ * @param source the struct
+ * @return json text
+ */
+template<typename S>
+std::string struct_to_json(S const &source)
+{
+    auto const &mapping = JsonStructMapping<S>::instance();
+    return serialize_struct(mapping.layout, mapping.writers, &source);
+}
+
+} // namespace util
+
+#endif // NS_UTIL_JSON_STRUCT_MAPPING_H_INCLUDED
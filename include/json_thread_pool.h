@@ -0,0 +1,89 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   include/json_thread_pool.h
+ * Description: small thread pool for background json work
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_JSON_THREAD_POOL_H_INCLUDED
+#define NS_UTIL_JSON_THREAD_POOL_H_INCLUDED
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace util
+{
+/**
+ * Fixed-size pool of worker threads running tasks in submission order.
+ */
+class JsonThreadPool
+{
+  public:
+    using Task = std::move_only_function<void()>;
+
+    /**
+     * @brief Start the workers.
+     * @param threads number of workers; 0 means one per hardware thread
+     */
+    explicit JsonThreadPool(size_t threads = 0);
+
+    JsonThreadPool(JsonThreadPool const &)            = delete;
+    JsonThreadPool &operator=(JsonThreadPool const &) = delete;
+
+    /**
+     * @brief Run the tasks still queued, then stop the workers.
+     */
+    ~JsonThreadPool();
+
+    /**
+     * @brief Queue a task. Tasks must not throw; an escaping exception terminates the program.
+     * @param task the task
+     */
+    void submit(Task task);
+
+    /**
+     * @brief Number of workers.
+     */
+    [[nodiscard]] size_t size() const;
+
+    /**
+     * @brief Process-wide pool with one worker per hardware thread, for callers that do not bring their own.
+     */
+    static JsonThreadPool &shared();
+
+  private:
+    std::mutex                mutex_;
+    std::condition_variable   available_;
+    std::deque<Task>          tasks_;
+    bool                      stopping_ = false;
+    std::vector<std::jthread> workers_;
+
+    void run();
+};
+
+} // namespace util
+
+#endif // NS_UTIL_JSON_THREAD_POOL_H_INCLUDED
@@ -0,0 +1,184 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   include/json_traversal.h
+ * Description: non-recursive depth-first traversal of json values
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#ifndef NS_UTIL_JSON_TRAVERSAL_H_INCLUDED
+#define NS_UTIL_JSON_TRAVERSAL_H_INCLUDED
+
+#include "json_key_path.h"
+#include "json_types.h"
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace util
+{
+/**
+ * Kind of step of a traversal.
+ */
+enum class JsonVisitEvent : uint8_t
+{
+    enter, ///< an object or array is opened; its members follow unless skipped
+    leave, ///< an object or array is closed
+    value  ///< a scalar
+};
+
+/**
+ * What a visitor wants to happen after a step.
+ */
+enum class JsonVisitAction : uint8_t
+{
+    proceed,
+    skipChildren, ///< after an enter step: continue with the matching leave step
+    stop
+};
+
+/**
+ * One segment of the path to a node: the key of an object member or the index of an array element.
+ */
+struct JsonPathSegment
+{
+    std::string_view key{};      ///< key of the member, a view into the document; empty for array elements
+    size_t           index = 0;  ///< position in the parent container, also for object members
+    bool             isIndex = false;
+};
+
+/**
+ * @brief Convert path segments to a JsonKeyPath; allocates.
+ * @param path the segments, from the root
+ * @return the key-path
+ * @throws std::invalid_argument when a key cannot be expressed as a string-key of a JsonKeyPath
+ */
+JsonKeyPath to_key_path(std::span<JsonPathSegment const> path);
+
+/**
+ * Depth-first walk over a json value with an explicit stack, so the depth of a document is limited only by memory.
+ * Every object and array is reported by an enter and a leave step, every scalar by a value step; the path to the
+ * current node is updated incrementally and does not allocate once the stack has grown to the maximal depth.
+ * <br>The value must not be changed during the traversal.
+ * <pre>
+ * for (JsonTraversal walk{root}; walk.next();)
+ * {
+ *     if (walk.event() == JsonVisitEvent::enter && walk.depth() == 2) walk.skip();
+ * }
+ * </pre>
+ */
+class JsonTraversal
+{
+  public:
+    /**
+     * @brief Prepare a traversal; the first call to next() goes to root.
+     */
+    explicit JsonTraversal(value_type const &root);
+
+    /**
+     * @brief Go to the next step.
+     * @return false when the traversal is complete
+     */
+    bool next();
+
+    /**
+     * @brief After an enter step: skip the members, so that the next step is the matching leave step.
+     */
+    void skip();
+
+    [[nodiscard]] JsonVisitEvent    event() const;
+    [[nodiscard]] value_type const &value() const;
+
+    /**
+     * @brief Number of containers around the current node; 0 for the root.
+     */
+    [[nodiscard]] size_t depth() const;
+
+    /**
+     * @brief Path from the root to the current node, one segment per level; valid until the next step.
+     */
+    [[nodiscard]] std::span<JsonPathSegment const> path() const;
+
+    /**
+     * @brief Path to the current node as JsonKeyPath; allocates.
+     * @throws std::invalid_argument when a key cannot be expressed as a string-key of a JsonKeyPath
+     */
+    [[nodiscard]] JsonKeyPath keyPath() const;
+
+  private:
+    struct Frame
+    {
+        value_type const *node;
+        size_t            size;
+        size_t            next = 0;
+    };
+
+    value_type const            *root_;
+    value_type const            *current_ = nullptr;
+    JsonVisitEvent               event_   = JsonVisitEvent::value;
+    bool                         started_ = false;
+    std::vector<Frame>           stack_;
+    std::vector<JsonPathSegment> path_;
+
+    void arrive(value_type const &node);
+};
+
+/**
+ * Visitor that a JsonTraversal is driven with.
+ */
+template<typename Visitor>
+concept JsonVisitor = std::invocable<Visitor &, JsonTraversal const &>
+                      && std::same_as<std::invoke_result_t<Visitor &, JsonTraversal const &>, JsonVisitAction>;
+
+/**
+ * @brief Walk a value depth-first without recursion.
+ * @param root the value to walk
+ * @param visitor called for each step, returns whether to proceed, skip the members of an entered container or stop
+ * @return false if the visitor stopped the traversal
+ */
+template<JsonVisitor Visitor>
+bool json_visit(value_type const &root, Visitor &&visitor)
+{
+    for (JsonTraversal walk{root}; walk.next();)
+    {
+        switch (visitor(static_cast<JsonTraversal const &>(walk)))
+        {
+            case JsonVisitAction::proceed:
+                break;
+            case JsonVisitAction::skipChildren:
+                if (walk.event() == JsonVisitEvent::enter)
+                {
+                    walk.skip();
+                }
+                break;
+            case JsonVisitAction::stop:
+                return false;
+        }
+    }
+    return true;
+}
+
+} // namespace util
+
+#endif // NS_UTIL_JSON_TRAVERSAL_H_INCLUDED
@@ -28,10 +28,21 @@
 #ifndef NS_UTIL_JSON_TYPES_H_INCLUDED
 #define NS_UTIL_JSON_TYPES_H_INCLUDED
 
+#include "json_error.h"
+
 #include <boost/json.hpp>
 #include <boost/json/kind.hpp>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <expected>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <type_traits>
 #include <utility>
 
 namespace util
@@ -63,13 +74,24 @@ enum class kind : unsigned char
     /// An @ref object.
     object = std::to_underlying(boost::json::kind::object)
 };
-using key_type    = boost::json::string_view;
-using value_type  = boost::json::value;
-using object_type = boost::json::object;
-using array_type  = boost::json::array;
-using json_error  = boost::system::error_code;
+using key_type     = boost::json::string_view;
+using value_type   = boost::json::value;
+using object_type  = boost::json::object;
+using array_type   = boost::json::array;
+using json_error   = boost::system::error_code;
+using storage_type = boost::json::storage_ptr;
+
+/**
+ * @brief View a raw character buffer, e.g. a received network frame, as json text without copying it.
+ * @param buffer the characters; a trailing NUL is not stripped
+ * @return a view of the buffer that can be passed to every std::string_view overload
+ */
+inline std::string_view as_json_text(std::span<char const> buffer)
+{
+    return {buffer.data(), buffer.size()};
+}
 
-inline value_type json_parse(std::string const &jstr)
+inline value_type json_parse(std::string_view jstr)
 {
     return boost::json::parse(jstr);
 }
@@ -84,11 +106,21 @@ inline void array_prepend(array_type &arr, value_type const &value)
     arr.insert(arr.begin(), value);
 }
 
+inline void array_prepend(array_type &arr, value_type &&value)
+{
+    arr.insert(arr.begin(), std::move(value));
+}
+
 inline void array_append(array_type &arr, value_type const &value)
 {
     arr.insert(arr.end(), value);
 }
 
+inline void array_append(array_type &arr, value_type &&value)
+{
+    arr.push_back(std::move(value));
+}
+
 inline void array_resize(array_type &arr, size_t newSize)
 {
     arr.resize(newSize);
@@ -99,11 +131,16 @@ inline size_t array_size(array_type const &arr)
     return arr.size();
 }
 
-inline value_type from_json_string(std::string const &json_str)
+inline value_type from_json_string(std::string_view json_str)
 {
     return boost::json::parse(json_str);
 }
 
+inline value_type from_json_string(std::string_view json_str, storage_type storage)
+{
+    return boost::json::parse(json_str, std::move(storage));
+}
+
 inline std::string to_json_string(value_type const &json_val)
 {
     return boost::json::serialize(json_val);
@@ -229,6 +266,174 @@ inline object_type const *as_object(value_type const *val)
     return &val->as_object();
 }
 
+template<typename T>
+struct is_optional : std::false_type
+{
+};
+
+template<typename T>
+struct is_optional<std::optional<T>> : std::true_type
+{
+};
+
+template<typename T>
+inline constexpr bool is_optional_v = is_optional<T>::value;
+
+namespace detail
+{
+template<typename T>
+constexpr char const *expected_kind_text()
+{
+    if constexpr (is_optional_v<T>)
+    {
+        return expected_kind_text<typename T::value_type>();
+    }
+    else if constexpr (std::same_as<T, bool>)
+    {
+        return "json value is not a bool";
+    }
+    else if constexpr (std::integral<T> || std::floating_point<T>)
+    {
+        return "json value is not a number";
+    }
+    else
+    {
+        return "json value is not a string";
+    }
+}
+} // namespace detail
+
+/**
+ * @brief Convert a json value to the requested C++ type directly, without copying the value first and without
+ * throwing on a failed conversion.
+ * @param val the value to convert
+ * @return the converted value, json_errc::type_mismatch when the kind of the value is incompatible with T, or
+ *         json_errc::out_of_range when a numeric value cannot be represented exactly in T
+ * @see value_as()
+ */
+template<typename T>
+std::expected<T, json_errc> try_value_as(value_type const &val)
+{
+    if constexpr (is_optional_v<T>)
+    {
+        if (val.is_null())
+        {
+            return T{};
+        }
+        auto inner = try_value_as<typename T::value_type>(val);
+        if (!inner)
+        {
+            return std::unexpected(inner.error());
+        }
+        return T{std::move(*inner)};
+    }
+    else if constexpr (std::same_as<T, value_type>)
+    {
+        return val;
+    }
+    else if constexpr (std::same_as<T, bool>)
+    {
+        if (!val.is_bool())
+        {
+            return std::unexpected(json_errc::type_mismatch);
+        }
+        return val.get_bool();
+    }
+    else if constexpr (std::integral<T>)
+    {
+        if (val.is_int64())
+        {
+            if (!std::in_range<T>(val.get_int64()))
+            {
+                return std::unexpected(json_errc::out_of_range);
+            }
+            return static_cast<T>(val.get_int64());
+        }
+        if (val.is_uint64())
+        {
+            if (!std::in_range<T>(val.get_uint64()))
+            {
+                return std::unexpected(json_errc::out_of_range);
+            }
+            return static_cast<T>(val.get_uint64());
+        }
+        if (val.is_double())
+        {
+            double const d = val.get_double();
+            // compare against max + 1: for 64-bit types max itself is not representable as a double
+            if (std::trunc(d) != d || d < static_cast<double>(std::numeric_limits<T>::min()) ||
+                d >= static_cast<double>(std::numeric_limits<T>::max()) + 1.0)
+            {
+                return std::unexpected(json_errc::out_of_range);
+            }
+            return static_cast<T>(d);
+        }
+        return std::unexpected(json_errc::type_mismatch);
+    }
+    else if constexpr (std::floating_point<T>)
+    {
+        double d{};
+        if (val.is_double())
+        {
+            d = val.get_double();
+        }
+        else if (val.is_int64())
+        {
+            d = static_cast<double>(val.get_int64());
+        }
+        else if (val.is_uint64())
+        {
+            d = static_cast<double>(val.get_uint64());
+        }
+        else
+        {
+            return std::unexpected(json_errc::type_mismatch);
+        }
+        if (std::isfinite(d) && std::abs(d) > static_cast<double>(std::numeric_limits<T>::max()))
+        {
+            return std::unexpected(json_errc::out_of_range);
+        }
+        return static_cast<T>(d);
+    }
+    else if constexpr (std::same_as<T, std::string_view> || std::same_as<T, std::string>)
+    {
+        if (!val.is_string())
+        {
+            return std::unexpected(json_errc::type_mismatch);
+        }
+        auto const &str = val.get_string();
+        return T{str.data(), str.size()};
+    }
+    else
+    {
+        static_assert(sizeof(T) == 0, "try_value_as: unsupported target type");
+    }
+}
+
+/**
+ * @brief Convert a json value to the requested C++ type directly, without copying the value first.
+ * Supported targets are bool, all arithmetic types, std::string_view (a view into the value, which must outlive it),
+ * std::string, std::optional<T> of any of these (null converts to std::nullopt) and value_type itself.
+ * @param val the value to convert
+ * @return the converted value
+ * @throws std::invalid_argument when the kind of the value is incompatible with T
+ * @throws std::out_of_range when a numeric value cannot be represented exactly in T
+ */
+template<typename T>
+T value_as(value_type const &val)
+{
+    auto result = try_value_as<T>(val);
+    if (!result)
+    {
+        if (result.error() == json_errc::out_of_range)
+        {
+            throw std::out_of_range("json number cannot be represented exactly in the requested type");
+        }
+        throw std::invalid_argument(detail::expected_kind_text<T>());
+    }
+    return std::move(*result);
+}
+
 } // namespace util
 
 #endif // NS_UTIL_JSON_TYPES_H_INCLUDED
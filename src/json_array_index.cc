@@ -0,0 +1,432 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   src/json_array_index.cc
+ * Description: secondary hash indexes over arrays of objects
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_array_index.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace util
+{
+namespace
+{
+/**
+ * Whether key addresses the same child as indexed, which is a string key or a position.
+ */
+bool sameKey(JsonKey const &key, JsonKey const &indexed)
+{
+    if (key.isIndex() != indexed.isIndex())
+    {
+        return false;
+    }
+    if (!key.isIndex())
+    {
+        return static_cast<JsonStringKey const &>(key).getKey() == static_cast<JsonStringKey const &>(indexed).getKey();
+    }
+    auto const &indexKey = static_cast<JsonIndexKey const &>(key);
+    if (indexKey.isStartSymbol() || indexKey.isEndSymbol() || indexKey.isSelector())
+    {
+        return false;
+    }
+    return indexKey.getIndex(size_t{0}) == static_cast<JsonIndexKey const &>(indexed).getIndex(size_t{0});
+}
+} // namespace
+
+JsonArrayIndexes::JsonArrayIndexes(JsonArrayIndexes const &other)
+{
+    std::lock_guard const lock(other.mutex_);
+    for (auto const &index: other.indexes_)
+    {
+        indexes_.push_back(Index{index.arrayPath, index.field});
+    }
+}
+
+JsonArrayIndexes &JsonArrayIndexes::operator=(JsonArrayIndexes const &other)
+{
+    if (this != &other)
+    {
+        std::scoped_lock const lock(mutex_, other.mutex_);
+        indexes_.clear();
+        for (auto const &index: other.indexes_)
+        {
+            indexes_.push_back(Index{index.arrayPath, index.field});
+        }
+    }
+    return *this;
+}
+
+void JsonArrayIndexes::Index::rebuild(array_type const &array)
+{
+    positions.clear();
+    positions.reserve(array.size());
+    base       = 0;
+    duplicates = false;
+    for (size_t position = 0; position < array.size(); ++position)
+    {
+        add(array, position);
+    }
+    stale = false;
+}
+
+void JsonArrayIndexes::Index::add(array_type const &array, size_t position)
+{
+    auto text = JsonIndexKey::selectorText(array[position], field);
+    if (!text)
+    {
+        return;
+    }
+    int64_t const sequence         = base + static_cast<int64_t>(position);
+    auto const [found, inserted] = positions.try_emplace(std::move(*text), sequence);
+    if (!inserted)
+    {
+        // the first of the elements sharing a text wins, as with a scan
+        duplicates    = true;
+        found->second = std::min(found->second, sequence);
+    }
+}
+
+int64_t JsonArrayIndexes::Index::find(array_type const &array, std::string_view text)
+{
+    for (int attempt = 0; attempt < 2; ++attempt)
+    {
+        if (stale)
+        {
+            rebuild(array);
+        }
+        auto const found = positions.find(text);
+        if (found == positions.end())
+        {
+            return -1;
+        }
+        int64_t const position = found->second - base;
+        // a change that was not reported leaves a wrong position: check it, and rebuild once if it is wrong
+        if (position >= 0 && position < static_cast<int64_t>(array.size()) &&
+            JsonIndexKey::selectorText(array[static_cast<size_t>(position)], field) == text)
+        {
+            return position;
+        }
+        stale = true;
+    }
+    return -1;
+}
+
+bool JsonArrayIndexes::create(value_type const &root, JsonKeyPath const &arrayPath, std::string_view field)
+{
+    for (auto const &key: arrayPath.getKeys())
+    {
+        auto const *indexKey = key->isIndex() ? static_cast<JsonIndexKey const *>(key.get()) : nullptr;
+        if (indexKey != nullptr && (indexKey->isStartSymbol() || indexKey->isEndSymbol() || indexKey->isSelector()))
+        {
+            throw std::invalid_argument(
+                "Indexed array path '" + arrayPath.toString() + "' can only hold string keys and positions"
+            );
+        }
+    }
+    if (!JsonStringKey::isValid(field))
+    {
+        throw std::invalid_argument("Indexed field '" + std::string{field} + "' is not a valid string key");
+    }
+    std::lock_guard const lock(mutex_);
+    auto const            path = arrayPath.toString();
+    if (std::ranges::any_of(
+            indexes_, [&](Index const &index) { return index.field == field && index.arrayPath.toString() == path; }
+        ))
+    {
+        return false;
+    }
+    auto &index = indexes_.emplace_back(Index{arrayPath, std::string{field}});
+    if (auto const *array = locate(root, arrayPath))
+    {
+        index.rebuild(*array);
+    }
+    return true;
+}
+
+bool JsonArrayIndexes::drop(JsonKeyPath const &arrayPath, std::string_view field)
+{
+    std::lock_guard const lock(mutex_);
+    auto const            path  = arrayPath.toString();
+    auto const            found = std::ranges::find_if(
+        indexes_, [&](Index const &index) { return index.field == field && index.arrayPath.toString() == path; }
+    );
+    if (found == indexes_.end())
+    {
+        return false;
+    }
+    indexes_.erase(found);
+    return true;
+}
+
+bool JsonArrayIndexes::empty() const
+{
+    // definitions only change in create() and drop(), which do not run concurrently with the reporting of changes
+    return indexes_.empty();
+}
+
+bool JsonArrayIndexes::covers(Index const &index, KeySpan base, KeySpan prefix)
+{
+    auto const &keys = index.arrayPath.getKeys();
+    if (keys.size() != base.size() + prefix.size())
+    {
+        return false;
+    }
+    for (size_t segment = 0; segment < keys.size(); ++segment)
+    {
+        auto const &key = segment < base.size() ? base[segment] : prefix[segment - base.size()];
+        if (!sameKey(*key, *keys[segment]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+array_type const *JsonArrayIndexes::locate(value_type const &root, JsonKeyPath const &arrayPath)
+{
+    value_type const *current = &root;
+    for (auto const &key: arrayPath.getKeys())
+    {
+        if (key->isIndex())
+        {
+            auto const idx = static_cast<JsonIndexKey const *>(key.get())->getIndex(size_t{0});
+            if (!current->is_array() || idx >= static_cast<int64_t>(current->get_array().size()))
+            {
+                return nullptr;
+            }
+            current = &current->get_array()[static_cast<size_t>(idx)];
+        }
+        else
+        {
+            current = current->is_object()
+                          ? current->get_object().if_contains(static_cast<JsonStringKey const *>(key.get())->getKey())
+                          : nullptr;
+            if (current == nullptr)
+            {
+                return nullptr;
+            }
+        }
+    }
+    return current->is_array() ? &current->get_array() : nullptr;
+}
+
+int64_t JsonArrayIndexes::resolve(KeySpan base, KeySpan prefix, JsonIndexKey const &key, array_type const &array) const
+{
+    if (!key.isSelector())
+    {
+        return key.getIndex(array);
+    }
+    std::lock_guard const lock(mutex_);
+    return resolveLocked(base, prefix, key, array);
+}
+
+int64_t
+    JsonArrayIndexes::resolveLocked(KeySpan base, KeySpan prefix, JsonIndexKey const &key, array_type const &array) const
+{
+    if (key.isSelector())
+    {
+        for (auto &index: indexes_)
+        {
+            if (index.field == key.selectorField() && covers(index, base, prefix))
+            {
+                return index.find(array, key.selectorValue());
+            }
+        }
+    }
+    return key.getIndex(array);
+}
+
+std::optional<JsonArrayIndexes::Change> JsonArrayIndexes::classify(
+    Index const       &index,
+    value_type const  &root,
+    JsonKeyPath const &path,
+    JsonArrayEdit      edit
+) const
+{
+    auto const &arrayKeys = index.arrayPath.getKeys();
+    auto const &keys      = path.getKeys();
+    Change      change{};
+    for (size_t segment = 0; segment < std::min(arrayKeys.size(), keys.size()); ++segment)
+    {
+        auto const &key = *keys[segment];
+        if (!arrayKeys[segment]->isIndex() && !key.isIndex())
+        {
+            if (static_cast<JsonStringKey const &>(key).getKey() !=
+                static_cast<JsonStringKey const *>(arrayKeys[segment].get())->getKey())
+            {
+                return std::nullopt;
+            }
+        }
+        else if (arrayKeys[segment]->isIndex() && key.isIndex())
+        {
+            auto const &indexKey = static_cast<JsonIndexKey const &>(key);
+            if (indexKey.isStartSymbol() || indexKey.isEndSymbol() || indexKey.isSelector())
+            {
+                // the change may shift or hit the element on the indexed path
+                return change;
+            }
+            if (!sameKey(key, *arrayKeys[segment]))
+            {
+                return std::nullopt;
+            }
+        }
+        else
+        {
+            // a forced change may replace a container on the indexed path
+            return change;
+        }
+    }
+    if (keys.size() < arrayKeys.size())
+    {
+        return change;
+    }
+    change.array = locate(root, index.arrayPath);
+    if (change.array == nullptr)
+    {
+        return change;
+    }
+    change.size = change.array->size();
+    if (keys.size() == arrayKeys.size())
+    {
+        if (edit == JsonArrayEdit::append || edit == JsonArrayEdit::prepend)
+        {
+            change.kind = edit == JsonArrayEdit::append ? Change::Kind::append : Change::Kind::prepend;
+        }
+        return change;
+    }
+    if (!keys[arrayKeys.size()]->isIndex())
+    {
+        return change;
+    }
+    auto const &elementKey = static_cast<JsonIndexKey const &>(*keys[arrayKeys.size()]);
+    if (edit == JsonArrayEdit::set && (elementKey.isStartSymbol() || elementKey.isEndSymbol()))
+    {
+        // set() inserts for [^] and [$], also when forcing deeper keys
+        change.kind = elementKey.isEndSymbol() ? Change::Kind::append : Change::Kind::prepend;
+        return change;
+    }
+    int64_t const position = resolveLocked(arrayKeys, {}, elementKey, *change.array);
+    if (position < 0 || position >= static_cast<int64_t>(change.size))
+    {
+        return change;
+    }
+    if (keys.size() > arrayKeys.size() + 1 && !keys[arrayKeys.size() + 1]->isIndex() &&
+        static_cast<JsonStringKey const &>(*keys[arrayKeys.size() + 1]).getKey() != index.field)
+    {
+        return std::nullopt;
+    }
+    change.kind     = Change::Kind::element;
+    change.position = static_cast<size_t>(position);
+    change.oldText  = JsonIndexKey::selectorText((*change.array)[change.position], index.field);
+    return change;
+}
+
+std::vector<JsonArrayIndexes::Change>
+    JsonArrayIndexes::prepare(value_type const &root, JsonKeyPath const &path, JsonArrayEdit edit)
+{
+    std::lock_guard const lock(mutex_);
+    std::vector<Change>   changes;
+    for (size_t index = 0; index < indexes_.size(); ++index)
+    {
+        // stale indexes are classified too: resolving a selector in classify() may rebuild them
+        if (auto change = classify(indexes_[index], root, path, edit))
+        {
+            change->index = index;
+            changes.push_back(std::move(*change));
+        }
+    }
+    return changes;
+}
+
+void JsonArrayIndexes::apply(std::vector<Change> const &changes, bool succeeded)
+{
+    std::lock_guard const lock(mutex_);
+    for (auto const &change: changes)
+    {
+        auto &index = indexes_[change.index];
+        if (index.stale)
+        {
+            continue;
+        }
+        if (!succeeded || change.kind == Change::Kind::stale || change.array->size() < change.size)
+        {
+            index.stale = true;
+            continue;
+        }
+        auto const &array = *change.array;
+        switch (change.kind)
+        {
+            case Change::Kind::append:
+                for (size_t position = change.size; position < array.size(); ++position)
+                {
+                    index.add(array, position);
+                }
+                break;
+            case Change::Kind::prepend:
+            {
+                size_t const added = array.size() - change.size;
+                index.base -= static_cast<int64_t>(added);
+                for (size_t position = 0; position < added; ++position)
+                {
+                    index.add(array, position);
+                }
+                break;
+            }
+            case Change::Kind::element:
+            {
+                if (change.oldText)
+                {
+                    if (index.duplicates)
+                    {
+                        // another element may have to take over the old text
+                        index.stale = true;
+                        break;
+                    }
+                    auto const found = index.positions.find(*change.oldText);
+                    if (found != index.positions.end() &&
+                        found->second == index.base + static_cast<int64_t>(change.position))
+                    {
+                        index.positions.erase(found);
+                    }
+                }
+                index.add(array, change.position);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+void JsonArrayIndexes::invalidateAll()
+{
+    std::lock_guard const lock(mutex_);
+    for (auto &index: indexes_)
+    {
+        index.stale = true;
+    }
+}
+
+} // namespace util
@@ -0,0 +1,190 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   src/json_async.cc
+ * Description: coroutine awaitables for background json i/o
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_async.h"
+
+#include "json_metrics.h"
+
+#include <algorithm>
+
+namespace util
+{
+bool JsonPendingTask::State::claim()
+{
+    std::lock_guard const lock(mutex);
+    if (status != Status::queued)
+    {
+        return false;
+    }
+    status = Status::running;
+    return true;
+}
+
+void JsonPendingTask::State::run()
+{
+    try
+    {
+        job();
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+    job = nullptr;
+    std::lock_guard const lock(mutex);
+    status = Status::done;
+    finished.notify_all();
+}
+
+JsonPendingTask::~JsonPendingTask()
+{
+    try
+    {
+        wait();
+    }
+    catch (...)
+    {
+        // the result is not wanted any more
+    }
+}
+
+void JsonPendingTask::start(JsonThreadPool &pool, std::move_only_function<void()> job)
+{
+    state_      = std::make_shared<State>();
+    state_->job = std::move(job);
+    pool.submit([state = state_] {
+        if (state->claim())
+        {
+            state->run();
+        }
+    });
+}
+
+void JsonPendingTask::wait()
+{
+    if (!state_)
+    {
+        return;
+    }
+    auto const state = std::move(state_);
+    if (state->claim())
+    {
+        state->run();
+    }
+    else
+    {
+        std::unique_lock lock(state->mutex);
+        state->finished.wait(lock, [&state] { return state->status == State::Status::done; });
+    }
+    if (state->error)
+    {
+        std::rethrow_exception(state->error);
+    }
+}
+
+bool JsonPendingTask::pending() const
+{
+    return state_ != nullptr;
+}
+
+JsonChunkReader::JsonChunkReader(std::string const &filename, size_t chunkSize, JsonThreadPool &pool)
+    : ifs_(filename, std::ios::binary)
+    , chunkSize_(std::max<size_t>(chunkSize, 1))
+    , pool_(pool)
+{
+    if (!ifs_.is_open())
+    {
+        throw std::invalid_argument(filename + " cannot be opened for reading");
+    }
+}
+
+std::string_view JsonChunkReader::next()
+{
+    if (!started_)
+    {
+        started_ = true;
+        read(current_);
+    }
+    else if (readAhead_.pending())
+    {
+        readAhead_.wait();
+        current_.swap(ahead_);
+    }
+    else
+    {
+        current_.clear();
+    }
+    if (!current_.empty())
+    {
+        readAhead_.start(pool_, [this] { read(ahead_); });
+    }
+    return current_;
+}
+
+void JsonChunkReader::read(std::string &chunk)
+{
+    chunk.resize(chunkSize_);
+    ifs_.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+    chunk.resize(static_cast<size_t>(ifs_.gcount()));
+    if (ifs_.bad())
+    {
+        throw std::runtime_error("reading failed");
+    }
+}
+
+JsonChunkSerializer::JsonChunkSerializer(value_type const &value, size_t chunkSize)
+    : rendered_(false)
+    , chunkSize_(std::max<size_t>(chunkSize, 1))
+{
+    serializer_.reset(&value);
+}
+
+JsonChunkSerializer::JsonChunkSerializer(std::string text, size_t chunkSize)
+    : text_(std::move(text))
+    , rendered_(true)
+    , chunkSize_(std::max<size_t>(chunkSize, 1))
+{
+}
+
+bool JsonChunkSerializer::next(std::string &chunk)
+{
+    if (rendered_)
+    {
+        chunk.assign(text_, textPos_, chunkSize_);
+        textPos_ += chunk.size();
+        return !chunk.empty();
+    }
+    if (serializer_.done())
+    {
+        return false;
+    }
+    chunk.resize(chunkSize_);
+    auto const out = serializer_.read(chunk.data(), chunk.size());
+    chunk.resize(out.size());
+    JSONOBJECT_METRICS_ADD(JsonCounter::bytesSerialized, out.size());
+    return true;
+}
+
+} // namespace util
@@ -0,0 +1,318 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   src/json_builder.cc
+ * Description: streaming construction of json documents and text
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_builder.h"
+
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace util
+{
+JsonBuilder::JsonBuilder(storage_type storage)
+    : storage_(std::move(storage))
+    , result_(nullptr, storage_)
+{
+}
+
+void JsonBuilder::checkCanAdd() const
+{
+    if (frames_.empty())
+    {
+        if (complete_)
+        {
+            throw std::invalid_argument("JsonBuilder: the value is already complete");
+        }
+    }
+    else if (frames_.back().container.is_object() && !frames_.back().hasKey)
+    {
+        throw std::invalid_argument("JsonBuilder: a member of an object needs a key");
+    }
+}
+
+void JsonBuilder::add(value_type &&val)
+{
+    if (frames_.empty())
+    {
+        result_   = std::move(val);
+        complete_ = true;
+        return;
+    }
+    auto &top = frames_.back();
+    if (top.container.is_object())
+    {
+        top.container.as_object().insert_or_assign(top.key, std::move(val));
+        top.hasKey = false;
+    }
+    else
+    {
+        top.container.as_array().push_back(std::move(val));
+    }
+}
+
+JsonBuilder &JsonBuilder::beginObject(size_t sizeHint)
+{
+    checkCanAdd();
+    object_type obj{storage_};
+    obj.reserve(sizeHint);
+    frames_.push_back(Frame{.container = std::move(obj)});
+    return *this;
+}
+
+JsonBuilder &JsonBuilder::beginArray(size_t sizeHint)
+{
+    checkCanAdd();
+    array_type arr{storage_};
+    arr.reserve(sizeHint);
+    frames_.push_back(Frame{.container = std::move(arr)});
+    return *this;
+}
+
+JsonBuilder &JsonBuilder::key(std::string_view name)
+{
+    if (frames_.empty() || !frames_.back().container.is_object() || frames_.back().hasKey)
+    {
+        throw std::invalid_argument("JsonBuilder: key '" + std::string{name} + "' is not expected here");
+    }
+    frames_.back().key.assign(name);
+    frames_.back().hasKey = true;
+    return *this;
+}
+
+JsonBuilder &JsonBuilder::value(value_type val)
+{
+    checkCanAdd();
+    add(std::move(val));
+    return *this;
+}
+
+JsonBuilder &JsonBuilder::end()
+{
+    if (frames_.empty() || frames_.back().hasKey)
+    {
+        throw std::invalid_argument("JsonBuilder: no container to end here");
+    }
+    // the container owns its nodes, so moving it into the parent moves pointers, not elements
+    auto container = std::move(frames_.back().container);
+    frames_.pop_back();
+    add(std::move(container));
+    return *this;
+}
+
+bool JsonBuilder::complete() const
+{
+    return complete_;
+}
+
+value_type JsonBuilder::release()
+{
+    if (!complete_)
+    {
+        throw std::invalid_argument("JsonBuilder: the value is not complete");
+    }
+    complete_ = false;
+    return std::exchange(result_, value_type{nullptr, storage_});
+}
+
+JsonWriter::JsonWriter(std::string &out)
+    : out_(out)
+{
+}
+
+void JsonWriter::beforeValue()
+{
+    if (frames_.empty())
+    {
+        if (complete_)
+        {
+            throw std::invalid_argument("JsonWriter: the value is already complete");
+        }
+        return;
+    }
+    auto &top = frames_.back();
+    if (top.isObject)
+    {
+        if (!top.hasKey)
+        {
+            throw std::invalid_argument("JsonWriter: a member of an object needs a key");
+        }
+        top.hasKey = false;
+    }
+    else if (top.count++ > 0)
+    {
+        out_ += ',';
+    }
+}
+
+void JsonWriter::writeString(std::string_view str)
+{
+    static constexpr char hex[] = "0123456789abcdef";
+    out_ += '"';
+    size_t plain = 0;
+    for (size_t i = 0; i < str.size(); ++i)
+    {
+        auto const ch = static_cast<unsigned char>(str[i]);
+        if (ch >= 0x20 && ch != '"' && ch != '\\')
+        {
+            continue;
+        }
+        out_.append(str.substr(plain, i - plain));
+        plain = i + 1;
+        out_ += '\\';
+        switch (ch)
+        {
+            case '"':
+            case '\\':
+                out_ += static_cast<char>(ch);
+                break;
+            case '\b':
+                out_ += 'b';
+                break;
+            case '\f':
+                out_ += 'f';
+                break;
+            case '\n':
+                out_ += 'n';
+                break;
+            case '\r':
+                out_ += 'r';
+                break;
+            case '\t':
+                out_ += 't';
+                break;
+            default:
+                out_ += "u00";
+                out_ += hex[ch >> 4U];
+                out_ += hex[ch & 0xFU];
+                break;
+        }
+    }
+    out_.append(str.substr(plain));
+    out_ += '"';
+}
+
+JsonWriter &JsonWriter::beginObject(size_t /*sizeHint*/)
+{
+    beforeValue();
+    out_ += '{';
+    frames_.push_back(Frame{.isObject = true});
+    return *this;
+}
+
+JsonWriter &JsonWriter::beginArray(size_t /*sizeHint*/)
+{
+    beforeValue();
+    out_ += '[';
+    frames_.push_back(Frame{.isObject = false});
+    return *this;
+}
+
+JsonWriter &JsonWriter::key(std::string_view name)
+{
+    if (frames_.empty() || !frames_.back().isObject || frames_.back().hasKey)
+    {
+        throw std::invalid_argument("JsonWriter: key '" + std::string{name} + "' is not expected here");
+    }
+    auto &top = frames_.back();
+    if (top.count++ > 0)
+    {
+        out_ += ',';
+    }
+    writeString(name);
+    out_ += ':';
+    top.hasKey = true;
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(value_type const &val)
+{
+    beforeValue();
+    char buffer[32];
+    switch (val.kind())
+    {
+        case boost::json::kind::string:
+            writeString(val.get_string());
+            break;
+        case boost::json::kind::int64:
+            out_.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), val.get_int64()).ptr);
+            break;
+        case boost::json::kind::uint64:
+            out_.append(buffer, std::to_chars(buffer, buffer + sizeof(buffer), val.get_uint64()).ptr);
+            break;
+        case boost::json::kind::double_:
+        {
+            auto const number = val.get_double();
+            if (std::isnan(number))
+            {
+                out_ += "null";
+            }
+            else if (std::isinf(number))
+            {
+                out_ += number < 0 ? "-1e99999" : "1e99999";
+            }
+            else
+            {
+                std::string_view const text{buffer, std::to_chars(buffer, buffer + sizeof(buffer), number).ptr};
+                out_ += text;
+                if (text.find_first_of(".e") == std::string_view::npos)
+                {
+                    out_ += ".0"; // keep it a double when parsed again
+                }
+            }
+            break;
+        }
+        case boost::json::kind::bool_:
+            out_ += val.get_bool() ? "true" : "false";
+            break;
+        case boost::json::kind::null:
+            out_ += "null";
+            break;
+        default:
+            out_ += json_serialize(val);
+            break;
+    }
+    complete_ = frames_.empty();
+    return *this;
+}
+
+JsonWriter &JsonWriter::end()
+{
+    if (frames_.empty() || frames_.back().hasKey)
+    {
+        throw std::invalid_argument("JsonWriter: no container to end here");
+    }
+    out_ += frames_.back().isObject ? '}' : ']';
+    frames_.pop_back();
+    complete_ = frames_.empty();
+    return *this;
+}
+
+bool JsonWriter::complete() const
+{
+    return complete_;
+}
+
+} // namespace util
@@ -0,0 +1,437 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   src/json_column.cc
+ * Description: numeric columns extracted from json arrays
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_column.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define JSONOBJECT_COLUMN_AVX2
+#include <immintrin.h>
+#endif
+
+namespace util
+{
+namespace
+{
+constexpr size_t lanes = 4;
+
+uint64_t laneBits(std::span<uint64_t const> validity, size_t slot)
+{
+    return (validity[slot / 64] >> (slot % 64)) & ((1U << lanes) - 1);
+}
+
+bool valid(std::span<uint64_t const> validity, size_t slot)
+{
+    return ((validity[slot / 64] >> (slot % 64)) & 1U) != 0;
+}
+
+value_type const *fieldOf(value_type const &element, JsonKeyPath const &field)
+{
+    value_type const *current = &element;
+    for (auto const &key: field.getKeys())
+    {
+        if (key->isIndex())
+        {
+            if (!current->is_array())
+            {
+                return nullptr;
+            }
+            auto const   &arr = current->get_array();
+            int64_t const idx = static_cast<JsonIndexKey const &>(*key).getIndex(arr);
+            if (idx < 0 || idx >= static_cast<int64_t>(arr.size()))
+            {
+                return nullptr;
+            }
+            current = &arr[static_cast<size_t>(idx)];
+        }
+        else
+        {
+            if (!current->is_object())
+            {
+                return nullptr;
+            }
+            current = current->get_object().if_contains(static_cast<JsonStringKey const &>(*key).getKey());
+            if (current == nullptr)
+            {
+                return nullptr;
+            }
+        }
+    }
+    return current;
+}
+
+std::optional<double> toDouble(value_type const &value)
+{
+    switch (value.kind())
+    {
+        case boost::json::kind::int64:
+            return static_cast<double>(value.get_int64());
+        case boost::json::kind::uint64:
+            return static_cast<double>(value.get_uint64());
+        case boost::json::kind::double_:
+            if (std::isfinite(value.get_double()))
+            {
+                return value.get_double();
+            }
+            return std::nullopt;
+        default:
+            return std::nullopt;
+    }
+}
+
+std::optional<int64_t> toInt64(value_type const &value)
+{
+    switch (value.kind())
+    {
+        case boost::json::kind::int64:
+            return value.get_int64();
+        case boost::json::kind::uint64:
+            if (value.get_uint64() <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max()))
+            {
+                return static_cast<int64_t>(value.get_uint64());
+            }
+            return std::nullopt;
+        case boost::json::kind::double_:
+        {
+            double const number = value.get_double();
+            if (std::isfinite(number) && number == std::trunc(number) && number >= -0x1p63 && number < 0x1p63)
+            {
+                return static_cast<int64_t>(number);
+            }
+            return std::nullopt;
+        }
+        default:
+            return std::nullopt;
+    }
+}
+
+// The scalar kernels keep four lanes like the AVX2 ones, so that floating-point sums are rounded identically.
+
+double sumScalar(std::span<double const> values)
+{
+    std::array<double, lanes> lane{};
+    size_t                    slot = 0;
+    for (; slot + lanes <= values.size(); slot += lanes)
+    {
+        for (size_t i = 0; i < lanes; ++i)
+        {
+            lane[i] += values[slot + i];
+        }
+    }
+    double total = (lane[0] + lane[1]) + (lane[2] + lane[3]);
+    for (; slot < values.size(); ++slot)
+    {
+        total += values[slot];
+    }
+    return total;
+}
+
+int64_t sumScalar(std::span<int64_t const> values)
+{
+    uint64_t total = 0;
+    for (int64_t const value: values)
+    {
+        total += static_cast<uint64_t>(value);
+    }
+    return static_cast<int64_t>(total);
+}
+
+template<typename T, typename Better>
+T extremeScalar(std::span<T const> values, std::span<uint64_t const> validity, T start, Better better)
+{
+    T result = start;
+    for (size_t slot = 0; slot < values.size(); ++slot)
+    {
+        if (valid(validity, slot) && better(values[slot], result))
+        {
+            result = values[slot];
+        }
+    }
+    return result;
+}
+
+#if defined(JSONOBJECT_COLUMN_AVX2)
+/// lane masks for each combination of four validity bits
+struct LaneMasks
+{
+    alignas(32) std::array<std::array<int64_t, lanes>, 1U << lanes> masks{};
+
+    constexpr LaneMasks()
+    {
+        for (size_t bits = 0; bits < masks.size(); ++bits)
+        {
+            for (size_t i = 0; i < lanes; ++i)
+            {
+                masks[bits][i] = ((bits >> i) & 1U) != 0 ? -1 : 0;
+            }
+        }
+    }
+};
+
+constexpr LaneMasks laneMasks{};
+
+__attribute__((target("avx2"))) __m256i laneMask(std::span<uint64_t const> validity, size_t slot)
+{
+    return _mm256_load_si256(reinterpret_cast<__m256i const *>(laneMasks.masks[laneBits(validity, slot)].data()));
+}
+
+__attribute__((target("avx2"))) double sumAvx2(std::span<double const> values)
+{
+    __m256d acc  = _mm256_setzero_pd();
+    size_t  slot = 0;
+    for (; slot + lanes <= values.size(); slot += lanes)
+    {
+        acc = _mm256_add_pd(acc, _mm256_loadu_pd(values.data() + slot));
+    }
+    alignas(32) std::array<double, lanes> lane{};
+    _mm256_store_pd(lane.data(), acc);
+    double total = (lane[0] + lane[1]) + (lane[2] + lane[3]);
+    for (; slot < values.size(); ++slot)
+    {
+        total += values[slot];
+    }
+    return total;
+}
+
+__attribute__((target("avx2"))) int64_t sumAvx2(std::span<int64_t const> values)
+{
+    __m256i acc  = _mm256_setzero_si256();
+    size_t  slot = 0;
+    for (; slot + lanes <= values.size(); slot += lanes)
+    {
+        acc = _mm256_add_epi64(acc, _mm256_loadu_si256(reinterpret_cast<__m256i const *>(values.data() + slot)));
+    }
+    alignas(32) std::array<uint64_t, lanes> lane{};
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lane.data()), acc);
+    uint64_t total = lane[0] + lane[1] + lane[2] + lane[3];
+    for (; slot < values.size(); ++slot)
+    {
+        total += static_cast<uint64_t>(values[slot]);
+    }
+    return static_cast<int64_t>(total);
+}
+
+template<bool Min>
+__attribute__((target("avx2"))) double extremeAvx2(std::span<double const> values, std::span<uint64_t const> validity)
+{
+    double const start = Min ? std::numeric_limits<double>::infinity() : -std::numeric_limits<double>::infinity();
+    __m256d const fill = _mm256_set1_pd(start);
+    __m256d       acc  = fill;
+    size_t        slot = 0;
+    for (; slot + lanes <= values.size(); slot += lanes)
+    {
+        __m256d const mask  = _mm256_castsi256_pd(laneMask(validity, slot));
+        __m256d const value = _mm256_blendv_pd(fill, _mm256_loadu_pd(values.data() + slot), mask);
+        acc                 = Min ? _mm256_min_pd(acc, value) : _mm256_max_pd(acc, value);
+    }
+    alignas(32) std::array<double, lanes> lane{};
+    _mm256_store_pd(lane.data(), acc);
+    double result = Min ? std::ranges::min(lane) : std::ranges::max(lane);
+    for (; slot < values.size(); ++slot)
+    {
+        if (valid(validity, slot))
+        {
+            result = Min ? std::min(result, values[slot]) : std::max(result, values[slot]);
+        }
+    }
+    return result;
+}
+
+template<bool Min>
+__attribute__((target("avx2"))) int64_t extremeAvx2(std::span<int64_t const> values, std::span<uint64_t const> validity)
+{
+    int64_t const start = Min ? std::numeric_limits<int64_t>::max() : std::numeric_limits<int64_t>::min();
+    __m256i const fill  = _mm256_set1_epi64x(start);
+    __m256i       acc   = fill;
+    size_t        slot  = 0;
+    for (; slot + lanes <= values.size(); slot += lanes)
+    {
+        __m256i const loaded = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(values.data() + slot));
+        __m256i const value  = _mm256_blendv_epi8(fill, loaded, laneMask(validity, slot));
+        __m256i const better = Min ? _mm256_cmpgt_epi64(acc, value) : _mm256_cmpgt_epi64(value, acc);
+        acc                  = _mm256_blendv_epi8(acc, value, better);
+    }
+    alignas(32) std::array<int64_t, lanes> lane{};
+    _mm256_store_si256(reinterpret_cast<__m256i *>(lane.data()), acc);
+    int64_t result = Min ? std::ranges::min(lane) : std::ranges::max(lane);
+    for (; slot < values.size(); ++slot)
+    {
+        if (valid(validity, slot))
+        {
+            result = Min ? std::min(result, values[slot]) : std::max(result, values[slot]);
+        }
+    }
+    return result;
+}
+#endif
+
+bool useAvx2(JsonColumnKernel kernel)
+{
+    return kernel == JsonColumnKernel::automatic && json_column_vectorized();
+}
+
+template<bool Min, typename T>
+T extreme(std::span<T const> values, std::span<uint64_t const> validity, JsonColumnKernel kernel)
+{
+#if defined(JSONOBJECT_COLUMN_AVX2)
+    if (useAvx2(kernel))
+    {
+        return extremeAvx2<Min>(values, validity);
+    }
+#endif
+    if constexpr (Min)
+    {
+        return extremeScalar(values, validity, std::numeric_limits<T>::max(), std::less<>{});
+    }
+    else
+    {
+        return extremeScalar(values, validity, std::numeric_limits<T>::lowest(), std::greater<>{});
+    }
+}
+} // namespace
+
+bool json_column_vectorized()
+{
+#if defined(JSONOBJECT_COLUMN_AVX2)
+    static bool const supported = __builtin_cpu_supports("avx2") != 0;
+    return supported;
+#else
+    return false;
+#endif
+}
+
+template<typename T>
+JsonColumn<T> JsonColumn<T>::extract(array_type const &array, JsonKeyPath const &field)
+{
+    JsonColumn column;
+    column.reserve(array.size());
+    for (auto const &element: array)
+    {
+        value_type const *found = fieldOf(element, field);
+        std::optional<T>  converted;
+        if (found != nullptr)
+        {
+            if constexpr (std::is_same_v<T, double>)
+            {
+                converted = toDouble(*found);
+            }
+            else
+            {
+                converted = toInt64(*found);
+            }
+        }
+        if (converted)
+        {
+            column.push_back(*converted);
+        }
+        else
+        {
+            column.pushNull();
+        }
+    }
+    return column;
+}
+
+template<typename T>
+void JsonColumn<T>::reserve(size_t capacity)
+{
+    values_.reserve(capacity);
+    validity_.reserve((capacity + 63) / 64);
+}
+
+template<typename T>
+void JsonColumn<T>::push_back(T value)
+{
+    if (values_.size() % 64 == 0)
+    {
+        validity_.push_back(0);
+    }
+    validity_.back() |= uint64_t{1} << (values_.size() % 64);
+    values_.push_back(value);
+    ++validCount_;
+}
+
+template<typename T>
+void JsonColumn<T>::pushNull()
+{
+    if (values_.size() % 64 == 0)
+    {
+        validity_.push_back(0);
+    }
+    values_.push_back(T{});
+}
+
+template<typename T>
+T JsonColumn<T>::sum(JsonColumnKernel kernel) const
+{
+    // null slots hold 0, so they need no masking
+#if defined(JSONOBJECT_COLUMN_AVX2)
+    if (useAvx2(kernel))
+    {
+        return sumAvx2(values());
+    }
+#endif
+    return sumScalar(values());
+}
+
+template<typename T>
+std::optional<T> JsonColumn<T>::min(JsonColumnKernel kernel) const
+{
+    if (validCount_ == 0)
+    {
+        return std::nullopt;
+    }
+    return extreme<true>(values(), validity(), kernel);
+}
+
+template<typename T>
+std::optional<T> JsonColumn<T>::max(JsonColumnKernel kernel) const
+{
+    if (validCount_ == 0)
+    {
+        return std::nullopt;
+    }
+    return extreme<false>(values(), validity(), kernel);
+}
+
+template<typename T>
+std::optional<double> JsonColumn<T>::mean(JsonColumnKernel kernel) const
+{
+    if (validCount_ == 0)
+    {
+        return std::nullopt;
+    }
+    return static_cast<double>(sum(kernel)) / static_cast<double>(validCount_);
+}
+
+template class JsonColumn<double>;
+template class JsonColumn<int64_t>;
+
+} // namespace util
@@ -0,0 +1,381 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   src/json_compression.cc
+ * Description: streaming gzip load and write of json objects
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_object.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <zlib.h>
+
+namespace util
+{
+namespace
+{
+/**
+ * Fixed ring of buffers handed from one producing to one consuming thread.
+ */
+class ChunkRing
+{
+    std::mutex               mutex_;
+    std::condition_variable  changed_;
+    std::vector<std::string> slots_;
+    size_t                   head_      = 0; ///< next slot to consume
+    size_t                   filled_    = 0; ///< published and not yet released slots
+    bool                     finished_  = false;
+    bool                     abandoned_ = false;
+    std::exception_ptr       error_;
+
+  public:
+    ChunkRing(size_t slots, size_t chunkSize)
+        : slots_(std::max<size_t>(slots, 1))
+    {
+        for (auto& slot : slots_)
+        {
+            slot.reserve(chunkSize);
+        }
+    }
+
+    /**
+     * @brief Producer: wait for a free buffer.
+     * @return the buffer, or nullptr if the consumer has given up without error
+     */
+    std::string* acquireFree()
+    {
+        std::unique_lock lock(mutex_);
+        changed_.wait(lock, [this] { return filled_ < slots_.size() || abandoned_; });
+        if (abandoned_)
+        {
+            if (error_)
+            {
+                std::rethrow_exception(error_);
+            }
+            return nullptr;
+        }
+        return &slots_[(head_ + filled_) % slots_.size()];
+    }
+
+    /**
+     * @brief Producer: hand the acquired buffer to the consumer.
+     */
+    void publish()
+    {
+        std::lock_guard const lock(mutex_);
+        ++filled_;
+        changed_.notify_all();
+    }
+
+    /**
+     * @brief Producer: no more buffers follow.
+     */
+    void finish(std::exception_ptr error = nullptr)
+    {
+        std::lock_guard const lock(mutex_);
+        finished_ = true;
+        if (!error_)
+        {
+            error_ = std::move(error);
+        }
+        changed_.notify_all();
+    }
+
+    /**
+     * @brief Consumer: wait for the next filled buffer.
+     * @return the buffer, or nullptr at the end
+     * @throws the error the producer finished with
+     */
+    std::string* acquireFilled()
+    {
+        std::unique_lock lock(mutex_);
+        changed_.wait(lock, [this] { return filled_ > 0 || finished_; });
+        if (filled_ > 0)
+        {
+            return &slots_[head_];
+        }
+        if (error_)
+        {
+            std::rethrow_exception(error_);
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Consumer: give the buffer back to the producer.
+     */
+    void release()
+    {
+        std::lock_guard const lock(mutex_);
+        head_ = (head_ + 1) % slots_.size();
+        --filled_;
+        changed_.notify_all();
+    }
+
+    /**
+     * @brief Consumer: stop the producer.
+     */
+    void abandon(std::exception_ptr error = nullptr)
+    {
+        std::lock_guard const lock(mutex_);
+        abandoned_ = true;
+        if (!error_)
+        {
+            error_ = std::move(error);
+        }
+        changed_.notify_all();
+    }
+
+    void rethrowError()
+    {
+        std::lock_guard const lock(mutex_);
+        if (error_)
+        {
+            std::rethrow_exception(error_);
+        }
+    }
+};
+
+Bytef* zlibBytes(char const* data)
+{
+    // zlib does not write through next_in, but only declares it const with ZLIB_CONST
+    return reinterpret_cast<Bytef*>(const_cast<char*>(data));
+}
+
+void inflateFile(std::ifstream& in, std::string const& filename, ChunkRing& ring)
+{
+    z_stream stream{};
+    // 32 added to the window bits detects gzip and zlib headers
+    if (inflateInit2(&stream, MAX_WBITS + 32) != Z_OK)
+    {
+        throw std::runtime_error("cannot initialise zlib");
+    }
+    std::unique_ptr<z_stream, decltype(&inflateEnd)> const guard{&stream, &inflateEnd};
+
+    std::vector<char> input(64UL << 10U);
+    bool              endOfInput  = false;
+    bool              endOfStream = false;
+    while (!endOfInput)
+    {
+        auto* chunk = ring.acquireFree();
+        if (chunk == nullptr)
+        {
+            return;
+        }
+        chunk->resize(chunk->capacity());
+        stream.next_out  = zlibBytes(chunk->data());
+        stream.avail_out = static_cast<uInt>(chunk->size());
+        while (stream.avail_out > 0)
+        {
+            if (stream.avail_in == 0)
+            {
+                in.read(input.data(), static_cast<std::streamsize>(input.size()));
+                if (in.gcount() == 0)
+                {
+                    endOfInput = true;
+                    break;
+                }
+                stream.next_in  = zlibBytes(input.data());
+                stream.avail_in = static_cast<uInt>(in.gcount());
+            }
+            if (endOfStream)
+            {
+                // concatenated gzip members form one file
+                inflateReset(&stream);
+                endOfStream = false;
+            }
+            auto const result = inflate(&stream, Z_NO_FLUSH);
+            if (result == Z_STREAM_END)
+            {
+                endOfStream = true;
+            }
+            else if (result != Z_OK && result != Z_BUF_ERROR)
+            {
+                throw std::invalid_argument(filename + " is not valid compressed data");
+            }
+        }
+        chunk->resize(chunk->size() - stream.avail_out);
+        if (!chunk->empty())
+        {
+            ring.publish();
+        }
+    }
+    if (!endOfStream)
+    {
+        throw std::invalid_argument(filename + " is truncated");
+    }
+}
+
+void deflateChunks(ChunkRing& ring, std::ofstream& out, std::string const& filename, int level, size_t bufferSize)
+{
+    z_stream stream{};
+    // 16 added to the window bits writes a gzip header
+    if (deflateInit2(&stream, level, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        throw std::runtime_error("cannot initialise zlib");
+    }
+    std::unique_ptr<z_stream, decltype(&deflateEnd)> const guard{&stream, &deflateEnd};
+
+    std::vector<char> output(bufferSize);
+    auto const        compress = [&](int flush) {
+        int result = Z_OK;
+        do
+        {
+            stream.next_out  = zlibBytes(output.data());
+            stream.avail_out = static_cast<uInt>(output.size());
+            result           = deflate(&stream, flush);
+            if (result == Z_STREAM_ERROR)
+            {
+                throw std::runtime_error("compressing " + filename + " failed");
+            }
+            if (!out.write(output.data(), static_cast<std::streamsize>(output.size() - stream.avail_out)))
+            {
+                throw std::runtime_error("writing " + filename + " failed");
+            }
+        } while (stream.avail_out == 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+    };
+
+    while (auto* chunk = ring.acquireFilled())
+    {
+        stream.next_in  = zlibBytes(chunk->data());
+        stream.avail_in = static_cast<uInt>(chunk->size());
+        compress(Z_NO_FLUSH);
+        ring.release();
+    }
+    compress(Z_FINISH);
+}
+
+} // namespace
+
+void JsonObject::loadCompressed(std::string const& filename, JsonCompressionOptions const& options)
+{
+    JSONOBJECT_METRICS_SCOPE(JsonOperation::load);
+    std::ifstream in(filename.c_str(), std::ios::binary);
+    if (!in.is_open())
+    {
+        throw std::invalid_argument(filename + " cannot be opened for reading");
+    }
+
+    ChunkRing    ring{options.ringSlots, std::max<size_t>(options.chunkSize, 1)};
+    std::jthread decompressor{[&in, &filename, &ring] {
+        try
+        {
+            inflateFile(in, filename, ring);
+            ring.finish();
+        }
+        catch (...)
+        {
+            ring.finish(std::current_exception());
+        }
+    }};
+
+    boost::json::stream_parser parser;
+    parser.reset(json_.storage());
+    JsonSnapshotDigest      digest;
+    boost::json::error_code ec;
+    try
+    {
+        while (auto const* chunk = ring.acquireFilled())
+        {
+            JSONOBJECT_METRICS_ADD(JsonCounter::bytesParsed, chunk->size());
+            digest.update(*chunk);
+            parser.write(chunk->data(), chunk->size(), ec);
+            ring.release();
+            if (ec)
+            {
+                break;
+            }
+        }
+        if (!ec)
+        {
+            parser.finish(ec);
+        }
+    }
+    catch (...)
+    {
+        ring.abandon();
+        throw;
+    }
+    if (ec)
+    {
+        ring.abandon();
+        throw std::invalid_argument(filename + " cannot be parsed: " + ec.message());
+    }
+    json_ = parser.release();
+    finishLoad(filename, digest);
+}
+
+void JsonObject::writeCompressed(std::string const& filename, size_t indent, JsonCompressionOptions const& options)
+    const
+{
+    JSONOBJECT_METRICS_SCOPE(JsonOperation::write);
+    std::ofstream out(filename.c_str(), std::ios::binary);
+    if (!out.is_open())
+    {
+        throw std::invalid_argument(filename + " cannot be opened for writing");
+    }
+
+    auto const chunkSize = std::max<size_t>(options.chunkSize, 1);
+    auto       chunks    = indent > 0 ? JsonChunkSerializer{toString(indent), chunkSize}
+                                      : JsonChunkSerializer{json_, chunkSize};
+    ChunkRing    ring{options.ringSlots, chunkSize};
+    std::jthread compressor{[&ring, &out, &filename, level = options.level, chunkSize] {
+        try
+        {
+            deflateChunks(ring, out, filename, level, chunkSize);
+        }
+        catch (...)
+        {
+            ring.abandon(std::current_exception());
+        }
+    }};
+
+    try
+    {
+        for (auto* chunk = ring.acquireFree(); chunk != nullptr && chunks.next(*chunk); chunk = ring.acquireFree())
+        {
+            ring.publish();
+        }
+        ring.finish();
+    }
+    catch (...)
+    {
+        ring.finish(std::current_exception());
+        throw;
+    }
+    compressor.join();
+    ring.rethrowError();
+    out.close();
+    if (out.fail())
+    {
+        throw std::runtime_error("writing " + filename + " failed");
+    }
+}
+
+} // namespace util
@@ -0,0 +1,279 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   src/json_cursor.cc
+ * Description: cursors pinning a node of a json object
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_object.h"
+
+#include <stdexcept>
+#include <utility>
+
+namespace util
+{
+JsonCursor::JsonCursor(JsonObject& object, JsonKeyPath const& path)
+    : object_(&object)
+    , nodes_{&object.json_}
+    , generation_(object.generation_)
+{
+    descend(path);
+}
+
+void JsonCursor::descend(JsonKeyPath const& path)
+{
+    size_t const start = nodes_.size() - 1;
+    auto const&  keys  = path.getKeys();
+    nodes_.reserve(nodes_.size() + keys.size());
+    for (size_t segment = 0; segment < keys.size(); ++segment)
+    {
+        auto const& key     = keys[segment];
+        value_type* current = nodes_.back();
+        if (key->isIndex())
+        {
+            if (!is_array(current))
+            {
+                object_->throwLookupError(*nodes_[start], path, JsonPathError{json_errc::expected_array, segment});
+            }
+            auto const* indexKey = static_cast<JsonIndexKey const*>(key.get());
+            auto&       arr      = as_array(*current);
+            int64_t     idx      = object_->indexes_.resolve(path_.getKeys(), {}, *indexKey, arr);
+            if (idx < 0 || idx >= static_cast<int64_t>(array_size(arr)))
+            {
+                auto const code = indexKey->isSelector() ? json_errc::missing_key : json_errc::index_out_of_bounds;
+                object_->throwLookupError(*nodes_[start], path, JsonPathError{code, segment});
+            }
+            // keep the index, not the symbol: [$] must not follow later appends
+            path_.append(std::make_shared<JsonIndexKey>(static_cast<size_t>(idx)));
+            nodes_.push_back(&arr[static_cast<size_t>(idx)]);
+        }
+        else
+        {
+            if (!is_object(current))
+            {
+                object_->throwLookupError(*nodes_[start], path, JsonPathError{json_errc::expected_object, segment});
+            }
+            value_type* next = current->as_object().if_contains(static_cast<JsonStringKey const*>(key.get())->getKey());
+            if (next == nullptr)
+            {
+                object_->throwLookupError(*nodes_[start], path, JsonPathError{json_errc::missing_key, segment});
+            }
+            path_.append(key);
+            nodes_.push_back(next);
+        }
+    }
+}
+
+bool JsonCursor::isValid() const
+{
+    if (nodes_.front() != &object_->json_)
+    {
+        return false;
+    }
+    auto const& keys = path_.getKeys();
+    if (!keys.empty() && generation_ < object_->resetGeneration_)
+    {
+        // the root stays in place, but anything below it may have been replaced
+        return false;
+    }
+    for (size_t segment = 0; segment < keys.size(); ++segment)
+    {
+        // nodes_[segment] was confirmed in the previous step, so it is safe to look into it
+        value_type const* current = nodes_[segment];
+        value_type const* next    = nullptr;
+        if (keys[segment]->isIndex())
+        {
+            if (!is_array(current))
+            {
+                return false;
+            }
+            auto const& arr = *as_array(current);
+            if (!object_->shiftedArrays_.empty())
+            {
+                // the element may still be in place while the index now addresses another one
+                auto const shift = object_->shiftedArrays_.find(&arr);
+                if (shift != object_->shiftedArrays_.end() && shift->second > generation_)
+                {
+                    return false;
+                }
+            }
+            auto const  idx = static_cast<JsonIndexKey const*>(keys[segment].get())->getIndex(arr);
+            next            = idx < static_cast<int64_t>(array_size(arr)) ? &arr[static_cast<size_t>(idx)] : nullptr;
+        }
+        else if (is_object(current))
+        {
+            next = as_object(current)->if_contains(static_cast<JsonStringKey const*>(keys[segment].get())->getKey());
+        }
+        if (next == nullptr || next != nodes_[segment + 1])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void JsonCursor::check() const
+{
+#ifndef NDEBUG
+    if (!isValid())
+    {
+        throw invalid_cursor_error(
+            "Cursor at '" + path_.toString() + "' was invalidated by a change of its containers"
+        );
+    }
+#endif
+}
+
+value_type const* JsonCursor::find(JsonKeyPath const& path, bool allowMissing) const
+{
+    check();
+    return object_->find(*nodes_.back(), path, allowMissing, path_.getKeys());
+}
+
+value_type const& JsonCursor::value() const
+{
+    check();
+    return *nodes_.back();
+}
+
+JsonKeyPath const& JsonCursor::path() const
+{
+    return path_;
+}
+
+size_t JsonCursor::depth() const
+{
+    return path_.size();
+}
+
+value_type JsonCursor::get(JsonKeyPath const& path, std::optional<value_type> const& defaultValue) const
+{
+    JSONOBJECT_METRICS_SCOPE(JsonOperation::get);
+    value_type const* found = find(path, defaultValue.has_value());
+    if (found == nullptr)
+    {
+        JSONOBJECT_METRICS_ADD(JsonCounter::defaultFallbacks, 1);
+        return defaultValue.value();
+    }
+    return *found;
+}
+
+value_type JsonCursor::get(std::string_view path, std::optional<value_type> const& defaultValue) const
+{
+    return get(*object_->makePath(path), defaultValue);
+}
+
+void JsonCursor::set(JsonKeyPath const& path, value_type const& value, bool force)
+{
+    JSONOBJECT_METRICS_SCOPE(JsonOperation::set);
+    check();
+    auto result = object_->trySetBelow(*nodes_.back(), path_, path, value, force);
+    if (!result)
+    {
+        object_->throwSetError(path, result.error());
+    }
+}
+
+void JsonCursor::set(std::string_view path, value_type const& value, bool force)
+{
+    set(*object_->makePath(path), value, force);
+}
+
+JsonCursor JsonCursor::cursor(JsonKeyPath const& path) const
+{
+    check();
+    JsonCursor result{*this};
+    result.descend(path);
+    return result;
+}
+
+JsonCursor JsonCursor::cursor(std::string_view path) const
+{
+    return cursor(*object_->makePath(path));
+}
+
+bool JsonCursor::hasParent() const
+{
+    return !path_.getKeys().empty();
+}
+
+JsonCursor JsonCursor::parent() const
+{
+    if (!hasParent())
+    {
+        throw std::invalid_argument("Cursor at the root has no parent");
+    }
+    check();
+    JsonCursor result{*object_, JsonKeyPath{}};
+    auto const& keys = path_.getKeys();
+    for (size_t segment = 0; segment + 1 < keys.size(); ++segment)
+    {
+        result.path_.append(keys[segment]);
+    }
+    result.nodes_.assign(nodes_.begin(), nodes_.end() - 1);
+    result.generation_ = generation_;
+    return result;
+}
+
+std::optional<JsonCursor> JsonCursor::sibling(std::ptrdiff_t offset) const
+{
+    if (!hasParent())
+    {
+        return std::nullopt;
+    }
+    JsonCursor result = parent();
+    value_type* container = result.nodes_.back();
+    auto const& last      = path_.getKeys().back();
+    if (last->isIndex())
+    {
+        auto&      arr = as_array(*container);
+        auto const idx = static_cast<JsonIndexKey const*>(last.get())->getIndex(arr) + offset;
+        if (idx < 0 || idx >= static_cast<int64_t>(array_size(arr)))
+        {
+            return std::nullopt;
+        }
+        result.path_.append(std::make_shared<JsonIndexKey>(static_cast<size_t>(idx)));
+        result.nodes_.push_back(&arr[static_cast<size_t>(idx)]);
+        return result;
+    }
+    auto& obj = container->as_object();
+    auto  it  = obj.find(static_cast<JsonStringKey const*>(last.get())->getKey());
+    if ((offset < 0 && it == obj.begin()) || (offset > 0 && it + 1 == obj.end()))
+    {
+        return std::nullopt;
+    }
+    it += offset;
+    result.path_.append(std::make_shared<JsonStringKey>(it->key()));
+    result.nodes_.push_back(&it->value());
+    return result;
+}
+
+std::optional<JsonCursor> JsonCursor::nextSibling() const
+{
+    return sibling(1);
+}
+
+std::optional<JsonCursor> JsonCursor::previousSibling() const
+{
+    return sibling(-1);
+}
+
+} // namespace util
@@ -0,0 +1,541 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   src/json_event_parser.cc
+ * Description: event-driven json parser with incremental path tracking
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_event_parser.h"
+
+#include <boost/json/basic_parser_impl.hpp>
+#include <deque>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace util
+{
+/**
+ * Handler of boost::json::basic_parser that keeps the path up to date and forwards to a JsonEventHandler.
+ * Keys and strings may arrive in parts when the input is written in chunks; the parts are collected here.
+ */
+class JsonEventParser::Adapter
+{
+  public:
+    using string_view_type = boost::json::string_view;
+    using error_code       = boost::json::error_code;
+
+    static constexpr size_t max_object_size = static_cast<size_t>(-1);
+    static constexpr size_t max_array_size  = static_cast<size_t>(-1);
+    static constexpr size_t max_key_size    = static_cast<size_t>(-1);
+    static constexpr size_t max_string_size = static_cast<size_t>(-1);
+
+    Adapter(JsonEventParser const &parser, JsonEventHandler &handler, storage_type storage)
+        : parser_(parser)
+        , handler_(handler)
+        , storage_(std::move(storage))
+    {
+    }
+
+    [[nodiscard]] std::span<JsonPathSegment const> path() const
+    {
+        return path_;
+    }
+
+    [[nodiscard]] size_t depth() const
+    {
+        return frames_.size();
+    }
+
+    [[nodiscard]] bool stopped() const
+    {
+        return stopped_;
+    }
+
+    bool on_document_begin(error_code & /*ec*/)
+    {
+        return true;
+    }
+
+    bool on_document_end(error_code & /*ec*/)
+    {
+        return true;
+    }
+
+    bool on_object_begin(error_code &ec)
+    {
+        return beginContainer(true, ec);
+    }
+
+    bool on_object_end(size_t size, error_code &ec)
+    {
+        return endContainer(true, size, ec);
+    }
+
+    bool on_array_begin(error_code &ec)
+    {
+        return beginContainer(false, ec);
+    }
+
+    bool on_array_end(size_t size, error_code &ec)
+    {
+        return endContainer(false, size, ec);
+    }
+
+    bool on_key_part(string_view_type part, size_t /*size*/, error_code & /*ec*/)
+    {
+        if (skipDepth_ == 0)
+        {
+            text_.append(part);
+        }
+        return true;
+    }
+
+    bool on_key(string_view_type part, size_t /*size*/, error_code &ec)
+    {
+        if (skipDepth_ > 0)
+        {
+            return true;
+        }
+        auto const key = collect(part);
+        if (captureDepth_ > 0)
+        {
+            values_.push_key(key);
+            text_.clear();
+            return true;
+        }
+        // the key is kept per depth so the path can refer to it until the member ends
+        auto const level = frames_.size() - 1;
+        if (keys_.size() <= level)
+        {
+            keys_.resize(level + 1);
+        }
+        keys_[level].assign(key);
+        text_.clear();
+        path_.emplace_back().key = keys_[level];
+        auto const action        = handler_.onKey(parser_, keys_[level]);
+        if (action == JsonParseAction::stop)
+        {
+            return stop(ec);
+        }
+        pending_ = action;
+        return true;
+    }
+
+    bool on_string_part(string_view_type part, size_t /*size*/, error_code & /*ec*/)
+    {
+        if (skipDepth_ == 0)
+        {
+            text_.append(part);
+        }
+        return true;
+    }
+
+    bool on_string(string_view_type part, size_t /*size*/, error_code &ec)
+    {
+        if (skipDepth_ > 0)
+        {
+            return true;
+        }
+        if (captureDepth_ > 0)
+        {
+            values_.push_string(collect(part));
+            text_.clear();
+            return true;
+        }
+        auto const result = scalar(value_type{collect(part), storage_}, ec);
+        text_.clear();
+        return result;
+    }
+
+    bool on_number_part(string_view_type /*part*/, error_code & /*ec*/)
+    {
+        return true;
+    }
+
+    bool on_int64(int64_t number, string_view_type /*text*/, error_code &ec)
+    {
+        if (skipDepth_ > 0)
+        {
+            return true;
+        }
+        if (captureDepth_ > 0)
+        {
+            values_.push_int64(number);
+            return true;
+        }
+        return scalar(value_type{number, storage_}, ec);
+    }
+
+    bool on_uint64(uint64_t number, string_view_type /*text*/, error_code &ec)
+    {
+        if (skipDepth_ > 0)
+        {
+            return true;
+        }
+        if (captureDepth_ > 0)
+        {
+            values_.push_uint64(number);
+            return true;
+        }
+        return scalar(value_type{number, storage_}, ec);
+    }
+
+    bool on_double(double number, string_view_type /*text*/, error_code &ec)
+    {
+        if (skipDepth_ > 0)
+        {
+            return true;
+        }
+        if (captureDepth_ > 0)
+        {
+            values_.push_double(number);
+            return true;
+        }
+        return scalar(value_type{number, storage_}, ec);
+    }
+
+    bool on_bool(bool flag, error_code &ec)
+    {
+        if (skipDepth_ > 0)
+        {
+            return true;
+        }
+        if (captureDepth_ > 0)
+        {
+            values_.push_bool(flag);
+            return true;
+        }
+        return scalar(value_type{flag, storage_}, ec);
+    }
+
+    bool on_null(error_code &ec)
+    {
+        if (skipDepth_ > 0)
+        {
+            return true;
+        }
+        if (captureDepth_ > 0)
+        {
+            values_.push_null();
+            return true;
+        }
+        return scalar(value_type{nullptr, storage_}, ec);
+    }
+
+    bool on_comment_part(string_view_type /*part*/, error_code & /*ec*/)
+    {
+        return true;
+    }
+
+    bool on_comment(string_view_type /*part*/, error_code & /*ec*/)
+    {
+        return true;
+    }
+
+  private:
+    struct Frame
+    {
+        bool   isObject = false;
+        size_t count    = 0; ///< elements of an array seen so far
+    };
+
+    JsonEventParser const       &parser_;
+    JsonEventHandler            &handler_;
+    storage_type                 storage_;
+    std::vector<Frame>           frames_;
+    std::vector<JsonPathSegment> path_;
+    std::deque<std::string>      keys_; ///< current key per depth; a deque so that growing it does not move the keys
+    std::string                  text_;
+    boost::json::value_stack     values_;
+    JsonParseAction              pending_      = JsonParseAction::proceed;
+    size_t                       skipDepth_    = 0;
+    size_t                       captureDepth_ = 0;
+    bool                         stopped_      = false;
+
+    std::string_view collect(string_view_type part)
+    {
+        if (text_.empty())
+        {
+            return part;
+        }
+        text_.append(part);
+        return text_;
+    }
+
+    bool stop(error_code &ec)
+    {
+        stopped_ = true;
+        ec       = boost::json::make_error_code(boost::json::error::exception);
+        return false;
+    }
+
+    /**
+     * @brief A value starts: an element of an array gets its index on the path; a member already has its key there.
+     * @return the action requested for the value by the key event, if any
+     */
+    JsonParseAction enterValue()
+    {
+        if (!frames_.empty() && !frames_.back().isObject)
+        {
+            path_.emplace_back(JsonPathSegment{.index = frames_.back().count, .isIndex = true});
+        }
+        return std::exchange(pending_, JsonParseAction::proceed);
+    }
+
+    void leaveValue()
+    {
+        if (frames_.empty())
+        {
+            return;
+        }
+        path_.pop_back();
+        if (!frames_.back().isObject)
+        {
+            ++frames_.back().count;
+        }
+    }
+
+    bool scalar(value_type &&value, error_code &ec)
+    {
+        auto action = enterValue();
+        if (action == JsonParseAction::capture)
+        {
+            action = handler_.onSubtree(parser_, std::move(value));
+        }
+        else if (action != JsonParseAction::skip)
+        {
+            action = handler_.onValue(parser_, value);
+        }
+        if (action == JsonParseAction::stop)
+        {
+            return stop(ec);
+        }
+        leaveValue();
+        return true;
+    }
+
+    bool beginContainer(bool isObject, error_code &ec)
+    {
+        if (skipDepth_ > 0)
+        {
+            ++skipDepth_;
+            return true;
+        }
+        if (captureDepth_ > 0)
+        {
+            ++captureDepth_;
+            return true;
+        }
+        auto action = enterValue();
+        if (action == JsonParseAction::proceed)
+        {
+            action = isObject ? handler_.onObjectBegin(parser_) : handler_.onArrayBegin(parser_);
+        }
+        switch (action)
+        {
+            case JsonParseAction::stop:
+                return stop(ec);
+            case JsonParseAction::skip:
+                skipDepth_ = 1;
+                break;
+            case JsonParseAction::capture:
+                values_.reset(storage_);
+                captureDepth_ = 1;
+                break;
+            case JsonParseAction::proceed:
+                frames_.push_back(Frame{.isObject = isObject});
+                break;
+        }
+        return true;
+    }
+
+    bool endContainer(bool isObject, size_t size, error_code &ec)
+    {
+        if (skipDepth_ > 0)
+        {
+            if (--skipDepth_ == 0)
+            {
+                leaveValue();
+            }
+            return true;
+        }
+        auto action = JsonParseAction::proceed;
+        if (captureDepth_ > 0)
+        {
+            if (isObject)
+            {
+                values_.push_object(size);
+            }
+            else
+            {
+                values_.push_array(size);
+            }
+            if (--captureDepth_ > 0)
+            {
+                return true;
+            }
+            action = handler_.onSubtree(parser_, values_.release());
+        }
+        else
+        {
+            frames_.pop_back();
+            action = isObject ? handler_.onObjectEnd(parser_) : handler_.onArrayEnd(parser_);
+        }
+        if (action == JsonParseAction::stop)
+        {
+            return stop(ec);
+        }
+        leaveValue();
+        return true;
+    }
+};
+
+struct JsonEventParser::Impl
+{
+    boost::json::basic_parser<Adapter> parser;
+    boost::json::error_code            error; ///< first failure; later calls report it again
+
+    Impl(JsonEventParser const &owner, JsonEventHandler &handler, boost::json::parse_options const &options,
+         storage_type storage)
+        : parser(options, owner, handler, std::move(storage))
+    {
+    }
+};
+
+JsonEventParser::JsonEventParser(
+    JsonEventHandler                 &handler,
+    boost::json::parse_options const &options,
+    storage_type                      storage
+)
+    : impl_(std::make_unique<Impl>(*this, handler, options, std::move(storage)))
+{
+}
+
+JsonEventParser::~JsonEventParser() = default;
+
+bool JsonEventParser::write(std::string_view chunk)
+{
+    if (impl_->parser.handler().stopped())
+    {
+        return false;
+    }
+    if (!impl_->error)
+    {
+        if (impl_->parser.done())
+        {
+            // the document ended in an earlier chunk
+            if (!chunk.empty())
+            {
+                impl_->error = boost::json::make_error_code(boost::json::error::extra_data);
+            }
+        }
+        else
+        {
+            auto const consumed = impl_->parser.write_some(true, chunk.data(), chunk.size(), impl_->error);
+            if (impl_->parser.handler().stopped())
+            {
+                return false;
+            }
+            // the parser stops after the document, as boost::json::stream_parser does
+            if (!impl_->error && consumed < chunk.size())
+            {
+                impl_->error = boost::json::make_error_code(boost::json::error::extra_data);
+            }
+        }
+    }
+    if (impl_->error)
+    {
+        throw std::invalid_argument("cannot parse json: " + impl_->error.message());
+    }
+    return true;
+}
+
+bool JsonEventParser::finish()
+{
+    if (impl_->parser.handler().stopped())
+    {
+        return false;
+    }
+    if (!impl_->error && !impl_->parser.done())
+    {
+        impl_->parser.write_some(false, nullptr, 0, impl_->error);
+        if (impl_->parser.handler().stopped())
+        {
+            return false;
+        }
+    }
+    if (impl_->error)
+    {
+        throw std::invalid_argument("cannot parse json: " + impl_->error.message());
+    }
+    return true;
+}
+
+std::span<JsonPathSegment const> JsonEventParser::path() const
+{
+    return impl_->parser.handler().path();
+}
+
+size_t JsonEventParser::depth() const
+{
+    return impl_->parser.handler().depth();
+}
+
+JsonKeyPath JsonEventParser::keyPath() const
+{
+    return to_key_path(path());
+}
+
+bool JsonEventParser::parse(std::string_view text, JsonEventHandler &handler, boost::json::parse_options const &options)
+{
+    JsonEventParser parser(handler, options);
+    return parser.write(text) && parser.finish();
+}
+
+bool JsonEventParser::parseFile(
+    std::string const                &filename,
+    JsonEventHandler                 &handler,
+    boost::json::parse_options const &options,
+    size_t                            chunkSize
+)
+{
+    std::ifstream ifs(filename, std::ios::binary);
+    if (!ifs.is_open())
+    {
+        throw std::invalid_argument(filename + " cannot be opened for reading");
+    }
+    JsonEventParser   parser(handler, options);
+    std::vector<char> buffer(chunkSize == 0 ? 1 : chunkSize);
+    while (ifs)
+    {
+        ifs.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        auto const got = static_cast<size_t>(ifs.gcount());
+        if (got > 0 && !parser.write(std::string_view{buffer.data(), got}))
+        {
+            return false;
+        }
+    }
+    return parser.finish();
+}
+
+} // namespace util
@@ -0,0 +1,213 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   src/json_fragment_cache.cc
+ * Description: cache of serialized json subtrees
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_fragment_cache.h"
+
+#include "json_struct_mapping.h"
+
+namespace util
+{
+JsonFragmentCache::JsonFragmentCache(JsonFragmentCache const & /*other*/)
+{
+}
+
+JsonFragmentCache &JsonFragmentCache::operator=(JsonFragmentCache const &other)
+{
+    if (this != &other)
+    {
+        invalidateAll();
+    }
+    return *this;
+}
+
+std::string JsonFragmentCache::serialize(value_type const &root)
+{
+    std::lock_guard const lock(mutex_);
+    render(root_, root);
+    std::string out;
+    out.reserve(root_.size);
+    emit(out, root_);
+    return out;
+}
+
+void JsonFragmentCache::invalidate(JsonKeyPath const &path)
+{
+    std::lock_guard const lock(mutex_);
+    Node                 *node = &root_;
+    for (auto const &key: path.getKeys())
+    {
+        node->valid = false;
+        if (key->isIndex())
+        {
+            auto const *indexKey = static_cast<JsonIndexKey const *>(key.get());
+            if (indexKey->isStartSymbol() || indexKey->isSelector())
+            {
+                // prepending shifts every element, and a selector may address any of them
+                node->elements.clear();
+                return;
+            }
+            if (indexKey->isEndSymbol())
+            {
+                // appending leaves the existing elements untouched
+                return;
+            }
+            auto const idx = static_cast<size_t>(indexKey->getIndex(node->elements.size()));
+            if (idx >= node->elements.size() || !node->elements[idx])
+            {
+                return;
+            }
+            node = node->elements[idx].get();
+        }
+        else
+        {
+            auto found = node->members.find(static_cast<JsonStringKey const *>(key.get())->getKey());
+            if (found == node->members.end() || !found->second)
+            {
+                return;
+            }
+            node = found->second.get();
+        }
+    }
+    node->valid = false;
+    node->members.clear();
+    node->elements.clear();
+}
+
+void JsonFragmentCache::invalidateAll()
+{
+    std::lock_guard const lock(mutex_);
+    root_ = Node{};
+}
+
+size_t JsonFragmentCache::cachedBytes()
+{
+    std::lock_guard const lock(mutex_);
+    return bytes(root_);
+}
+
+void JsonFragmentCache::render(Node &node, value_type const &value)
+{
+    if (node.kind != value.kind())
+    {
+        node.valid = false;
+        node.kind  = value.kind();
+        node.members.clear();
+        node.elements.clear();
+    }
+    if (node.valid)
+    {
+        return;
+    }
+    node.text.clear();
+    node.splices.clear();
+    node.size = 0;
+    if (value.is_object())
+    {
+        node.text += '{';
+        bool first = true;
+        for (auto const &member: value.get_object())
+        {
+            if (!first)
+            {
+                node.text += ',';
+            }
+            first = false;
+            std::string_view const key{member.key().data(), member.key().size()};
+            append_json_string(node.text, key);
+            node.text += ':';
+            auto found = node.members.find(key);
+            if (found == node.members.end())
+            {
+                found = node.members.emplace(std::string{key}, nullptr).first;
+            }
+            appendChild(node, found->second, member.value());
+        }
+        node.text += '}';
+    }
+    else if (value.is_array())
+    {
+        auto const &arr = value.get_array();
+        node.elements.resize(arr.size());
+        node.text += '[';
+        for (size_t i = 0; i < arr.size(); ++i)
+        {
+            if (i > 0)
+            {
+                node.text += ',';
+            }
+            appendChild(node, node.elements[i], arr[i]);
+        }
+        node.text += ']';
+    }
+    else
+    {
+        node.text = to_json_string(value);
+    }
+    node.size += node.text.size();
+    node.valid = true;
+}
+
+void JsonFragmentCache::appendChild(Node &node, NodePtr &child, value_type const &value)
+{
+    if (!value.is_structured())
+    {
+        // scalars are cheaper to render than to cache
+        child.reset();
+        node.text += to_json_string(value);
+        return;
+    }
+    if (!child)
+    {
+        child = std::make_unique<Node>();
+    }
+    render(*child, value);
+    // the child's text stays in the child; only where it goes is recorded
+    node.splices.push_back(Splice{node.text.size(), child.get()});
+    node.size += child->size;
+}
+
+void JsonFragmentCache::emit(std::string &out, Node const &node)
+{
+    size_t pos = 0;
+    for (auto const &splice: node.splices)
+    {
+        out.append(node.text, pos, splice.offset - pos);
+        emit(out, *splice.child);
+        pos = splice.offset;
+    }
+    out.append(node.text, pos);
+}
+
+size_t JsonFragmentCache::bytes(Node const &node)
+{
+    size_t total = node.text.size();
+    for (auto const &splice: node.splices)
+    {
+        total += bytes(*splice.child);
+    }
+    return total;
+}
+
+} // namespace util
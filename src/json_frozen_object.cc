@@ -0,0 +1,624 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   src/json_frozen_object.cc
+ * Description: immutable, contiguous copy of a json object for fast lookups
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_frozen_object.h"
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <sstream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace util
+{
+namespace
+{
+uint64_t mixHash(uint64_t h)
+{
+    // splitmix64 finaliser
+    h ^= h >> 30U;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27U;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31U;
+    return h;
+}
+
+uint64_t hashKey(std::string_view key)
+{
+    return mixHash(std::hash<std::string_view>{}(key));
+}
+
+uint64_t hashHandle(char const* interned)
+{
+    return mixHash(reinterpret_cast<uintptr_t>(interned));
+}
+
+uint64_t slotHash(uint64_t keyHash, uint32_t displacement)
+{
+    return mixHash(keyHash ^ ((displacement + 1ULL) * 0x9e3779b97f4a7c15ULL));
+}
+
+std::string_view viewOf(boost::json::string const& str)
+{
+    return {str.data(), str.size()};
+}
+} // namespace
+
+struct FrozenJsonObject::Data
+{
+    enum class Kind : uint8_t
+    {
+        null,
+        boolean,
+        int64,
+        uint64,
+        real,
+        string,
+        array,
+        object
+    };
+
+    /**
+     * 16 bytes per value. payload holds the scalar bits, the arena offset of a string or the index of the first
+     * child of a container; for large objects the upper 32 bits hold the offset of the hash table in hashData, or
+     * npos if no perfect hash was found and the members are sorted like those of a small object.
+     */
+    struct Node
+    {
+        uint64_t payload = 0;
+        uint32_t size    = 0;
+        Kind     kind    = Kind::null;
+    };
+
+    struct Key
+    {
+        std::string_view text;
+        uint64_t         hash = 0;
+    };
+
+    std::vector<Node>                   nodes;
+    std::vector<Key>                    keys; ///< key of each node that is an object member
+    std::string                         arena;
+    std::vector<uint32_t>               hashData; ///< per large object: m, b, b displacements, m slots
+    std::shared_ptr<JsonKeyInternTable> keyTable;
+
+    static uint32_t firstChild(Node const& node)
+    {
+        return static_cast<uint32_t>(node.payload);
+    }
+
+    static uint32_t hashOffset(Node const& node)
+    {
+        return static_cast<uint32_t>(node.payload >> 32U);
+    }
+
+    static bool isSorted(Node const& node)
+    {
+        return node.size <= smallObjectSize || hashOffset(node) == npos;
+    }
+
+    /**
+     * Hash of a stored key: of its text, or with an intern table of its handle.
+     */
+    [[nodiscard]] uint64_t keyHash(std::string_view stored) const
+    {
+        return keyTable ? hashHandle(stored.data()) : hashKey(stored);
+    }
+
+    /**
+     * Handle of key in the intern table, taken from pathKey if that was interned in the same table. An invalid
+     * handle means that no object of the layout has the key, or that there is no table.
+     */
+    [[nodiscard]] InternedKey handleOf(std::string_view key, JsonStringKey const* pathKey = nullptr) const
+    {
+        if (!keyTable)
+        {
+            return {};
+        }
+        if (pathKey != nullptr && pathKey->internTable() == keyTable.get())
+        {
+            return pathKey->getInterned();
+        }
+        return keyTable->find(key).value_or(InternedKey{});
+    }
+
+    [[nodiscard]] uint32_t findMember(Node const& node, std::string_view key, InternedKey handle) const
+    {
+        if (keyTable)
+        {
+            return handle.valid() ? findHandle(node, handle.view().data()) : npos;
+        }
+        uint32_t const first = firstChild(node);
+        auto const     equal = [&](Key const& candidate) { return candidate.text == key; };
+        if (isSorted(node))
+        {
+            auto const begin = keys.begin() + first;
+            auto const end   = begin + node.size;
+            auto const found = std::lower_bound(
+                begin,
+                end,
+                key,
+                [](Key const& candidate, std::string_view k) { return candidate.text < k; }
+            );
+            return found != end && equal(*found) ? static_cast<uint32_t>(found - keys.begin()) : npos;
+        }
+        uint32_t const* table        = &hashData[hashOffset(node)];
+        uint32_t const  m            = table[0];
+        uint32_t const  b            = table[1];
+        uint64_t const  h            = hashKey(key);
+        uint32_t const  displacement = table[2 + h % b];
+        uint32_t const  slot         = table[2 + b + slotHash(h, displacement) % m];
+        return slot != npos && equal(keys[first + slot]) ? first + slot : npos;
+    }
+
+    /**
+     * Look up a member by the address of its interned key; small objects are sorted by that address.
+     */
+    [[nodiscard]] uint32_t findHandle(Node const& node, char const* handle) const
+    {
+        uint32_t const first = firstChild(node);
+        if (isSorted(node))
+        {
+            auto const begin = keys.begin() + first;
+            auto const end   = begin + node.size;
+            auto const found = std::lower_bound(
+                begin,
+                end,
+                handle,
+                [](Key const& candidate, char const* h) { return std::less<>{}(candidate.text.data(), h); }
+            );
+            return found != end && found->text.data() == handle ? static_cast<uint32_t>(found - keys.begin()) : npos;
+        }
+        uint32_t const* table        = &hashData[hashOffset(node)];
+        uint32_t const  m            = table[0];
+        uint32_t const  b            = table[1];
+        uint64_t const  h            = hashHandle(handle);
+        uint32_t const  displacement = table[2 + h % b];
+        uint32_t const  slot         = table[2 + b + slotHash(h, displacement) % m];
+        return slot != npos && keys[first + slot].text.data() == handle ? first + slot : npos;
+    }
+};
+
+class FrozenJsonObject::Builder
+{
+    Data&                                                  data_;
+    std::unordered_map<std::string_view, std::string_view> localKeys_;
+    uint32_t                                               next_ = 1;
+
+    static void count(value_type const& json, size_t& nodes, size_t& bytes)
+    {
+        ++nodes;
+        if (json.is_string())
+        {
+            bytes += json.get_string().size();
+        }
+        else if (json.is_array())
+        {
+            for (auto const& child : json.get_array())
+            {
+                count(child, nodes, bytes);
+            }
+        }
+        else if (json.is_object())
+        {
+            for (auto const& member : json.get_object())
+            {
+                bytes += member.key().size();
+                count(member.value(), nodes, bytes);
+            }
+        }
+    }
+
+    std::string_view storeKey(std::string_view key)
+    {
+        if (data_.keyTable)
+        {
+            return data_.keyTable->intern(key).view();
+        }
+        auto found = localKeys_.find(key);
+        if (found != localKeys_.end())
+        {
+            return found->second;
+        }
+        // the arena was reserved up front, so views into it stay valid
+        auto const offset = data_.arena.size();
+        data_.arena.append(key);
+        std::string_view const stored{data_.arena.data() + offset, key.size()};
+        localKeys_.emplace(stored, stored);
+        return stored;
+    }
+
+    /**
+     * Place the members of a large object in a perfect hash table.
+     * @return false if no table was found, e.g. because two keys have the same hash
+     */
+    bool buildPerfectHash(Data::Node& node, uint32_t first)
+    {
+        static constexpr int maxAttempts = 8;
+        uint32_t const n = node.size;
+        uint32_t const b = (n + 3U) / 4U;
+        uint32_t       m = n + n / 4U + 1U;
+        std::vector<std::vector<uint32_t>> buckets(b);
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            buckets[data_.keys[first + i].hash % b].push_back(i);
+        }
+        std::vector<uint32_t> order(b);
+        for (uint32_t i = 0; i < b; ++i)
+        {
+            order[i] = i;
+        }
+        std::ranges::sort(order, [&](uint32_t lhs, uint32_t rhs) { return buckets[lhs].size() > buckets[rhs].size(); });
+
+        std::vector<uint32_t> displacements;
+        std::vector<uint32_t> slots;
+        bool                  placed = false;
+        for (int attempt = 0; attempt < maxAttempts && !placed; ++attempt)
+        {
+            displacements.assign(b, 0);
+            slots.assign(m, npos);
+            placed = true;
+            for (uint32_t bucket : order)
+            {
+                auto const&           members = buckets[bucket];
+                std::vector<uint32_t> tried(members.size());
+                bool                  found = false;
+                for (uint32_t displacement = 0; displacement < (1U << 16U) && !found; ++displacement)
+                {
+                    found = true;
+                    for (size_t j = 0; j < members.size() && found; ++j)
+                    {
+                        tried[j] = static_cast<uint32_t>(slotHash(data_.keys[first + members[j]].hash, displacement) % m);
+                        found    = slots[tried[j]] == npos && std::find(tried.begin(), tried.begin() + j, tried[j]) ==
+                                                                   tried.begin() + j;
+                    }
+                    if (found)
+                    {
+                        displacements[bucket] = displacement;
+                        for (size_t j = 0; j < members.size(); ++j)
+                        {
+                            slots[tried[j]] = members[j];
+                        }
+                    }
+                }
+                if (!found)
+                {
+                    placed = false;
+                    m += m / 2U;
+                    break;
+                }
+            }
+        }
+        if (!placed)
+        {
+            return false;
+        }
+        auto const offset = data_.hashData.size();
+        data_.hashData.push_back(m);
+        data_.hashData.push_back(b);
+        data_.hashData.insert(data_.hashData.end(), displacements.begin(), displacements.end());
+        data_.hashData.insert(data_.hashData.end(), slots.begin(), slots.end());
+        node.payload |= static_cast<uint64_t>(offset) << 32U;
+        return true;
+    }
+
+    void build(value_type const& json, uint32_t at)
+    {
+        // children are reserved as one contiguous block before any of them is filled in
+        Data::Node node;
+        switch (json.kind())
+        {
+            case boost::json::kind::null:
+                break;
+            case boost::json::kind::bool_:
+                node.kind    = Data::Kind::boolean;
+                node.payload = json.get_bool() ? 1 : 0;
+                break;
+            case boost::json::kind::int64:
+                node.kind    = Data::Kind::int64;
+                node.payload = std::bit_cast<uint64_t>(json.get_int64());
+                break;
+            case boost::json::kind::uint64:
+                node.kind    = Data::Kind::uint64;
+                node.payload = json.get_uint64();
+                break;
+            case boost::json::kind::double_:
+                node.kind    = Data::Kind::real;
+                node.payload = std::bit_cast<uint64_t>(json.get_double());
+                break;
+            case boost::json::kind::string:
+            {
+                auto const text = viewOf(json.get_string());
+                node.kind       = Data::Kind::string;
+                node.payload    = data_.arena.size();
+                node.size       = static_cast<uint32_t>(text.size());
+                data_.arena.append(text);
+                break;
+            }
+            case boost::json::kind::array:
+            {
+                auto const& arr   = json.get_array();
+                uint32_t    first = next_;
+                node.kind         = Data::Kind::array;
+                node.payload      = first;
+                node.size         = static_cast<uint32_t>(arr.size());
+                next_ += node.size;
+                for (uint32_t i = 0; i < node.size; ++i)
+                {
+                    build(arr[i], first + i);
+                }
+                break;
+            }
+            case boost::json::kind::object:
+            {
+                auto const&                                               obj   = json.get_object();
+                uint32_t                                                  first = next_;
+                std::vector<std::pair<std::string_view, value_type const*>> members;
+                members.reserve(obj.size());
+                for (auto const& member : obj)
+                {
+                    members.emplace_back(storeKey({member.key().data(), member.key().size()}), &member.value());
+                }
+                node.kind    = Data::Kind::object;
+                node.payload = first;
+                node.size    = static_cast<uint32_t>(members.size());
+                next_ += node.size;
+                auto const storeKeys = [&] {
+                    for (uint32_t i = 0; i < node.size; ++i)
+                    {
+                        data_.keys[first + i] = {members[i].first, data_.keyHash(members[i].first)};
+                    }
+                };
+                auto const sortMembers = [&] {
+                    if (data_.keyTable)
+                    {
+                        std::ranges::sort(members, std::less<>{}, [](auto const& member) {
+                            return member.first.data();
+                        });
+                    }
+                    else
+                    {
+                        std::ranges::sort(members, {}, &std::pair<std::string_view, value_type const*>::first);
+                    }
+                    storeKeys();
+                };
+                if (node.size <= smallObjectSize)
+                {
+                    sortMembers();
+                }
+                else
+                {
+                    storeKeys();
+                    if (!buildPerfectHash(node, first))
+                    {
+                        // fall back to binary search, which does not depend on the hashes being distinct
+                        node.payload |= static_cast<uint64_t>(npos) << 32U;
+                        sortMembers();
+                    }
+                }
+                for (uint32_t i = 0; i < node.size; ++i)
+                {
+                    build(*members[i].second, first + i);
+                }
+                break;
+            }
+        }
+        data_.nodes[at] = node;
+    }
+
+  public:
+    explicit Builder(Data& data)
+        : data_(data)
+    {
+    }
+
+    void operator()(value_type const& json)
+    {
+        size_t nodes = 0;
+        size_t bytes = 0;
+        count(json, nodes, bytes);
+        data_.nodes.resize(nodes);
+        data_.keys.resize(nodes);
+        data_.arena.reserve(bytes);
+        build(json, 0);
+    }
+};
+
+FrozenJsonObject::FrozenJsonObject(value_type const& json, std::shared_ptr<JsonKeyInternTable> keyTable)
+{
+    auto data      = std::make_shared<Data>();
+    data->keyTable = std::move(keyTable);
+    Builder{*data}(json);
+    data_ = std::move(data);
+}
+
+value_type FrozenJsonObject::get(std::string_view path, std::optional<value_type> const& defaultValue) const
+{
+    return get(makePath(path), defaultValue);
+}
+
+value_type FrozenJsonObject::get(JsonKeyPath const& path, std::optional<value_type> const& defaultValue) const
+{
+    uint32_t const node = locate(path, defaultValue.has_value());
+    return node != npos ? materialize(node) : defaultValue.value();
+}
+
+value_type FrozenJsonObject::toValue() const
+{
+    return materialize(0);
+}
+
+size_t FrozenJsonObject::nodeCount() const
+{
+    return data_->nodes.size();
+}
+
+size_t FrozenJsonObject::memoryUsage() const
+{
+    return sizeof(Data) + data_->nodes.capacity() * sizeof(Data::Node) + data_->keys.capacity() * sizeof(Data::Key) +
+           data_->arena.capacity() + data_->hashData.capacity() * sizeof(uint32_t);
+}
+
+JsonKeyPath FrozenJsonObject::makePath(std::string_view path) const
+{
+    // not interned: looking up keys that are not in the table must not add them
+    return JsonKeyPath{path};
+}
+
+int64_t FrozenJsonObject::select(uint32_t array, JsonIndexKey const& selector) const
+{
+    auto const&       node   = data_->nodes[array];
+    uint32_t const    first  = Data::firstChild(node);
+    InternedKey const handle = data_->handleOf(selector.selectorField());
+    for (uint32_t idx = 0; idx < node.size; ++idx)
+    {
+        auto const& element = data_->nodes[first + idx];
+        if (element.kind != Data::Kind::object)
+        {
+            continue;
+        }
+        uint32_t const member = data_->findMember(element, selector.selectorField(), handle);
+        if (member != npos && JsonIndexKey::selectorText(materialize(member)) == selector.selectorValue())
+        {
+            return idx;
+        }
+    }
+    return -1;
+}
+
+uint32_t FrozenJsonObject::locate(JsonKeyPath const& path, bool allowMissing) const
+{
+    uint32_t current = 0;
+    for (auto const& key: path.getKeys())
+    {
+        auto const& node = data_->nodes[current];
+        if (key->isIndex())
+        {
+            auto const* indexKey = static_cast<JsonIndexKey const*>(key.get());
+            if (node.kind != Data::Kind::array)
+            {
+                throw std::invalid_argument("key '" + key->toString() + "' and array-container are incompatible");
+            }
+            int64_t idx = indexKey->isSelector() ? select(current, *indexKey) : indexKey->getIndex(node.size);
+            if (idx < 0 || idx >= static_cast<int64_t>(node.size))
+            {
+                if (allowMissing)
+                {
+                    return npos;
+                }
+                if (indexKey->isSelector())
+                {
+                    throw missing_key_error("Missing key: " + key->toString());
+                }
+                std::ostringstream ss;
+                ss << "Index '" << idx << "' is out of bounds [0.." << static_cast<int64_t>(node.size) - 1 << "]";
+                throw std::invalid_argument(ss.str());
+            }
+            current = Data::firstChild(node) + static_cast<uint32_t>(idx);
+        }
+        else
+        {
+            auto const* stringKey = static_cast<JsonStringKey const*>(key.get());
+            if (node.kind != Data::Kind::object)
+            {
+                throw std::invalid_argument("key '" + key->toString() + "' and object-container are incompatible");
+            }
+            auto const&    name = stringKey->getKey();
+            uint32_t const next = data_->findMember(node, name, data_->handleOf(name, stringKey));
+            if (next == npos)
+            {
+                if (allowMissing)
+                {
+                    return npos;
+                }
+                throw missing_key_error("Missing key: " + stringKey->getKey());
+            }
+            current = next;
+        }
+    }
+    return current;
+}
+
+bool FrozenJsonObject::isNull(uint32_t node) const
+{
+    return data_->nodes[node].kind == Data::Kind::null;
+}
+
+std::string_view FrozenJsonObject::stringAt(uint32_t node) const
+{
+    auto const& n = data_->nodes[node];
+    if (n.kind != Data::Kind::string)
+    {
+        throw std::invalid_argument("json value is not a string");
+    }
+    return {data_->arena.data() + n.payload, n.size};
+}
+
+value_type FrozenJsonObject::materialize(uint32_t node) const
+{
+    auto const& n = data_->nodes[node];
+    switch (n.kind)
+    {
+        case Data::Kind::null:
+            return nullptr;
+        case Data::Kind::boolean:
+            return n.payload != 0;
+        case Data::Kind::int64:
+            return std::bit_cast<int64_t>(n.payload);
+        case Data::Kind::uint64:
+            return n.payload;
+        case Data::Kind::real:
+            return std::bit_cast<double>(n.payload);
+        case Data::Kind::string:
+            return value_type{stringAt(node)};
+        case Data::Kind::array:
+        {
+            array_type arr;
+            arr.reserve(n.size);
+            for (uint32_t i = 0; i < n.size; ++i)
+            {
+                arr.push_back(materialize(Data::firstChild(n) + i));
+            }
+            return arr;
+        }
+        case Data::Kind::object:
+        {
+            object_type obj;
+            obj.reserve(n.size);
+            for (uint32_t i = 0; i < n.size; ++i)
+            {
+                uint32_t const child = Data::firstChild(n) + i;
+                obj.emplace(data_->keys[child].text, materialize(child));
+            }
+            return obj;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace util
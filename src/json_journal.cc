@@ -0,0 +1,499 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   src/json_journal.cc
+ * Description: append-only journal of json object updates
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_journal.h"
+
+#include "json_struct_mapping.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace util
+{
+namespace
+{
+std::string headerRecord(JsonSnapshotDigest const &snapshot)
+{
+    return "{\"op\":\"snapshot\",\"size\":" + std::to_string(snapshot.size)
+           + ",\"hash\":" + std::to_string(snapshot.hash) + "}\n";
+}
+
+bool matchesHeader(std::string const &line, JsonSnapshotDigest const &snapshot)
+{
+    try
+    {
+        auto const  parsed = from_json_string(line);
+        auto const &header = parsed.as_object();
+        return header.at("op").as_string() == "snapshot"
+               && JsonSnapshotDigest{header.at("size").to_number<uint64_t>(), header.at("hash").to_number<uint64_t>()}
+                      == snapshot;
+    }
+    catch (std::exception const &)
+    {
+        return false;
+    }
+}
+
+std::string errnoText(std::string const &what, std::string const &filename)
+{
+    return what + " " + filename + " failed: " + std::strerror(errno);
+}
+
+void writeAll(int fd, std::string_view data, std::string const &filename)
+{
+    while (!data.empty())
+    {
+        auto const written = ::write(fd, data.data(), data.size());
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::runtime_error(errnoText("writing", filename));
+        }
+        data.remove_prefix(static_cast<size_t>(written));
+    }
+}
+
+void syncFile(int fd, std::string const &filename)
+{
+    if (::fdatasync(fd) != 0)
+    {
+        throw std::runtime_error(errnoText("syncing", filename));
+    }
+}
+
+/**
+ * Write a whole file and sync it, so a following rename cannot expose a partially written file.
+ */
+void writeDurably(std::string const &filename, std::string_view text)
+{
+    int const fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        throw std::runtime_error(errnoText("creating", filename));
+    }
+    try
+    {
+        writeAll(fd, text, filename);
+        syncFile(fd, filename);
+    }
+    catch (...)
+    {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+}
+
+void syncDirectoryOf(std::string const &filename)
+{
+    auto directory = std::filesystem::path{filename}.parent_path();
+    if (directory.empty())
+    {
+        directory = ".";
+    }
+    int const fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0)
+    {
+        // directories cannot be synced on every file system; the rename is still atomic
+        ::fsync(fd);
+        ::close(fd);
+    }
+}
+
+JsonJournalRecord parseRecord(std::string const &line)
+{
+    auto const  parsed = from_json_string(line);
+    auto const &record = parsed.as_object();
+    auto const &op     = record.at("op").as_string();
+    if (op == "clear")
+    {
+        JsonJournalRecord clear;
+        clear.operation = JsonJournalRecord::Operation::clear;
+        return clear;
+    }
+    if (op == "insert")
+    {
+        auto const &path = record.at("path").as_string();
+        JsonJournalRecord insert;
+        insert.operation = JsonJournalRecord::Operation::insert;
+        insert.path      = std::string{path.data(), path.size()};
+        insert.value     = record.at("values").as_array();
+        insert.index     = record.at("index").to_number<size_t>();
+        insert.force     = record.at("force").as_bool();
+        return insert;
+    }
+    if (op == "replace")
+    {
+        JsonJournalRecord replace;
+        replace.operation = JsonJournalRecord::Operation::replace;
+        replace.value     = record.at("value");
+        return replace;
+    }
+    if (op != "set")
+    {
+        throw std::invalid_argument("unknown journal operation");
+    }
+    auto const &path = record.at("path").as_string();
+    return JsonJournalRecord{
+        .operation = JsonJournalRecord::Operation::set,
+        .path      = std::string{path.data(), path.size()},
+        .value     = record.at("value"),
+        .force     = record.at("force").as_bool()
+    };
+}
+
+} // namespace
+
+void JsonSnapshotDigest::update(std::string_view text)
+{
+    // FNV-1a, so the digest does not depend on the standard library the snapshot was written with
+    for (char const c : text)
+    {
+        if (c == '\n')
+        {
+            continue;
+        }
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1'099'511'628'211ULL;
+        ++size;
+    }
+}
+
+JsonSnapshotDigest JsonSnapshotDigest::of(std::string_view text)
+{
+    JsonSnapshotDigest digest;
+    digest.update(text);
+    return digest;
+}
+
+JsonJournal::JsonJournal(std::string snapshotFile, JsonJournalOptions options, Loader loader)
+    : snapshotFile_(std::move(snapshotFile))
+    , journalFile_(journalFileName(snapshotFile_))
+    , options_(options)
+    , loader_(std::move(loader))
+{
+    fd_ = ::open(journalFile_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0)
+    {
+        throw std::invalid_argument(journalFile_ + " cannot be opened for writing");
+    }
+    flusher_ = std::jthread([this](std::stop_token const &stop) { run(stop); });
+}
+
+JsonJournal::~JsonJournal()
+{
+    {
+        std::lock_guard const lock(mutex_);
+        stopping_ = true;
+    }
+    flusher_.request_stop();
+    wakeFlusher_.notify_one();
+    flusher_.join();
+    try
+    {
+        commit();
+    }
+    catch (std::exception const &)
+    {
+        // nothing left to report it to; the records appended since the last successful commit are lost
+    }
+    ::close(fd_);
+}
+
+void JsonJournal::appendSet(JsonKeyPath const &path, value_type const &value, bool force)
+{
+    std::string record{"{\"op\":\"set\",\"path\":"};
+    append_json_string(record, path.toString());
+    record += force ? ",\"force\":true,\"value\":" : ",\"force\":false,\"value\":";
+    record += to_json_string(value);
+    record += "}\n";
+    append(std::move(record));
+}
+
+void JsonJournal::appendClear()
+{
+    append("{\"op\":\"clear\"}\n");
+}
+
+void JsonJournal::appendInsert(JsonKeyPath const &path, size_t index, std::span<value_type const> values, bool force)
+{
+    std::string record{"{\"op\":\"insert\",\"path\":"};
+    append_json_string(record, path.toString());
+    record += ",\"index\":" + std::to_string(index);
+    record += force ? ",\"force\":true,\"values\":[" : ",\"force\":false,\"values\":[";
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        if (i > 0)
+        {
+            record += ',';
+        }
+        record += to_json_string(values[i]);
+    }
+    record += "]}\n";
+    append(std::move(record));
+}
+
+void JsonJournal::appendReplace(value_type const &document)
+{
+    std::string record{"{\"op\":\"replace\",\"value\":"};
+    record += to_json_string(document);
+    record += "}\n";
+    append(std::move(record));
+}
+
+void JsonJournal::append(std::string record)
+{
+    std::unique_lock lock(mutex_);
+    if (!failure_.empty())
+    {
+        // a record after a lost one would be replayed on the wrong state
+        return;
+    }
+    buffer_ += record;
+    journalBytes_ += record.size();
+    auto const seq = ++appendedSeq_;
+    if (buffer_.size() >= options_.maxBatchBytes)
+    {
+        wakeFlusher_.notify_one();
+    }
+    if (options_.waitForSync)
+    {
+        wakeFlusher_.notify_one();
+        // a failed commit is left in failure_ for the owner
+        synced_.wait(lock, [this, seq] { return syncedSeq_ >= seq || !failure_.empty(); });
+    }
+}
+
+void JsonJournal::commit()
+{
+    std::lock_guard const writeLock(writeMutex_);
+    std::string           batch;
+    uint64_t              seq = 0;
+    {
+        std::lock_guard const lock(mutex_);
+        if (!failure_.empty())
+        {
+            throw std::runtime_error(failure_);
+        }
+        if (buffer_.empty())
+        {
+            return;
+        }
+        batch.swap(buffer_);
+        seq = appendedSeq_;
+    }
+    try
+    {
+        writeAll(fd_, batch, journalFile_);
+        syncFile(fd_, journalFile_);
+    }
+    catch (std::runtime_error const &error)
+    {
+        std::lock_guard const lock(mutex_);
+        failure_ = error.what();
+        synced_.notify_all();
+        throw;
+    }
+    std::lock_guard const lock(mutex_);
+    syncedSeq_ = seq;
+    synced_.notify_all();
+}
+
+void JsonJournal::run(std::stop_token const &stop)
+{
+    while (!stop.stop_requested())
+    {
+        {
+            std::unique_lock lock(mutex_);
+            wakeFlusher_.wait_for(lock, options_.commitInterval, [this] {
+                return stopping_ || buffer_.size() >= options_.maxBatchBytes
+                       || (options_.waitForSync && !buffer_.empty());
+            });
+            if (!failure_.empty())
+            {
+                continue;
+            }
+        }
+        try
+        {
+            commit();
+            if (loader_ && compactionDue())
+            {
+                compactFromFiles();
+            }
+        }
+        catch (std::exception const &error)
+        {
+            // reported by failure(); a failed commit has already recorded itself
+            std::lock_guard const lock(mutex_);
+            if (failure_.empty())
+            {
+                failure_ = error.what();
+                synced_.notify_all();
+            }
+        }
+    }
+}
+
+void JsonJournal::flush()
+{
+    commit();
+}
+
+void JsonJournal::compact(value_type const &document)
+{
+    // holding the write lock keeps the flusher from committing buffered records to the journal that is replaced
+    std::lock_guard const writeLock(writeMutex_);
+    replaceSnapshot(to_json_string(document), true);
+}
+
+void JsonJournal::compactFromFiles()
+{
+    std::lock_guard const writeLock(writeMutex_);
+    // the files hold exactly the committed records; the buffered ones are committed to the new journal afterwards
+    replaceSnapshot(to_json_string(loader_(snapshotFile_)), false);
+}
+
+void JsonJournal::replaceSnapshot(std::string const &snapshotText, bool coversBuffer)
+{
+    auto const tmpFile = snapshotFile_ + ".tmp";
+    writeDurably(tmpFile, snapshotText + "\n");
+    // the rename is the commit point: until then the old snapshot and its journal are intact, afterwards the old
+    // journal no longer matches the snapshot and is ignored by replay()
+    if (::rename(tmpFile.c_str(), snapshotFile_.c_str()) != 0)
+    {
+        throw std::runtime_error(errnoText("renaming", tmpFile));
+    }
+    syncDirectoryOf(snapshotFile_);
+    uint64_t seq = 0;
+    {
+        std::lock_guard const lock(mutex_);
+        if (coversBuffer)
+        {
+            // buffered records are part of the snapshot, so they are done with
+            buffer_.clear();
+        }
+        journalBytes_ = buffer_.size();
+        seq           = coversBuffer ? appendedSeq_ : syncedSeq_;
+    }
+    try
+    {
+        if (::ftruncate(fd_, 0) != 0)
+        {
+            throw std::runtime_error(errnoText("truncating", journalFile_));
+        }
+        writeAll(fd_, headerRecord(JsonSnapshotDigest::of(snapshotText)), journalFile_);
+        syncFile(fd_, journalFile_);
+    }
+    catch (std::runtime_error const &error)
+    {
+        std::lock_guard const lock(mutex_);
+        failure_ = error.what();
+        synced_.notify_all();
+        throw;
+    }
+    std::lock_guard const lock(mutex_);
+    syncedSeq_ = seq;
+    if (coversBuffer)
+    {
+        // the snapshot holds the whole document, including whatever the failed commit lost
+        failure_.clear();
+    }
+    synced_.notify_all();
+}
+
+std::string JsonJournal::failure() const
+{
+    std::lock_guard const lock(mutex_);
+    return failure_;
+}
+
+bool JsonJournal::compactionDue() const
+{
+    std::lock_guard const lock(mutex_);
+    return options_.compactAfterBytes > 0 && journalBytes_ >= options_.compactAfterBytes;
+}
+
+size_t JsonJournal::journalBytes() const
+{
+    std::lock_guard const lock(mutex_);
+    return journalBytes_;
+}
+
+std::string JsonJournal::journalFileName(std::string const &snapshotFile)
+{
+    return snapshotFile + ".journal";
+}
+
+size_t JsonJournal::replay(
+    std::string const                                    &snapshotFile,
+    JsonSnapshotDigest const                             &snapshot,
+    std::function<void(JsonJournalRecord const &)> const &apply
+)
+{
+    std::ifstream ifs(journalFileName(snapshotFile));
+    if (!ifs.is_open())
+    {
+        return 0;
+    }
+    std::string line;
+    if (!std::getline(ifs, line) || !matchesHeader(line, snapshot))
+    {
+        return 0;
+    }
+    size_t replayed = 0;
+    while (std::getline(ifs, line))
+    {
+        // a record is complete only with its newline; a torn last record was never acknowledged as synced
+        if (ifs.eof())
+        {
+            break;
+        }
+        JsonJournalRecord record;
+        try
+        {
+            record = parseRecord(line);
+        }
+        catch (std::exception const &error)
+        {
+            throw std::invalid_argument(
+                journalFileName(snapshotFile) + " record " + std::to_string(replayed + 1) + " is corrupt: " + error.what()
+            );
+        }
+        apply(record);
+        ++replayed;
+    }
+    return replayed;
+}
+
+} // namespace util
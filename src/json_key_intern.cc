@@ -0,0 +1,80 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   src/json_key_intern.cc
+ * Description: table of interned json object keys, shared across documents
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_key_intern.h"
+
+#include <mutex>
+
+namespace util
+{
+InternedKey JsonKeyInternTable::intern(std::string_view key)
+{
+    {
+        std::shared_lock const lock(mutex_);
+        auto                   found = keys_.find(key);
+        if (found != keys_.end())
+        {
+            return InternedKey{&*found};
+        }
+    }
+    std::unique_lock const lock(mutex_);
+    auto [inserted, isNew] = keys_.emplace(key);
+    if (isNew)
+    {
+        bytes_ += inserted->size();
+    }
+    return InternedKey{&*inserted};
+}
+
+std::optional<InternedKey> JsonKeyInternTable::find(std::string_view key) const
+{
+    std::shared_lock const lock(mutex_);
+    auto                   found = keys_.find(key);
+    if (found == keys_.end())
+    {
+        return std::nullopt;
+    }
+    return InternedKey{&*found};
+}
+
+size_t JsonKeyInternTable::size() const
+{
+    std::shared_lock const lock(mutex_);
+    return keys_.size();
+}
+
+size_t JsonKeyInternTable::bytes() const
+{
+    std::shared_lock const lock(mutex_);
+    return bytes_;
+}
+
+std::shared_ptr<JsonKeyInternTable> const &JsonKeyInternTable::shared()
+{
+    static auto const table = std::make_shared<JsonKeyInternTable>();
+    return table;
+}
+
+} // namespace util
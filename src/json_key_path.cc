@@ -24,36 +24,66 @@
  */
 #include "json_key_path.h"
 
+#include "json_metrics.h"
+
+#include <charconv>
+
 namespace util
 {
-JsonStringKey::JsonStringKey(std::string const &key)
-    : key_(key)
+char const *JsonStringKey::invalidReason(std::string_view key)
 {
-    if (key_.empty())
+    if (key.empty())
     {
-        throw std::invalid_argument("JsonStringKey cannot be empty string");
+        return "JsonStringKey cannot be empty string";
     }
     if (key[0] == ' ' || key[0] == '\t' || key[key.size() - 1] == ' ' || key[key.size() - 1] == '\t')
     {
-        throw std::invalid_argument("JsonStringKey cannot start or end in whitespace");
+        return "JsonStringKey cannot start or end in whitespace";
     }
-    if (key_.contains('[') || key_.contains(']') || key_.contains('\n') || key_.contains('\r'))
+    if (key.contains('[') || key.contains(']') || key.contains('\n') || key.contains('\r'))
     {
-        throw std::invalid_argument("JsonStringKey cannot contain `[`,`]`, `\\n` or `\\r`");
+        return "JsonStringKey cannot contain `[`,`]`, `\\n` or `\\r`";
     }
-    if (key_.contains('[') || key.contains(']') || key_.contains('\n') || key_.contains('\r'))
+    if (key.find_first_not_of("0123456789") == std::string_view::npos)
     {
-        throw std::invalid_argument("JsonStringKey cannot contain `[`,`]`, `\\n` or `\\r`");
+        return "JsonStringKey must contain at least one non-numeric character";
     }
-    if (key_.find_first_not_of("0123456789") == std::string::npos)
+    return nullptr;
+}
+
+void JsonStringKey::validate(std::string_view key)
+{
+    if (char const *reason = invalidReason(key))
     {
-        throw std::invalid_argument("JsonStringKey must contain at least one non-numeric character");
+        throw std::invalid_argument(reason);
     }
 }
 
+bool JsonStringKey::isValid(std::string_view key)
+{
+    return invalidReason(key) == nullptr;
+}
+
+JsonStringKey::JsonStringKey(std::string_view key)
+    : key_(key)
+{
+    validate(key_);
+}
+
+JsonStringKey::JsonStringKey(std::string_view key, std::shared_ptr<JsonKeyInternTable> const &table)
+    : table_(table)
+{
+    validate(key);
+    if (!table)
+    {
+        throw std::invalid_argument("JsonStringKey needs an intern table");
+    }
+    interned_ = table->intern(key);
+}
+
 std::string JsonStringKey::toString() const
 {
-    return key_;
+    return getKey();
 }
 
 bool JsonStringKey::isIndex() const
@@ -63,15 +93,61 @@ bool JsonStringKey::isIndex() const
 
 std::string const &JsonStringKey::getKey() const
 {
-    return key_;
+    return interned_.valid() ? interned_.str() : key_;
+}
+
+InternedKey JsonStringKey::getInterned() const
+{
+    return interned_;
 }
 
-JsonIndexKey::JsonIndexKey(std::string const &idx)
+JsonKeyInternTable const *JsonStringKey::internTable() const
 {
+    return table_.get();
+}
+
+char const *JsonIndexKey::invalidReason(std::string_view idx)
+{
+    if (auto const equals = idx.find('='); equals != std::string_view::npos && idx.size() >= 2 && idx[0] == '[' &&
+                                           idx[idx.size() - 1] == ']')
+    {
+        auto const field = idx.substr(1, equals - 1);
+        auto const value = idx.substr(equals + 1, idx.size() - equals - 2);
+        if (!JsonStringKey::isValid(field) || value.empty() || value.find_first_of("[]") != std::string_view::npos)
+        {
+            return "JsonIndexKey selectors must be of format '\\[field=value\\]' with a valid string key as field";
+        }
+        return nullptr;
+    }
     if (idx.size() < 3 || idx[0] != '[' || idx[idx.size() - 1] != ']' ||
-        idx.find_first_not_of("[0123456789]^$") != std::string::npos)
+        idx.find_first_not_of("[0123456789]^$") != std::string_view::npos)
+    {
+        return "JsonIndexKeys must be of format '\\[^|$|[0-9]+\\]'";
+    }
+    if (idx == "[^]" || idx == "[$]")
+    {
+        return nullptr;
+    }
+    auto const digits = idx.substr(1, idx.size() - 2);
+    int64_t    index  = 0;
+    auto const [end, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), index);
+    if (ec != std::errc{} || end != digits.data() + digits.size())
     {
-        throw std::invalid_argument("JsonIndexKeys must be of format '\\[^|$|[0-9]+\\]'");
+        return "Cannot create valid index from JsonIndexKey";
+    }
+    return nullptr;
+}
+
+bool JsonIndexKey::isValid(std::string_view idx)
+{
+    return invalidReason(idx) == nullptr;
+}
+
+JsonIndexKey::JsonIndexKey(std::string_view idx)
+{
+    if (char const *reason = invalidReason(idx))
+    {
+        throw std::invalid_argument(std::string(reason) + ": '" + std::string(idx) + "'");
     }
     if (idx == "[^]")
     {
@@ -83,24 +159,24 @@ JsonIndexKey::JsonIndexKey(std::string const &idx)
         isEndSymbol_ = true;
         index_       = -1; // Placeholder for end index_
     }
+    else if (auto const equals = idx.find('='); equals != std::string_view::npos)
+    {
+        selector_ = std::make_shared<Selector const>(
+            Selector{std::string{idx.substr(1, equals - 1)}, std::string{idx.substr(equals + 1, idx.size() - equals - 2)}}
+        );
+        index_ = -1;
+    }
     else
     {
-        try
-        {
-            auto withoutBrackets = idx.substr(1, idx.size() - 2);
-            index_               = std::stoi(withoutBrackets);
-        }
-        catch (...)
-        {
-            throw std::invalid_argument("Cannot create valid index_ from '" + idx + "'");
-        }
-        if (index_ < 0)
-        {
-            throw std::invalid_argument("Index cannot be negative: " + idx);
-        }
+        std::from_chars(idx.data() + 1, idx.data() + idx.size() - 1, index_);
     }
 }
 
+JsonIndexKey::JsonIndexKey(size_t idx)
+    : index_(static_cast<int64_t>(idx))
+{
+}
+
 std::string JsonIndexKey::toString() const
 {
     if (isStartSymbol_)
@@ -111,6 +187,10 @@ std::string JsonIndexKey::toString() const
     {
         return "[$]";
     }
+    if (selector_)
+    {
+        return "[" + selector_->field + "=" + selector_->value + "]";
+    }
     return std::format("[{}]", std::to_string(index_));
 }
 
@@ -129,41 +209,213 @@ bool JsonIndexKey::isEndSymbol() const
     return isEndSymbol_;
 }
 
+bool JsonIndexKey::isSelector() const
+{
+    return selector_ != nullptr;
+}
+
+std::string_view JsonIndexKey::selectorField() const
+{
+    return selector_ ? std::string_view{selector_->field} : std::string_view{};
+}
+
+std::string_view JsonIndexKey::selectorValue() const
+{
+    return selector_ ? std::string_view{selector_->value} : std::string_view{};
+}
+
+std::optional<std::string> JsonIndexKey::selectorText(boost::json::value const &member)
+{
+    switch (member.kind())
+    {
+        case boost::json::kind::string:
+            return std::string{member.get_string()};
+        case boost::json::kind::int64:
+            return std::to_string(member.get_int64());
+        case boost::json::kind::uint64:
+            return std::to_string(member.get_uint64());
+        case boost::json::kind::bool_:
+            return member.get_bool() ? "true" : "false";
+        default:
+            return std::nullopt;
+    }
+}
+
+std::optional<std::string> JsonIndexKey::selectorText(boost::json::value const &element, std::string_view field)
+{
+    if (!element.is_object())
+    {
+        return std::nullopt;
+    }
+    auto const *member = element.get_object().if_contains(field);
+    return member != nullptr ? selectorText(*member) : std::nullopt;
+}
+
 int64_t JsonIndexKey::getIndex(boost::json::array const &array) const
 {
+    if (!selector_)
+    {
+        return getIndex(array.size());
+    }
+    for (size_t idx = 0; idx < array.size(); ++idx)
+    {
+        auto const *member = array[idx].is_object() ? array[idx].get_object().if_contains(selector_->field) : nullptr;
+        if (member == nullptr)
+        {
+            continue;
+        }
+        // compare strings in place; only the other kinds need their text
+        bool const matches = member->is_string()
+                                 ? std::string_view{member->get_string().data(), member->get_string().size()} ==
+                                       selector_->value
+                                 : selectorText(*member) == selector_->value;
+        if (matches)
+        {
+            return static_cast<int64_t>(idx);
+        }
+    }
+    return -1;
+}
+
+int64_t JsonIndexKey::getIndex(size_t size) const
+{
+    if (selector_)
+    {
+        return -1;
+    }
     if (isStartSymbol_)
     {
         return 0;
     }
     if (isEndSymbol_)
     {
-        return static_cast<int64_t>(array.size() - 1);
+        return static_cast<int64_t>(size) - 1;
     }
     return index_;
 }
 
-JsonKeyPath::JsonKeyPath(std::string const &path)
+JsonKeyPath::JsonKeyPath(std::string_view path)
+{
+    parse(path, nullptr);
+}
+
+JsonKeyPath::JsonKeyPath(std::string_view path, std::shared_ptr<JsonKeyInternTable> const &table)
+{
+    parse(path, table);
+}
+
+namespace
+{
+/**
+ * Call f for each non-empty segment of path, until it returns false.
+ */
+template<typename F>
+bool forEachSegment(std::string_view path, F &&f)
 {
-    std::istringstream stream(path);
-    std::string        segment;
+    size_t begin = 0;
+    while (begin <= path.size())
+    {
+        size_t end = path.find('/', begin);
+        if (end == std::string_view::npos)
+        {
+            end = path.size();
+        }
+        if (end > begin && !f(path.substr(begin, end - begin)))
+        {
+            return false;
+        }
+        begin = end + 1;
+    }
+    return true;
+}
+
+bool isIndexSegment(std::string_view segment)
+{
+    return segment.front() == '[' && segment.back() == ']';
+}
+} // namespace
+
+void JsonKeyPath::parse(std::string_view path, std::shared_ptr<JsonKeyInternTable> const &table)
+{
+    JSONOBJECT_METRICS_SCOPE(JsonOperation::keyPathParse);
     if (path.empty())
     {
         throw std::invalid_argument("Empty JsonKeyPath is not allowed");
     }
-    while (std::getline(stream, segment, '/'))
-    {
-        if (!segment.empty())
+    // upper bound of the segment count, so that the key vector is allocated once
+    keys_.reserve(static_cast<size_t>(std::ranges::count(path, '/')) + 1);
+    forEachSegment(
+        path,
+        [this, &table](std::string_view segment)
         {
-            if (segment.front() == '[' && segment.back() == ']')
+            if (isIndexSegment(segment))
             {
                 keys_.emplace_back(std::make_shared<JsonIndexKey>(segment));
             }
+            else if (table != nullptr)
+            {
+                keys_.emplace_back(std::make_shared<JsonStringKey>(segment, table));
+            }
             else
             {
                 keys_.emplace_back(std::make_shared<JsonStringKey>(segment));
             }
+            return true;
+        }
+    );
+}
+
+std::expected<JsonKeyPath, JsonPathError>
+    JsonKeyPath::tryParse(std::string_view path, std::shared_ptr<JsonKeyInternTable> const &table)
+{
+    JSONOBJECT_METRICS_SCOPE(JsonOperation::keyPathParse);
+    if (path.empty())
+    {
+        return std::unexpected(JsonPathError{json_errc::empty_path});
+    }
+    // validate first, so that the constructors below cannot throw
+    size_t     segmentCount = 0;
+    bool const valid        = forEachSegment(
+        path,
+        [&segmentCount](std::string_view segment)
+        {
+            bool const ok = isIndexSegment(segment) ? JsonIndexKey::isValid(segment) : JsonStringKey::isValid(segment);
+            segmentCount += ok ? 1 : 0;
+            return ok;
         }
+    );
+    if (!valid)
+    {
+        return std::unexpected(JsonPathError{json_errc::invalid_key, segmentCount});
     }
+    JsonKeyPath result;
+    result.keys_.reserve(segmentCount);
+    forEachSegment(
+        path,
+        [&result, &table](std::string_view segment)
+        {
+            if (isIndexSegment(segment))
+            {
+                result.keys_.emplace_back(std::make_shared<JsonIndexKey>(segment));
+            }
+            else if (table != nullptr)
+            {
+                result.keys_.emplace_back(std::make_shared<JsonStringKey>(segment, table));
+            }
+            else
+            {
+                result.keys_.emplace_back(std::make_shared<JsonStringKey>(std::string{segment}));
+            }
+            return true;
+        }
+    );
+    return result;
+}
+
+JsonKeyPath &JsonKeyPath::append(std::shared_ptr<JsonKey> key)
+{
+    keys_.emplace_back(std::move(key));
+    return *this;
 }
 
 size_t JsonKeyPath::size() const
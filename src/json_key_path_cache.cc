@@ -0,0 +1,157 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   src/json_key_path_cache.cc
+ * Description: bounded, thread-safe cache of parsed key-paths
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_key_path_cache.h"
+
+#include "json_metrics.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace util
+{
+JsonKeyPathCache::JsonKeyPathCache(size_t capacity, std::shared_ptr<JsonKeyInternTable> table, size_t shards)
+    : table_(std::move(table))
+    , shardCount_(std::max<size_t>(shards, 1))
+    , shardCapacity_(std::max<size_t>((capacity + shardCount_ - 1) / shardCount_, 1))
+    , shards_(std::make_unique<Shard[]>(shardCount_))
+{
+}
+
+JsonKeyPathCache::~JsonKeyPathCache() = default;
+
+JsonKeyPathCache::Shard &JsonKeyPathCache::shardOf(std::string_view path) const
+{
+    return shards_[std::hash<std::string_view>{}(path) % shardCount_];
+}
+
+JsonKeyPathCache::PathPtr JsonKeyPathCache::find(Shard &shard, std::string_view path) const
+{
+    std::lock_guard const lock(shard.mutex);
+    auto const            found = shard.index.find(path);
+    if (found == shard.index.end())
+    {
+        ++shard.misses;
+        return nullptr;
+    }
+    ++shard.hits;
+    shard.lru.splice(shard.lru.begin(), shard.lru, found->second);
+    return found->second->path;
+}
+
+JsonKeyPathCache::PathPtr JsonKeyPathCache::insert(Shard &shard, std::string_view path, PathPtr parsed) const
+{
+    std::lock_guard const lock(shard.mutex);
+    // another thread may have parsed the same path meanwhile
+    auto const found = shard.index.find(path);
+    if (found != shard.index.end())
+    {
+        return found->second->path;
+    }
+    shard.lru.push_front(Entry{.text = std::string{path}, .path = parsed});
+    shard.index.emplace(shard.lru.front().text, shard.lru.begin());
+    if (shard.lru.size() > shardCapacity_)
+    {
+        shard.index.erase(shard.lru.back().text);
+        shard.lru.pop_back();
+        ++shard.evictions;
+    }
+    return parsed;
+}
+
+JsonKeyPathCache::PathPtr JsonKeyPathCache::get(std::string_view path)
+{
+    auto &shard = shardOf(path);
+    if (auto cached = find(shard, path))
+    {
+        JSONOBJECT_METRICS_ADD(JsonCounter::keyPathCacheHits, 1);
+        return cached;
+    }
+    JSONOBJECT_METRICS_ADD(JsonCounter::keyPathCacheMisses, 1);
+    // parse outside the lock, so a slow parse does not hold up other lookups in the shard; the text is only copied
+    // when insert() stores it
+    auto parsed = std::make_shared<JsonKeyPath const>(path, table_);
+    return insert(shard, path, std::move(parsed));
+}
+
+std::expected<JsonKeyPathCache::PathPtr, JsonPathError> JsonKeyPathCache::tryGet(std::string_view path)
+{
+    auto &shard = shardOf(path);
+    if (auto cached = find(shard, path))
+    {
+        JSONOBJECT_METRICS_ADD(JsonCounter::keyPathCacheHits, 1);
+        return cached;
+    }
+    JSONOBJECT_METRICS_ADD(JsonCounter::keyPathCacheMisses, 1);
+    auto parsed = JsonKeyPath::tryParse(path, table_);
+    if (!parsed)
+    {
+        return std::unexpected(parsed.error());
+    }
+    return insert(shard, path, std::make_shared<JsonKeyPath const>(std::move(*parsed)));
+}
+
+void JsonKeyPathCache::clear()
+{
+    for (size_t i = 0; i < shardCount_; ++i)
+    {
+        std::lock_guard const lock(shards_[i].mutex);
+        shards_[i].index.clear();
+        shards_[i].lru.clear();
+    }
+}
+
+JsonKeyPathCacheStats JsonKeyPathCache::stats() const
+{
+    JsonKeyPathCacheStats result;
+    for (size_t i = 0; i < shardCount_; ++i)
+    {
+        std::lock_guard const lock(shards_[i].mutex);
+        result.hits += shards_[i].hits;
+        result.misses += shards_[i].misses;
+        result.evictions += shards_[i].evictions;
+        result.size += shards_[i].lru.size();
+    }
+    return result;
+}
+
+size_t JsonKeyPathCache::capacity() const
+{
+    return shardCapacity_ * shardCount_;
+}
+
+JsonKeyInternTable *JsonKeyPathCache::table() const
+{
+    return table_.get();
+}
+
+std::shared_ptr<JsonKeyPathCache> const &JsonKeyPathCache::shared()
+{
+    // leaked, so that paths can still be looked up from destructors of static objects
+    static auto const *const cache = new std::shared_ptr<JsonKeyPathCache>(std::make_shared<JsonKeyPathCache>());
+    return *cache;
+}
+
+} // namespace util
@@ -0,0 +1,74 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   src/json_memory.cc
+ * Description: memory accounting for json documents
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_memory.h"
+
+namespace util
+{
+TrackingMemoryResource::TrackingMemoryResource(boost::json::storage_ptr upstream)
+    : upstream_(std::move(upstream))
+{
+}
+
+JsonMemoryUsage TrackingMemoryResource::usage() const
+{
+    return JsonMemoryUsage{
+        .liveBytes     = liveBytes_.load(std::memory_order_relaxed),
+        .peakBytes     = peakBytes_.load(std::memory_order_relaxed),
+        .allocations   = allocations_.load(std::memory_order_relaxed),
+        .deallocations = deallocations_.load(std::memory_order_relaxed),
+    };
+}
+
+void TrackingMemoryResource::resetPeak()
+{
+    peakBytes_.store(liveBytes_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void* TrackingMemoryResource::do_allocate(size_t bytes, size_t align)
+{
+    void* ptr = upstream_->allocate(bytes, align);
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+    size_t const live = liveBytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    size_t       peak = peakBytes_.load(std::memory_order_relaxed);
+    while (live > peak && !peakBytes_.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {
+    }
+    return ptr;
+}
+
+void TrackingMemoryResource::do_deallocate(void* ptr, size_t bytes, size_t align)
+{
+    upstream_->deallocate(ptr, bytes, align);
+    deallocations_.fetch_add(1, std::memory_order_relaxed);
+    liveBytes_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+bool TrackingMemoryResource::do_is_equal(boost::json::memory_resource const& other) const noexcept
+{
+    return this == &other;
+}
+
+} // namespace util
@@ -0,0 +1,290 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   src/json_merge.cc
+ * Description: deep merge of layered json documents
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_merge.h"
+
+#include "json_parallel.h"
+
+#include <algorithm>
+#include <exception>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+namespace util
+{
+namespace
+{
+template<bool Move>
+using Layer = std::conditional_t<Move, value_type, value_type const>;
+
+/**
+ * Hand a value of a layer on: moved from if the layers are consumed, copied otherwise.
+ */
+template<bool Move>
+decltype(auto) pass(Layer<Move> &value)
+{
+    if constexpr (Move)
+    {
+        return std::move(value);
+    }
+    else
+    {
+        return value;
+    }
+}
+
+template<bool Move>
+class Merger
+{
+    struct Segment
+    {
+        std::string_view key{};
+        size_t           index   = 0;
+        bool             isIndex = false;
+    };
+
+    JsonMergePolicy const &policy_;
+    std::vector<Segment>   path_; ///< location of the values merged, only needed to report a conflict
+
+  public:
+    explicit Merger(JsonMergePolicy const &policy)
+        : policy_(policy)
+    {
+    }
+
+    void enter(std::string_view key)
+    {
+        path_.push_back(Segment{.key = key});
+    }
+
+    void enter(size_t index)
+    {
+        path_.push_back(Segment{.index = index, .isIndex = true});
+    }
+
+    void leave()
+    {
+        path_.pop_back();
+    }
+
+    void merge(value_type &target, Layer<Move> &source)
+    {
+        if (is_object(target) && is_object(source))
+        {
+            auto &targetObj = target.as_object();
+            for (auto &member : source.as_object())
+            {
+                enter(std::string_view{member.key().data(), member.key().size()});
+                if (auto *existing = targetObj.if_contains(member.key()); existing != nullptr)
+                {
+                    merge(*existing, member.value());
+                }
+                else
+                {
+                    targetObj.emplace(member.key(), pass<Move>(member.value()));
+                }
+                leave();
+            }
+            return;
+        }
+        if (is_array(target) && is_array(source) && policy_.arrays != JsonArrayMergePolicy::replace)
+        {
+            auto  &targetArr = target.as_array();
+            auto  &sourceArr = source.as_array();
+            size_t appendFrom = 0;
+            if (policy_.arrays == JsonArrayMergePolicy::byIndex)
+            {
+                appendFrom = std::min(targetArr.size(), sourceArr.size());
+                for (size_t i = 0; i < appendFrom; ++i)
+                {
+                    enter(i);
+                    merge(targetArr[i], sourceArr[i]);
+                    leave();
+                }
+            }
+            targetArr.reserve(targetArr.size() + sourceArr.size() - appendFrom);
+            for (size_t i = appendFrom; i < sourceArr.size(); ++i)
+            {
+                targetArr.push_back(pass<Move>(sourceArr[i]));
+            }
+            return;
+        }
+        switch (policy_.conflicts)
+        {
+            case JsonConflictPolicy::lastWins:
+                target = pass<Move>(source);
+                break;
+            case JsonConflictPolicy::firstWins:
+                break;
+            case JsonConflictPolicy::error:
+                if (target != source)
+                {
+                    throw merge_conflict_error("Conflicting values at key: " + pathString());
+                }
+                break;
+        }
+    }
+
+  private:
+    [[nodiscard]] std::string pathString() const
+    {
+        std::string path;
+        for (auto const &segment : path_)
+        {
+            if (!path.empty())
+            {
+                path += '/';
+            }
+            path += segment.isIndex ? "[" + std::to_string(segment.index) + "]" : std::string{segment.key};
+        }
+        return path;
+    }
+};
+
+template<bool Move>
+value_type mergeSerially(std::span<Layer<Move> *const> layers, JsonMergePolicy const &policy)
+{
+    value_type   result{pass<Move>(*layers.front()), layers.front()->storage()};
+    Merger<Move> merger{policy};
+    for (auto *layer : layers.subspan(1))
+    {
+        merger.merge(result, *layer);
+    }
+    return result;
+}
+
+/**
+ * Members with different top-level keys never touch each other, so each key is merged through all layers
+ * independently, and contiguous ranges of keys are merged on the pool.
+ */
+template<bool Move>
+value_type mergeInParallel(std::span<Layer<Move> *const> layers, JsonMergePolicy const &policy)
+{
+    struct Group
+    {
+        std::string_view            key;
+        std::vector<Layer<Move> *>  values;
+        value_type                  merged;
+        std::exception_ptr          conflict;
+    };
+
+    std::vector<Group>                           groups;
+    std::unordered_map<std::string_view, size_t> groupOfKey;
+    for (auto *layer : layers)
+    {
+        for (auto &member : layer->as_object())
+        {
+            std::string_view const key{member.key().data(), member.key().size()};
+            auto [found, isNew] = groupOfKey.try_emplace(key, groups.size());
+            if (isNew)
+            {
+                groups.emplace_back().key = key;
+            }
+            groups[found->second].values.push_back(&member.value());
+        }
+    }
+
+    auto const storage   = layers.front()->storage();
+    auto const mergeKeys = [&groups, &policy, &storage](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i)
+        {
+            auto &group = groups[i];
+            try
+            {
+                Merger<Move> merger{policy};
+                merger.enter(group.key);
+                group.merged = value_type{pass<Move>(*group.values.front()), storage};
+                for (auto *value : std::span{group.values}.subspan(1))
+                {
+                    merger.merge(group.merged, *value);
+                }
+                merger.leave();
+            }
+            catch (...)
+            {
+                // kept per key, so that the conflict of the first key is reported whichever thread found it first
+                group.conflict = std::current_exception();
+            }
+        }
+    };
+
+    // the calling thread takes keys too, so the merge cannot deadlock when it runs on a worker of the pool
+    json_parallel_for(
+        groups.size(), mergeKeys, JsonParallelOptions{.pool = policy.pool, .chunkSize = 1, .minParallelSize = 2}
+    );
+    for (auto const &group : groups)
+    {
+        if (group.conflict)
+        {
+            std::rethrow_exception(group.conflict);
+        }
+    }
+
+    object_type result{storage};
+    result.reserve(groups.size());
+    for (auto &group : groups)
+    {
+        result.emplace(group.key, std::move(group.merged));
+    }
+    return result;
+}
+
+template<bool Move>
+value_type mergeLayers(std::span<Layer<Move> *const> layers, JsonMergePolicy const &policy)
+{
+    if (layers.empty())
+    {
+        return object_type{};
+    }
+    bool const defaultStorage = layers.front()->storage().get() == storage_type{}.get();
+    bool const allObjects     = std::ranges::all_of(layers, [](auto const *layer) { return is_object(*layer); });
+    if (policy.parallel && defaultStorage && allObjects)
+    {
+        return mergeInParallel<Move>(layers, policy);
+    }
+    return mergeSerially<Move>(layers, policy);
+}
+
+} // namespace
+
+value_type json_merge(std::span<value_type const *const> layers, JsonMergePolicy const &policy)
+{
+    return mergeLayers<false>(layers, policy);
+}
+
+value_type json_merge(std::vector<value_type> &&layers, JsonMergePolicy const &policy)
+{
+    std::vector<value_type *> pointers;
+    pointers.reserve(layers.size());
+    for (auto &layer : layers)
+    {
+        pointers.push_back(&layer);
+    }
+    return mergeLayers<true>(std::span<value_type *const>{pointers}, policy);
+}
+
+} // namespace util
@@ -0,0 +1,267 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   src/json_metrics.cc
+ * Description: opt-in operation metrics for json objects
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_metrics.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace util
+{
+namespace
+{
+// per operation: calls, exceptions, total nanos, then the histogram buckets
+constexpr size_t operationSlots = 3 + jsonLatencyBucketCount;
+constexpr size_t slotCount      = jsonOperationCount * operationSlots + jsonCounterCount;
+
+using Totals = std::array<uint64_t, slotCount>;
+
+struct ThreadCounters
+{
+    std::array<std::atomic<uint64_t>, slotCount> slots{};
+
+    // only the owning thread writes, so a relaxed load/store pair is enough and avoids locked instructions
+    void add(size_t slot, uint64_t amount)
+    {
+        slots[slot].store(slots[slot].load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+};
+
+class Registry
+{
+    std::mutex                   mutex_;
+    std::vector<ThreadCounters*> live_;
+    Totals                       retired_{};
+    Totals                       baseline_{};
+
+    Totals sum()
+    {
+        Totals totals = retired_;
+        for (auto const* counters : live_)
+        {
+            for (size_t i = 0; i < slotCount; ++i)
+            {
+                totals[i] += counters->slots[i].load(std::memory_order_relaxed);
+            }
+        }
+        return totals;
+    }
+
+  public:
+    void add(ThreadCounters* counters)
+    {
+        std::lock_guard const lock(mutex_);
+        live_.push_back(counters);
+    }
+
+    void retire(ThreadCounters* counters)
+    {
+        std::lock_guard const lock(mutex_);
+        for (size_t i = 0; i < slotCount; ++i)
+        {
+            retired_[i] += counters->slots[i].load(std::memory_order_relaxed);
+        }
+        std::erase(live_, counters);
+    }
+
+    Totals snapshot()
+    {
+        std::lock_guard const lock(mutex_);
+        Totals                totals = sum();
+        for (size_t i = 0; i < slotCount; ++i)
+        {
+            totals[i] -= baseline_[i];
+        }
+        return totals;
+    }
+
+    void reset()
+    {
+        std::lock_guard const lock(mutex_);
+        baseline_ = sum();
+    }
+};
+
+Registry& registry()
+{
+    // never destroyed: threads may retire their counters during static destruction
+    static auto* instance = new Registry;
+    return *instance;
+}
+
+struct ThreadRegistration
+{
+    ThreadCounters counters;
+
+    ThreadRegistration()
+    {
+        registry().add(&counters);
+    }
+
+    ~ThreadRegistration()
+    {
+        registry().retire(&counters);
+    }
+};
+
+ThreadCounters& threadCounters()
+{
+    thread_local ThreadRegistration registration;
+    return registration.counters;
+}
+
+size_t latencyBucket(uint64_t nanos)
+{
+    return std::min(static_cast<size_t>(std::bit_width(nanos)), jsonLatencyBucketCount - 1);
+}
+} // namespace
+
+std::string_view to_string(JsonOperation operation)
+{
+    switch (operation)
+    {
+        case JsonOperation::keyPathParse:
+            return "key_path_parse";
+        case JsonOperation::find:
+            return "find";
+        case JsonOperation::get:
+            return "get";
+        case JsonOperation::set:
+            return "set";
+        case JsonOperation::load:
+            return "load";
+        case JsonOperation::write:
+            return "write";
+        case JsonOperation::toString:
+            return "to_string";
+    }
+    return "unknown";
+}
+
+std::string_view to_string(JsonCounter counter)
+{
+    switch (counter)
+    {
+        case JsonCounter::bytesParsed:
+            return "bytes_parsed";
+        case JsonCounter::bytesSerialized:
+            return "bytes_serialized";
+        case JsonCounter::defaultFallbacks:
+            return "default_fallbacks";
+        case JsonCounter::keyPathCacheHits:
+            return "key_path_cache_hits";
+        case JsonCounter::keyPathCacheMisses:
+            return "key_path_cache_misses";
+    }
+    return "unknown";
+}
+
+JsonOperationStats const& JsonMetricsSnapshot::operator[](JsonOperation operation) const
+{
+    return operations[std::to_underlying(operation)];
+}
+
+uint64_t JsonMetricsSnapshot::operator[](JsonCounter counter) const
+{
+    return counters[std::to_underlying(counter)];
+}
+
+value_type JsonMetricsSnapshot::toJson() const
+{
+    object_type json;
+    for (size_t op = 0; op < jsonOperationCount; ++op)
+    {
+        auto const& stats = operations[op];
+        array_type  histogram;
+        for (auto const bucket : stats.latencyHistogram)
+        {
+            histogram.push_back(value_type{bucket});
+        }
+        object_type entry;
+        entry["calls"]           = stats.calls;
+        entry["exceptions"]      = stats.exceptions;
+        entry["total_ns"]        = stats.totalNanos;
+        entry["latency_log2_ns"] = std::move(histogram);
+        json[to_string(static_cast<JsonOperation>(op))] = std::move(entry);
+    }
+    for (size_t counter = 0; counter < jsonCounterCount; ++counter)
+    {
+        json[to_string(static_cast<JsonCounter>(counter))] = counters[counter];
+    }
+    return json;
+}
+
+void JsonMetrics::record(JsonOperation operation, uint64_t nanos, bool threw)
+{
+    auto&        counters = threadCounters();
+    size_t const base     = std::to_underlying(operation) * operationSlots;
+    counters.add(base, 1);
+    if (threw)
+    {
+        counters.add(base + 1, 1);
+    }
+    counters.add(base + 2, nanos);
+    counters.add(base + 3 + latencyBucket(nanos), 1);
+}
+
+void JsonMetrics::add(JsonCounter counter, uint64_t amount)
+{
+    threadCounters().add(jsonOperationCount * operationSlots + std::to_underlying(counter), amount);
+}
+
+JsonMetricsSnapshot JsonMetrics::snapshot()
+{
+    Totals const        totals = registry().snapshot();
+    JsonMetricsSnapshot result;
+    for (size_t op = 0; op < jsonOperationCount; ++op)
+    {
+        size_t const base                = op * operationSlots;
+        result.operations[op].calls      = totals[base];
+        result.operations[op].exceptions = totals[base + 1];
+        result.operations[op].totalNanos = totals[base + 2];
+        std::copy_n(
+            totals.begin() + static_cast<ptrdiff_t>(base + 3),
+            jsonLatencyBucketCount,
+            result.operations[op].latencyHistogram.begin()
+        );
+    }
+    std::copy_n(
+        totals.begin() + static_cast<ptrdiff_t>(jsonOperationCount * operationSlots),
+        jsonCounterCount,
+        result.counters.begin()
+    );
+    return result;
+}
+
+void JsonMetrics::reset()
+{
+    registry().reset();
+}
+
+} // namespace util
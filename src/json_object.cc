@@ -25,8 +25,16 @@
 
 #include "json_object.h"
 
+#include "json_frozen_object.h"
+#include "json_traversal.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <filesystem>
 #include <fstream>
 #include <sstream>
+#include <stdexcept>
 
 namespace util
 {
@@ -35,61 +43,288 @@ JsonObject::JsonObject()
 {
 }
 
-JsonObject::JsonObject(std::string const& jsonStr)
+JsonObject::JsonObject(std::string_view jsonStr)
 {
+    JSONOBJECT_METRICS_ADD(JsonCounter::bytesParsed, jsonStr.size());
     json_ = from_json_string(jsonStr);
 }
 
+JsonObject::JsonObject(storage_type storage)
+    : json_(object_type{std::move(storage)})
+{
+}
+
+JsonObject::JsonObject(std::string_view jsonStr, storage_type storage)
+    : json_(from_json_string(jsonStr, std::move(storage))) // assignment would keep the default storage
+{
+    JSONOBJECT_METRICS_ADD(JsonCounter::bytesParsed, jsonStr.size());
+}
+
 void JsonObject::clear()
 {
-    json_ = object_type{};
+    json_ = object_type{json_.storage()};
+    indexes_.invalidateAll();
+    if (fragments_)
+    {
+        fragments_->invalidateAll();
+    }
+    resetCursors();
+    if (journal_)
+    {
+        journal_->appendClear();
+    }
+}
+
+storage_type const& JsonObject::storage() const
+{
+    return json_.storage();
+}
+
+std::optional<JsonMemoryUsage> JsonObject::memoryUsage() const
+{
+    auto const* tracking = dynamic_cast<TrackingMemoryResource const*>(json_.storage().get());
+    if (tracking == nullptr)
+    {
+        return std::nullopt;
+    }
+    return tracking->usage();
+}
+
+std::vector<std::pair<std::string, size_t>> JsonObject::memoryByTopLevelKey() const
+{
+    std::vector<std::pair<std::string, size_t>> breakdown;
+    if (!is_object(json_))
+    {
+        return breakdown;
+    }
+    for (auto const& member : json_.as_object())
+    {
+        storage_type const storage  = boost::json::make_shared_resource<TrackingMemoryResource>();
+        auto const*        tracking = static_cast<TrackingMemoryResource const*>(storage.get());
+        value_type const   copy{member.value(), storage};
+        // the key is allocated separately and the member occupies one slot of the top-level table
+        breakdown.emplace_back(
+            std::string{member.key().data(), member.key().size()},
+            tracking->usage().liveBytes + member.key().size() + 1 + sizeof(boost::json::key_value_pair)
+        );
+    }
+    std::ranges::sort(breakdown, [](auto const& lhs, auto const& rhs) { return lhs.second > rhs.second; });
+    return breakdown;
+}
+
+void JsonObject::useKeyPathCache(std::shared_ptr<JsonKeyPathCache> cache)
+{
+    pathCache_ = std::move(cache);
+}
+
+std::shared_ptr<JsonKeyPathCache> const& JsonObject::keyPathCache() const
+{
+    return pathCache_;
+}
+
+JsonKeyPathCache::PathPtr JsonObject::makePath(std::string_view path) const
+{
+    if (pathCache_)
+    {
+        return pathCache_->get(path);
+    }
+    return std::make_shared<JsonKeyPath const>(path);
+}
+
+std::expected<JsonKeyPathCache::PathPtr, JsonPathError> JsonObject::tryMakePath(std::string_view path) const
+{
+    if (pathCache_)
+    {
+        return pathCache_->tryGet(path);
+    }
+    auto parsed = JsonKeyPath::tryParse(path);
+    if (!parsed)
+    {
+        return std::unexpected(parsed.error());
+    }
+    return std::make_shared<JsonKeyPath const>(std::move(*parsed));
+}
+
+void JsonObject::enableFragmentCache(bool enable)
+{
+    if (enable)
+    {
+        fragments_.emplace();
+    }
+    else
+    {
+        fragments_.reset();
+    }
+}
+
+void JsonObject::enableJournal(std::string const& filename, JsonJournalOptions const& options)
+{
+    // the background thread compacts from the files, so that set() never waits for a new snapshot
+    auto journal = std::make_unique<JsonJournal>(filename, options, [](std::string const& snapshotFile) {
+        JsonObject replayed{};
+        replayed.load(snapshotFile);
+        return std::move(replayed.json_);
+    });
+    // the journal only holds changes, so it has to start from a snapshot of exactly this document
+    journal->compact(json_);
+    journal_.reset(std::move(journal));
+}
+
+void JsonObject::disableJournal()
+{
+    journal_.reset();
+}
+
+void JsonObject::flushJournal()
+{
+    if (journal_)
+    {
+        journal_->flush();
+    }
+}
+
+void JsonObject::compactJournal()
+{
+    if (journal_)
+    {
+        journal_->compact(json_);
+    }
+}
+
+JsonJournal const* JsonObject::journal() const
+{
+    return journal_.get();
+}
+
+void JsonObject::journalSet(JsonKeyPath const& path, value_type const& value, bool force, bool succeeded)
+{
+    // a failed forced set may have created containers before it failed; replaying it fails the same way
+    if (!journal_ || (!succeeded && !force))
+    {
+        return;
+    }
+    journal_->appendSet(path, value, force);
 }
 
 value_type& JsonObject::get()
 {
+    // the caller may change anything
+    indexes_.invalidateAll();
+    if (fragments_)
+    {
+        fragments_->invalidateAll();
+    }
+    resetCursors();
     return json_;
 }
 
-value_type JsonObject::get(std::string const& path, std::optional<value_type> const& defaultValue) const
+value_type JsonObject::get(std::string_view path, std::optional<value_type> const& defaultValue) const
 {
-    return get(JsonKeyPath{path}, defaultValue);
+    return get(*makePath(path), defaultValue);
 }
 
 value_type JsonObject::get(JsonKeyPath const& path, std::optional<value_type> const& defaultValue) const
 {
-    value_type const* current = &json_;
-    for (auto const& key: path.getKeys())
+    JSONOBJECT_METRICS_SCOPE(JsonOperation::get);
+    value_type const* found = find(json_, path, defaultValue.has_value());
+    if (found == nullptr)
     {
+        JSONOBJECT_METRICS_ADD(JsonCounter::defaultFallbacks, 1);
+        return defaultValue.value();
+    }
+    return *found;
+}
+
+value_type const* JsonObject::find(
+    value_type const&         root,
+    JsonKeyPath const&        path,
+    bool                      allowMissing,
+    JsonArrayIndexes::KeySpan base
+) const
+{
+    JSONOBJECT_METRICS_SCOPE(JsonOperation::find);
+    auto found = locate(root, path, base);
+    if (found)
+    {
+        return *found;
+    }
+    auto const code = found.error().code;
+    if (allowMissing && (code == json_errc::missing_key || code == json_errc::index_out_of_bounds))
+    {
+        return nullptr;
+    }
+    throwLookupError(root, path, found.error());
+}
+
+std::expected<value_type const*, JsonPathError>
+    JsonObject::locate(value_type const& root, JsonKeyPath const& path, JsonArrayIndexes::KeySpan base) const
+{
+    value_type const* current = &root;
+    auto const&       keys    = path.getKeys();
+    for (size_t segment = 0; segment < keys.size(); ++segment)
+    {
+        auto const& key = keys[segment];
         if (key->isIndex())
         {
-            auto const* indexKey = dynamic_cast<JsonIndexKey*>(key.get());
+            auto const* indexKey = static_cast<JsonIndexKey const*>(key.get());
             if (!is_array(current))
             {
-                throw std::invalid_argument("key '" + key->toString() + "' and array-container are incompatible");
+                return std::unexpected(JsonPathError{json_errc::expected_array, segment});
             }
-            int64_t idx = indexKey->getIndex(*as_array(current));
-            if (idx < 0 || idx >= static_cast<int64_t>(array_size(*as_array(current))))
+            auto const& arr = *as_array(current);
+            int64_t     idx = indexes_.resolve(base, std::span{keys}.first(segment), *indexKey, arr);
+            if (idx < 0 || idx >= static_cast<int64_t>(array_size(arr)))
             {
-                checkBounds(defaultValue, idx, current);
-                return defaultValue.value();
+                auto const code = indexKey->isSelector() ? json_errc::missing_key : json_errc::index_out_of_bounds;
+                return std::unexpected(JsonPathError{code, segment});
             }
-            current = &as_array(*current)[idx];
+            current = &arr[static_cast<size_t>(idx)];
         }
         else
         {
-            auto const* stringKey = dynamic_cast<JsonStringKey*>(key.get());
+            auto const* stringKey = static_cast<JsonStringKey const*>(key.get());
             if (!is_object(current))
             {
-                throw std::invalid_argument("key '" + key->toString() + "' and array-container are incompatible");
+                return std::unexpected(JsonPathError{json_errc::expected_object, segment});
+            }
+            value_type const* next = as_object(current)->if_contains(stringKey->getKey());
+            if (next == nullptr)
+            {
+                return std::unexpected(JsonPathError{json_errc::missing_key, segment});
             }
-            if (!as_object(current)->contains(stringKey->getKey()) && defaultValue)
+            current = next;
+        }
+    }
+    return current;
+}
+
+void JsonObject::throwLookupError(value_type const& root, JsonKeyPath const& path, JsonPathError const& error) const
+{
+    auto const& key = path.getKeys()[error.segment];
+    switch (error.code)
+    {
+        case json_errc::expected_array:
+            throw std::invalid_argument("key '" + key->toString() + "' and array-container are incompatible");
+        case json_errc::expected_object:
+            throw std::invalid_argument("key '" + key->toString() + "' and object-container are incompatible");
+        case json_errc::missing_key:
+            throw missing_key_error("Missing key: " + key->toString());
+        case json_errc::index_out_of_bounds:
+        {
+            // only on the error path: walk to the array again to report its size
+            JsonKeyPath prefix;
+            for (size_t i = 0; i < error.segment; ++i)
             {
-                return defaultValue.value();
+                prefix.append(path.getKeys()[i]);
             }
-            current = &as_object(current)->at(stringKey->getKey());
+            value_type const* container = *locate(root, prefix);
+            checkBounds(std::nullopt, static_cast<JsonIndexKey const*>(key.get())->getIndex(*as_array(container)), container);
+            break;
         }
+        default:
+            break;
     }
-    return *current;
+    throw std::invalid_argument(std::string{to_string(error.code)} + " at key '" + key->toString() + "'");
 }
 
 void JsonObject::checkBounds(
@@ -106,20 +341,163 @@ void JsonObject::checkBounds(
     }
 }
 
-void JsonObject::set(std::string const& path, value_type const& value, bool force)
+void JsonObject::set(std::string_view path, value_type const& value, bool force)
 {
-    set(JsonKeyPath{path}, value, force);
+    set(*makePath(path), value, force);
 }
 
 void JsonObject::set(JsonKeyPath const& path, value_type const& value, bool force)
 {
-    value_type* current = &json_;
+    JSONOBJECT_METRICS_SCOPE(JsonOperation::set);
+    auto result = trySetTracked(path, value, force);
+    if (!result)
+    {
+        throwSetError(path, result.error());
+    }
+}
+
+std::expected<void, JsonPathError> JsonObject::trySet(JsonKeyPath const& path, value_type const& value, bool force)
+{
+    JSONOBJECT_METRICS_SCOPE(JsonOperation::set);
+    return trySetTracked(path, value, force);
+}
+
+std::expected<void, JsonPathError>
+    JsonObject::trySetTracked(JsonKeyPath const& path, value_type const& value, bool force)
+{
+    auto const changes = indexes_.empty() ? std::vector<JsonArrayIndexes::Change>{}
+                                          : indexes_.prepare(json_, path, JsonArrayEdit::set);
+    auto       result  = trySetInternal(json_, path, value, force);
+    if (!changes.empty())
+    {
+        indexes_.apply(changes, result.has_value());
+    }
+    if (fragments_)
+    {
+        // also after a failure: forced containers may have been created before it
+        fragments_->invalidate(path);
+    }
+    journalSet(path, value, force, result.has_value());
+    return result;
+}
+
+std::expected<void, JsonPathError> JsonObject::trySet(std::string_view path, value_type const& value, bool force)
+{
+    auto parsed = tryMakePath(path);
+    if (!parsed)
+    {
+        return std::unexpected(parsed.error());
+    }
+    return trySet(**parsed, value, force);
+}
+
+std::expected<void, JsonPathError> JsonObject::trySetBelow(
+    value_type&        node,
+    JsonKeyPath const& prefix,
+    JsonKeyPath const& path,
+    value_type const&  value,
+    bool               force
+)
+{
+    if (!fragments_ && !journal_ && indexes_.empty())
+    {
+        return trySetInternal(node, path, value, force, prefix.getKeys());
+    }
+    // only the indexes, the caches and the journal need the full path
+    JsonKeyPath absolute = prefix;
+    for (auto const& key: path.getKeys())
+    {
+        absolute.append(key);
+    }
+    auto const changes = indexes_.empty() ? std::vector<JsonArrayIndexes::Change>{}
+                                          : indexes_.prepare(json_, absolute, JsonArrayEdit::set);
+    auto       result  = trySetInternal(node, path, value, force, prefix.getKeys());
+    if (!changes.empty())
+    {
+        indexes_.apply(changes, result.has_value());
+    }
+    if (fragments_)
+    {
+        fragments_->invalidate(absolute);
+    }
+    journalSet(absolute, value, force, result.has_value());
+    return result;
+}
+
+bool JsonObject::createIndex(JsonKeyPath const& arrayPath, std::string_view field)
+{
+    return indexes_.create(json_, arrayPath, field);
+}
+
+bool JsonObject::createIndex(std::string_view arrayPath, std::string_view field)
+{
+    return createIndex(arrayPath.empty() ? JsonKeyPath{} : *makePath(arrayPath), field);
+}
+
+bool JsonObject::dropIndex(JsonKeyPath const& arrayPath, std::string_view field)
+{
+    return indexes_.drop(arrayPath, field);
+}
+
+bool JsonObject::dropIndex(std::string_view arrayPath, std::string_view field)
+{
+    return dropIndex(arrayPath.empty() ? JsonKeyPath{} : *makePath(arrayPath), field);
+}
+
+JsonCursor JsonObject::cursor(JsonKeyPath const& path)
+{
+    return JsonCursor{*this, path};
+}
+
+JsonCursor JsonObject::cursor(std::string_view path)
+{
+    return JsonCursor{*this, *makePath(path)};
+}
+
+void JsonObject::throwSetError(JsonKeyPath const& path, JsonPathError const& error) const
+{
+    auto const& key = path.getKeys()[error.segment];
+    switch (error.code)
+    {
+        case json_errc::expected_array:
+            throw expected_array_error("Expected array at key: " + path.toString());
+        case json_errc::expected_object:
+            throw expected_object_error("Expected object at key: " + path.toString());
+        case json_errc::missing_key:
+            throw missing_key_error("Missing key: " + key->toString());
+        case json_errc::index_out_of_bounds:
+        {
+            std::ostringstream ss;
+            ss << "Index out of range: " << path.toString() << " at position '" << error.segment << "' ("
+               << key->toString() << ").";
+            if (error.segment < path.size() - 1)
+            {
+                ss << " Cannot extend any mid-path list when not forced.";
+            }
+            throw std::invalid_argument(ss.str());
+        }
+        default:
+            break;
+    }
+    throw std::invalid_argument(std::string{to_string(error.code)} + " at key '" + key->toString() + "'");
+}
+
+std::expected<void, JsonPathError>
+    JsonObject::trySetInternal(
+        value_type&               root,
+        JsonKeyPath const&        path,
+        value_type const&         value,
+        bool                      force,
+        JsonArrayIndexes::KeySpan base
+    )
+{
+    value_type* current = &root;
     for (size_t i = 0; i < path.size(); ++i)
     {
         auto const& key = path.getKeys()[i];
         if (key->isIndex())
         {
-            auto const* indexKey = dynamic_cast<JsonIndexKey*>(key.get());
+            auto const* indexKey = static_cast<JsonIndexKey const*>(key.get());
             if (!is_array(current))
             {
                 if (force)
@@ -128,11 +506,16 @@ void JsonObject::set(JsonKeyPath const& path, value_type const& value, bool forc
                 }
                 else
                 {
-                    throw expected_array_error("Expected array at key: " + path.toString());
+                    return std::unexpected(JsonPathError{json_errc::expected_array, i});
                 }
             }
             auto&   arr = as_array(*current);
-            int64_t idx = indexKey->getIndex(arr);
+            int64_t idx = indexes_.resolve(base, std::span{path.getKeys()}.first(i), *indexKey, arr);
+            if (idx < 0 && indexKey->isSelector())
+            {
+                // a selector cannot create the element it looks for
+                return std::unexpected(JsonPathError{json_errc::missing_key, i});
+            }
             if (idx >= static_cast<int64_t>(arr.size()) || idx < 0 || indexKey->isStartSymbol() ||
                 indexKey->isEndSymbol())
             {
@@ -143,11 +526,12 @@ void JsonObject::set(JsonKeyPath const& path, value_type const& value, bool forc
                     value_type extender = (i == path.size() - 1) ? value : value_type{};
                     if (indexKey->isStartSymbol())
                     {
-                        array_prepend(arr, extender);
+                        array_prepend(arr, std::move(extender));
+                        shifted(arr);
                     }
                     else if (indexKey->isEndSymbol())
                     {
-                        array_append(arr, extender);
+                        array_append(arr, std::move(extender));
                         idx = static_cast<int64_t>(array_size(arr) - 1UL);
                     }
                     else
@@ -157,26 +541,19 @@ void JsonObject::set(JsonKeyPath const& path, value_type const& value, bool forc
                 }
                 else
                 {
-                    std::ostringstream ss;
-                    ss << "Index out of range: " << path.toString() << " at position '" << i << "' (" << key->toString()
-                       << ").";
-                    if (i < path.size() - 1)
-                    {
-                        ss << " Cannot extend any mid-path list when not forced.";
-                    }
-                    throw std::invalid_argument(ss.str());
+                    return std::unexpected(JsonPathError{json_errc::index_out_of_bounds, i});
                 }
             }
             else if (i == path.size() - 1)
             {
                 arr[static_cast<size_t>(idx)] = value;
-                return;
+                return {};
             }
             current = &arr[static_cast<size_t>(idx)];
         }
         else
         {
-            auto const* stringKey = dynamic_cast<JsonStringKey*>(key.get());
+            auto const* stringKey = static_cast<JsonStringKey const*>(key.get());
             if (!is_object(current))
             {
                 if (force)
@@ -185,14 +562,14 @@ void JsonObject::set(JsonKeyPath const& path, value_type const& value, bool forc
                 }
                 else
                 {
-                    throw expected_object_error("Expected object at key: " + path.toString());
+                    return std::unexpected(JsonPathError{json_errc::expected_object, i});
                 }
             }
             auto& obj = current->as_object();
             if (i == path.size() - 1)
             {
                 obj[stringKey->getKey()] = value;
-                return;
+                return {};
             }
             if (!obj.contains(stringKey->getKey()))
             {
@@ -202,126 +579,527 @@ void JsonObject::set(JsonKeyPath const& path, value_type const& value, bool forc
                 }
                 else
                 {
-                    throw missing_key_error("Missing key: " + stringKey->getKey());
+                    return std::unexpected(JsonPathError{json_errc::missing_key, i});
                 }
             }
             current = &obj[stringKey->getKey()];
         }
     }
+    return {};
 }
 
-namespace
+std::expected<array_type*, JsonPathError>
+    JsonObject::locateArray(JsonKeyPath const& path, bool force, JsonKeyPath& resolved)
 {
-std::ostream& prettyPrintInternal(std::ostream& os, value_type const& jv, size_t indentWidth, std::string& indent);
+    value_type* current = &json_;
+    auto const& keys    = path.getKeys();
+    for (size_t segment = 0; segment < keys.size(); ++segment)
+    {
+        auto const& key = keys[segment];
+        if (key->isIndex())
+        {
+            if (!is_array(current))
+            {
+                if (!force)
+                {
+                    return std::unexpected(JsonPathError{json_errc::expected_array, segment});
+                }
+                *current = array_type{json_.storage()};
+            }
+            auto const* indexKey = static_cast<JsonIndexKey const*>(key.get());
+            auto&       arr      = as_array(*current);
+            int64_t     idx      = indexes_.resolve(resolved.getKeys(), {}, *indexKey, arr);
+            if (idx < 0 && indexKey->isSelector())
+            {
+                return std::unexpected(JsonPathError{json_errc::missing_key, segment});
+            }
+            if (idx < 0 || idx >= static_cast<int64_t>(array_size(arr)))
+            {
+                if (!force)
+                {
+                    return std::unexpected(JsonPathError{json_errc::index_out_of_bounds, segment});
+                }
+                idx = std::max<int64_t>(idx, 0);
+                array_resize(arr, static_cast<size_t>(idx + 1));
+            }
+            resolved.append(std::make_shared<JsonIndexKey>(static_cast<size_t>(idx)));
+            current = &arr[static_cast<size_t>(idx)];
+        }
+        else
+        {
+            if (!is_object(current))
+            {
+                if (!force)
+                {
+                    return std::unexpected(JsonPathError{json_errc::expected_object, segment});
+                }
+                *current = object_type{json_.storage()};
+            }
+            auto&       obj  = current->as_object();
+            auto const& name = static_cast<JsonStringKey const*>(key.get())->getKey();
+            if (!obj.contains(name))
+            {
+                if (!force)
+                {
+                    return std::unexpected(JsonPathError{json_errc::missing_key, segment});
+                }
+                obj[name] = nullptr;
+            }
+            resolved.append(key);
+            current = &obj[name];
+        }
+    }
+    if (!is_array(current))
+    {
+        if (!force)
+        {
+            return std::unexpected(JsonPathError{json_errc::expected_array, JsonPathError::noSegment});
+        }
+        *current = array_type{json_.storage()};
+    }
+    return &as_array(*current);
+}
 
-void printObject(std::ostream& os, object_type const& obj, size_t indentWidth, std::string& indent)
+template<typename Change>
+void JsonObject::changeArray(JsonKeyPath const& path, bool force, JsonArrayEdit edit, size_t count, Change&& change)
 {
-    os << "{\n";
-    indent.append(indentWidth, ' ');
-    for (auto it = obj.begin(); it != obj.end(); ++it)
+    JSONOBJECT_METRICS_SCOPE(JsonOperation::set);
+    JsonKeyPath resolved;
+    auto        located = locateArray(path, force, resolved);
+    if (!located)
     {
-        if (it != obj.begin())
+        if (located.error().segment == JsonPathError::noSegment)
         {
-            os << ",\n";
+            throw expected_array_error("Expected array at key: " + path.toString());
         }
-        os << indent << to_json_string(it->key()) << " : ";
-        prettyPrintInternal(os, it->value(), indentWidth, indent);
+        throwSetError(path, located.error());
+    }
+    auto const changes = indexes_.empty() ? std::vector<JsonArrayIndexes::Change>{}
+                                          : indexes_.prepare(json_, resolved, edit);
+    auto const index = change(**located);
+    if (edit != JsonArrayEdit::append)
+    {
+        shifted(**located);
+    }
+    if (!changes.empty())
+    {
+        indexes_.apply(changes, true);
+    }
+    if (fragments_)
+    {
+        fragments_->invalidate(resolved);
     }
-    os << "\n";
-    indent.resize(indent.size() - indentWidth);
-    os << indent << "}";
+    if (journal_)
+    {
+        // only the inserted values are journaled, so a batch costs its own size and not the size of the array
+        journal_->appendInsert(resolved, index, std::span{(*located)->data() + index, count}, force);
+    }
+}
+
+void JsonObject::appendRange(std::string_view path, std::vector<value_type> values, bool force)
+{
+    appendRange(*makePath(path), std::move(values), force);
+}
+
+void JsonObject::appendRange(JsonKeyPath const& path, std::vector<value_type> values, bool force)
+{
+    changeArray(path, force, JsonArrayEdit::append, values.size(), [&values](array_type& arr) {
+        auto const index = arr.size();
+        arr.reserve(arr.size() + values.size());
+        for (auto& value : values)
+        {
+            array_append(arr, std::move(value));
+        }
+        return index;
+    });
 }
 
-void printArray(std::ostream& os, array_type const& arr, size_t indentWidth, std::string& indent)
+void JsonObject::prependRange(std::string_view path, std::vector<value_type> values, bool force)
 {
-    os << "[\n";
-    indent.append(indentWidth, ' ');
-    for (auto it = arr.begin(); it != arr.end(); ++it)
+    prependRange(*makePath(path), std::move(values), force);
+}
+
+void JsonObject::prependRange(JsonKeyPath const& path, std::vector<value_type> values, bool force)
+{
+    insertRange(path, 0, std::move(values), force);
+}
+
+void JsonObject::insertRange(std::string_view path, size_t index, std::vector<value_type> values, bool force)
+{
+    insertRange(*makePath(path), index, std::move(values), force);
+}
+
+void JsonObject::insertRange(JsonKeyPath const& path, size_t index, std::vector<value_type> values, bool force)
+{
+    auto const edit = index == 0 ? JsonArrayEdit::prepend : JsonArrayEdit::insert;
+    changeArray(path, force, edit, values.size(), [&](array_type& arr) {
+        if (index > arr.size())
+        {
+            if (!force)
+            {
+                std::ostringstream ss;
+                ss << "Index '" << index << "' is out of bounds [0.." << arr.size() << "] for insertion at key: "
+                   << path.toString();
+                throw std::invalid_argument(ss.str());
+            }
+            array_resize(arr, index);
+        }
+        arr.insert(
+            arr.begin() + static_cast<std::ptrdiff_t>(index),
+            std::make_move_iterator(values.begin()),
+            std::make_move_iterator(values.end())
+        );
+        return index;
+    });
+}
+
+void JsonObject::reserve(std::string_view path, size_t capacity, bool force)
+{
+    reserve(*makePath(path), capacity, force);
+}
+
+void JsonObject::reserve(JsonKeyPath const& path, size_t capacity, bool force)
+{
+    JsonKeyPath resolved;
+    auto        located = locateArray(path, force, resolved);
+    if (!located)
     {
-        if (it != arr.begin())
+        if (located.error().segment == JsonPathError::noSegment)
         {
-            os << ",\n";
+            throw expected_array_error("Expected array at key: " + path.toString());
         }
-        os << indent;
-        prettyPrintInternal(os, *it, indentWidth, indent);
+        throwSetError(path, located.error());
     }
-    os << "\n";
-    indent.resize(indent.size() - indentWidth);
-    os << indent << "]";
+    (*located)->reserve(capacity);
 }
 
-std::ostream& prettyPrintInternal(std::ostream& os, value_type const& jv, size_t indentWidth, std::string& indent)
+array_type const& JsonObject::arrayAt(JsonKeyPath const& path) const
 {
-    using enum util::kind;
-    switch (static_cast<kind>(jv.kind()))
+    value_type const* found = find(json_, path, false);
+    if (!found->is_array())
     {
-        case object:
-            printObject(os, jv.get_object(), indentWidth, indent);
-            break;
+        throw expected_array_error("Expected array at key: " + path.toString());
+    }
+    return found->get_array();
+}
 
-        case array:
-            printArray(os, jv.get_array(), indentWidth, indent);
-            break;
+void JsonObject::transformArray(JsonKeyPath const& path, std::function<void(array_type&)> const& change)
+{
+    JsonKeyPath resolved;
+    auto        located = locateArray(path, false, resolved);
+    if (!located)
+    {
+        if (located.error().segment == JsonPathError::noSegment)
+        {
+            throw expected_array_error("Expected array at key: " + path.toString());
+        }
+        throwLookupError(json_, path, located.error());
+    }
+    auto const changes = indexes_.empty() ? std::vector<JsonArrayIndexes::Change>{}
+                                          : indexes_.prepare(json_, resolved, JsonArrayEdit::set);
+    auto const finish  = [&] {
+        if (!changes.empty())
+        {
+            indexes_.apply(changes, true);
+        }
+        if (fragments_)
+        {
+            fragments_->invalidate(resolved);
+        }
+        journalSet(resolved, **located, false, true);
+    };
+    try
+    {
+        change(**located);
+    }
+    catch (...)
+    {
+        finish();
+        throw;
+    }
+    finish();
+}
+
+bool JsonObject::storageThreadSafe(JsonParallelOptions const& options) const
+{
+    return options.storageThreadSafe || json_.storage().get() == storage_type{}.get();
+}
+
+namespace
+{
+/**
+ * Collects text in a fixed buffer and hands it to a sink in pieces, so that serialising does not allocate.
+ */
+class TextOutput
+{
+    std::function<void(std::string_view)> const& sink_;
+    std::array<char, 4096>                       buffer_{};
+    size_t                                       used_ = 0;
+
+  public:
+    explicit TextOutput(std::function<void(std::string_view)> const& sink)
+        : sink_(sink)
+    {
+    }
+
+    void append(std::string_view text)
+    {
+        if (text.size() > buffer_.size() - used_)
+        {
+            flush();
+            if (text.size() >= buffer_.size())
+            {
+                sink_(text);
+                return;
+            }
+        }
+        std::ranges::copy(text, buffer_.data() + used_);
+        used_ += text.size();
+    }
+
+    void append(char c)
+    {
+        if (used_ == buffer_.size())
+        {
+            flush();
+        }
+        buffer_[used_++] = c;
+    }
+
+    void appendSpaces(size_t count)
+    {
+        static constexpr std::string_view spaces{"                                                                "};
+        for (; count > spaces.size(); count -= spaces.size())
+        {
+            append(spaces);
+        }
+        append(spaces.substr(0, count));
+    }
 
+    void flush()
+    {
+        if (used_ > 0)
+        {
+            sink_(std::string_view{buffer_.data(), used_});
+            used_ = 0;
+        }
+    }
+};
+
+void appendQuoted(TextOutput& out, std::string_view text)
+{
+    bool const plain = std::ranges::none_of(text, [](char c) {
+        return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+    });
+    if (!plain)
+    {
+        // rare: leave the escaping to boost::json
+        out.append(to_json_string(value_type{text}));
+        return;
+    }
+    out.append('"');
+    out.append(text);
+    out.append('"');
+}
+
+template<typename Number>
+void appendNumber(TextOutput& out, Number number)
+{
+    std::array<char, 32> digits{};
+    out.append(std::string_view{digits.data(), std::to_chars(digits.data(), digits.data() + digits.size(), number).ptr});
+}
+
+void appendScalar(TextOutput& out, value_type const& jv)
+{
+    using enum util::kind;
+    switch (static_cast<kind>(jv.kind()))
+    {
         case string:
-            os << to_json_string(jv.get_string());
+            appendQuoted(out, jv.get_string());
             break;
 
         case uint64:
-            os << jv.get_uint64();
+            appendNumber(out, jv.get_uint64());
             break;
 
         case int64:
-            os << jv.get_int64();
+            appendNumber(out, jv.get_int64());
             break;
 
         case double_:
-            os << jv.get_double();
+        {
+            // as std::ostream prints doubles with its default precision of 6 significant digits
+            std::array<char, 32> digits{};
+            auto const           end = std::to_chars(
+                digits.data(),
+                digits.data() + digits.size(),
+                jv.get_double(),
+                std::chars_format::general,
+                6
+            );
+            out.append(std::string_view{digits.data(), end.ptr});
             break;
+        }
 
         case bool_:
-            os << (jv.get_bool() ? "true" : "false");
+            out.append(jv.get_bool() ? "true" : "false");
             break;
 
         case null:
-            os << "null";
+            out.append("null");
+            break;
+
+        case object:
+        case array:
             break;
     }
-    return os;
 }
-} // namespace
 
-std::ostream& prettyPrint(std::ostream& os, value_type const& jv, size_t indentWidth, std::string* indent = nullptr)
+void prettyPrint(TextOutput& out, value_type const& jv, size_t indentWidth)
 {
-    std::string indent_;
-    if (!indent)
+    size_t level = 0;
+    for (JsonTraversal walk{jv}; walk.next();)
     {
-        indent = &indent_;
+        if (walk.depth() > 0 && walk.event() != JsonVisitEvent::leave)
+        {
+            auto const& segment = walk.path().back();
+            if (segment.index > 0)
+            {
+                out.append(",\n");
+            }
+            out.appendSpaces(level * indentWidth);
+            if (!segment.isIndex)
+            {
+                appendQuoted(out, segment.key);
+                out.append(" : ");
+            }
+        }
+        switch (walk.event())
+        {
+            case JsonVisitEvent::enter:
+                out.append(is_object(walk.value()) ? "{\n" : "[\n");
+                ++level;
+                break;
+
+            case JsonVisitEvent::leave:
+                out.append('\n');
+                --level;
+                out.appendSpaces(level * indentWidth);
+                out.append(is_object(walk.value()) ? '}' : ']');
+                break;
+
+            case JsonVisitEvent::value:
+                appendScalar(out, walk.value());
+                break;
+        }
     }
+    out.append('\n');
+}
+} // namespace
 
-    prettyPrintInternal(os, jv, indentWidth, *indent);
+JsonTraversal JsonObject::traverse() const
+{
+    return JsonTraversal{json_};
+}
 
-    if (indent->empty())
+JsonObject JsonObject::merge(std::span<JsonObject const> layers, JsonMergePolicy const& policy)
+{
+    std::vector<value_type const*> values;
+    values.reserve(layers.size());
+    for (auto const& layer : layers)
     {
-        os << "\n";
+        values.push_back(&layer.json_);
     }
+    auto       merged = json_merge(values, policy);
+    JsonObject result{merged.storage()};
+    result.json_ = std::move(merged);
+    return result;
+}
 
-    return os;
+JsonObject JsonObject::merge(std::vector<JsonObject>&& layers, JsonMergePolicy const& policy)
+{
+    std::vector<value_type> values;
+    values.reserve(layers.size());
+    for (auto& layer : layers)
+    {
+        values.push_back(std::move(layer.json_));
+    }
+    auto       merged = json_merge(std::move(values), policy);
+    JsonObject result{merged.storage()};
+    result.json_ = std::move(merged);
+    return result;
+}
+
+FrozenJsonObject JsonObject::freeze(std::shared_ptr<JsonKeyInternTable> keyTable) const
+{
+    return FrozenJsonObject{json_, std::move(keyTable)};
 }
 
 std::string JsonObject::toString(size_t indent) const
 {
-    if (indent <= 0)
+    JSONOBJECT_METRICS_SCOPE(JsonOperation::toString);
+    std::string result;
+    if (indent <= 0 && fragments_)
     {
-        return json_serialize(json_);
+        result = fragments_->serialize(json_);
     }
-    std::stringstream ss;
-    prettyPrint(ss, json_, indent);
-    return ss.str();
+    else if (indent <= 0)
+    {
+        result = json_serialize(json_);
+    }
+    else
+    {
+        serializeChunks(indent, [&result](std::string_view piece) { result.append(piece); });
+    }
+    JSONOBJECT_METRICS_ADD(JsonCounter::bytesSerialized, result.size());
+    return result;
+}
+
+size_t JsonObject::serializedSize(size_t indent) const
+{
+    size_t size = 0;
+    serializeChunks(indent, [&size](std::string_view piece) { size += piece.size(); });
+    return size;
+}
+
+size_t JsonObject::serializeTo(std::span<char> buffer, size_t indent) const
+{
+    size_t used = 0;
+    serializeChunks(indent, [&buffer, &used](std::string_view piece) {
+        if (piece.size() > buffer.size() - used)
+        {
+            throw std::length_error(
+                "Buffer of " + std::to_string(buffer.size()) + " characters is too small for the serialised object"
+            );
+        }
+        std::ranges::copy(piece, buffer.data() + used);
+        used += piece.size();
+    });
+    JSONOBJECT_METRICS_ADD(JsonCounter::bytesSerialized, used);
+    return used;
+}
+
+void JsonObject::serializeChunks(size_t indent, std::function<void(std::string_view)> const& sink) const
+{
+    if (indent == 0)
+    {
+        boost::json::serializer serializer;
+        serializer.reset(&json_);
+        std::array<char, 4096> buffer{};
+        while (!serializer.done())
+        {
+            sink(serializer.read(buffer.data(), buffer.size()));
+        }
+        return;
+    }
+    TextOutput out{sink};
+    prettyPrint(out, json_, indent);
+    out.flush();
 }
 
 void JsonObject::load(std::string const& filename)
 {
+    JSONOBJECT_METRICS_SCOPE(JsonOperation::load);
     std::ifstream ifs(filename.c_str());
 
     if (!ifs.is_open())
@@ -334,11 +1112,103 @@ void JsonObject::load(std::string const& filename)
     {
         jsonStr += line;
     }
-    json_ = from_json_string(jsonStr);
+    JSONOBJECT_METRICS_ADD(JsonCounter::bytesParsed, jsonStr.size());
+    json_ = from_json_string(jsonStr, json_.storage());
+    finishLoad(filename, JsonSnapshotDigest::of(jsonStr));
+}
+
+void JsonObject::shifted(array_type const& arr)
+{
+    // arrays are not tracked when they are freed, so the map only grows; past the limit all cursors are
+    // invalidated instead, which also forgets stamps on addresses a later array may reuse
+    static constexpr size_t maxShiftedArrays = 1024;
+    if (shiftedArrays_.size() >= maxShiftedArrays && !shiftedArrays_.contains(&arr))
+    {
+        resetCursors();
+        return;
+    }
+    shiftedArrays_[&arr] = ++generation_;
+}
+
+void JsonObject::resetCursors()
+{
+    shiftedArrays_.clear();
+    resetGeneration_ = ++generation_;
+}
+
+void JsonObject::replayInsert(JsonJournalRecord const& record)
+{
+    // the record was written after a successful insertion, so it applies the same way to the same state
+    JsonKeyPath resolved;
+    auto const  path    = record.path.empty() ? std::make_shared<JsonKeyPath const>() : makePath(record.path);
+    auto        located = locateArray(*path, record.force, resolved);
+    if (!located)
+    {
+        return;
+    }
+    auto&       arr    = **located;
+    auto const& values = record.value.as_array();
+    if (record.index > arr.size())
+    {
+        array_resize(arr, record.index);
+    }
+    arr.insert(arr.begin() + static_cast<std::ptrdiff_t>(record.index), values.begin(), values.end());
+}
+
+void JsonObject::finishLoad(std::string const& filename, JsonSnapshotDigest const& snapshot)
+{
+    JsonJournal::replay(filename, snapshot, [this](JsonJournalRecord const& record) {
+        if (record.operation == JsonJournalRecord::Operation::clear)
+        {
+            json_ = object_type{json_.storage()};
+        }
+        else if (record.operation == JsonJournalRecord::Operation::replace)
+        {
+            json_ = value_type{record.value, json_.storage()};
+        }
+        else if (record.operation == JsonJournalRecord::Operation::insert)
+        {
+            replayInsert(record);
+        }
+        else
+        {
+            // failures are replayed as they happened: a failed forced set keeps the containers it created
+            auto const path = record.path.empty() ? std::make_shared<JsonKeyPath const>() : makePath(record.path);
+            static_cast<void>(trySetInternal(json_, *path, record.value, record.force));
+        }
+    });
+    indexes_.invalidateAll();
+    if (fragments_)
+    {
+        fragments_->invalidateAll();
+    }
+    resetCursors();
+    if (journal_)
+    {
+        // the journal must continue from the loaded state; one record is written in the background, a new snapshot
+        // would be written here
+        journal_->appendReplace(json_);
+    }
+}
+
+JsonObject JsonObject::loadProjected(std::string const& filename, std::span<JsonKeyPath const> paths, storage_type storage)
+{
+    JSONOBJECT_METRICS_SCOPE(JsonOperation::load);
+    JsonObject result{storage};
+    result.json_ = JsonProjection{paths}.parseFile(filename, std::move(storage));
+    return result;
+}
+
+JsonObject JsonObject::parseProjected(std::string_view text, std::span<JsonKeyPath const> paths, storage_type storage)
+{
+    JsonObject result{storage};
+    result.json_ = JsonProjection{paths}.parse(text, std::move(storage));
+    return result;
 }
 
 void JsonObject::write(std::string const& filename, size_t indent) const
 {
+    JSONOBJECT_METRICS_SCOPE(JsonOperation::write);
     std::ofstream ofs(filename.c_str());
 
     if (!ofs.is_open())
@@ -348,4 +1218,101 @@ void JsonObject::write(std::string const& filename, size_t indent) const
     ofs << toString(indent);
 }
 
+JsonAsync<JsonObject> JsonObject::loadAsync(std::string filename, JsonAsyncOptions options)
+{
+    auto* pool      = options.pool == nullptr ? &JsonThreadPool::shared() : options.pool;
+    auto  chunkSize = options.chunkSize;
+    return JsonAsync<JsonObject>{
+        [filename = std::move(filename), pool, chunkSize](std::stop_token const& stop) {
+            JSONOBJECT_METRICS_SCOPE(JsonOperation::load);
+            JsonChunkReader            reader{filename, chunkSize, *pool};
+            boost::json::stream_parser parser;
+            JsonSnapshotDigest         digest;
+            for (auto chunk = reader.next(); !chunk.empty(); chunk = reader.next())
+            {
+                if (stop.stop_requested())
+                {
+                    throw cancelled_error("loading " + filename + " cancelled");
+                }
+                JSONOBJECT_METRICS_ADD(JsonCounter::bytesParsed, chunk.size());
+                digest.update(chunk);
+                parser.write(chunk.data(), chunk.size());
+            }
+            parser.finish();
+            JsonObject result{};
+            result.json_ = parser.release();
+            result.finishLoad(filename, digest);
+            return result;
+        },
+        std::move(options)
+    };
+}
+
+JsonAsync<void> JsonObject::writeAsync(std::string filename, size_t indent, JsonAsyncOptions options) const
+{
+    auto* pool      = options.pool == nullptr ? &JsonThreadPool::shared() : options.pool;
+    auto  chunkSize = std::max<size_t>(options.chunkSize, 1);
+    return JsonAsync<void>{
+        [this, filename = std::move(filename), indent, pool, chunkSize](std::stop_token const& stop) {
+            JSONOBJECT_METRICS_SCOPE(JsonOperation::write);
+            auto const    tmpFile = filename + ".tmp";
+            std::ofstream ofs(tmpFile.c_str(), std::ios::binary);
+            if (!ofs.is_open())
+            {
+                throw std::invalid_argument(filename + " cannot be opened for writing");
+            }
+
+            // produce the next chunk into a buffer while the previous one is written on the pool
+            auto chunks = indent > 0 ? JsonChunkSerializer{toString(indent), chunkSize}
+                                     : JsonChunkSerializer{json_, chunkSize};
+
+            std::string     current;
+            std::string     writing;
+            JsonPendingTask pendingWrite;
+            try
+            {
+                while (chunks.next(current))
+                {
+                    if (stop.stop_requested())
+                    {
+                        throw cancelled_error("writing " + filename + " cancelled");
+                    }
+                    pendingWrite.wait();
+                    writing.swap(current);
+                    pendingWrite.start(*pool, [&ofs, &writing, &filename] {
+                        if (!ofs.write(writing.data(), static_cast<std::streamsize>(writing.size())))
+                        {
+                            throw std::runtime_error("writing " + filename + " failed");
+                        }
+                    });
+                }
+                pendingWrite.wait();
+                ofs.close();
+                if (ofs.fail())
+                {
+                    // the last buffered bytes are only written by close(), a failure there leaves a truncated file
+                    throw std::runtime_error("writing " + filename + " failed");
+                }
+                std::filesystem::rename(tmpFile, filename);
+            }
+            catch (...)
+            {
+                try
+                {
+                    pendingWrite.wait();
+                }
+                catch (std::exception const&)
+                {
+                    // the first failure is the one reported
+                }
+                ofs.close();
+                std::error_code ignored;
+                std::filesystem::remove(tmpFile, ignored);
+                throw;
+            }
+        },
+        std::move(options)
+    };
+}
+
 } // namespace util
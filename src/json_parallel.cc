@@ -0,0 +1,139 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   src/json_parallel.cc
+ * Description: chunked parallel loops over array elements
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+namespace util
+{
+namespace
+{
+/**
+ * State shared by the calling thread and the helping workers of one json_parallel_for().
+ */
+struct ParallelLoop
+{
+    std::function<void(size_t, size_t)> const *body = nullptr;
+    size_t                                     count = 0;
+    size_t                                     chunk = 0;
+    std::atomic<size_t>                        next{0};
+    std::atomic<bool>                          failed{false};
+    std::mutex                                 mutex{};
+    std::condition_variable                    idle{};
+    size_t                                     active = 0;
+    bool                                       closed = false;
+    std::exception_ptr                         error{};
+
+    void work()
+    {
+        while (!failed.load(std::memory_order_relaxed))
+        {
+            size_t const begin = next.fetch_add(chunk, std::memory_order_relaxed);
+            if (begin >= count)
+            {
+                return;
+            }
+            try
+            {
+                (*body)(begin, std::min(begin + chunk, count));
+            }
+            catch (...)
+            {
+                std::lock_guard const lock(mutex);
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+                failed = true;
+            }
+        }
+    }
+};
+} // namespace
+
+void json_parallel_for(size_t count, std::function<void(size_t, size_t)> const &body, JsonParallelOptions const &options)
+{
+    JsonThreadPool &pool    = options.pool != nullptr ? *options.pool : JsonThreadPool::shared();
+    size_t const    threads = pool.size() + 1;
+    if (count == 0)
+    {
+        return;
+    }
+    if (count < options.minParallelSize || pool.size() == 0)
+    {
+        body(0, count);
+        return;
+    }
+    size_t const chunk =
+        options.chunkSize != 0
+            ? options.chunkSize
+            : std::max(JsonParallelOptions::minChunkSize, (count + threads * 8 - 1) / (threads * 8));
+    size_t const chunks = (count + chunk - 1) / chunk;
+
+    auto loop   = std::make_shared<ParallelLoop>();
+    loop->body  = &body;
+    loop->count = count;
+    loop->chunk = chunk;
+    for (size_t helper = 1; helper < std::min(threads, chunks); ++helper)
+    {
+        pool.submit(
+            [loop]
+            {
+                {
+                    std::lock_guard const lock(loop->mutex);
+                    if (loop->closed)
+                    {
+                        // the caller has finished without this worker
+                        return;
+                    }
+                    ++loop->active;
+                }
+                loop->work();
+                {
+                    std::lock_guard const lock(loop->mutex);
+                    --loop->active;
+                }
+                loop->idle.notify_all();
+            }
+        );
+    }
+    loop->work();
+
+    std::unique_lock lock(loop->mutex);
+    loop->closed = true;
+    loop->idle.wait(lock, [&loop] { return loop->active == 0; });
+    if (loop->error)
+    {
+        std::rethrow_exception(loop->error);
+    }
+}
+
+} // namespace util
@@ -0,0 +1,504 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   src/json_projection.cc
+ * Description: parse only selected paths of a json text
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_projection.h"
+
+#include <algorithm>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace util
+{
+/**
+ * Single pass over the text, descending only into values that the projection selects something in.
+ */
+class JsonProjection::Scanner
+{
+  public:
+    Scanner(std::vector<Node> const &nodes, std::string_view text, storage_type storage)
+        : nodes_(nodes)
+        , begin_(text.data())
+        , pos_(text.data())
+        , end_(text.data() + text.size())
+        , storage_(std::move(storage))
+    {
+    }
+
+    value_type run()
+    {
+        value_type result{nullptr, storage_};
+        if (!project(0, result))
+        {
+            result = object_type{storage_};
+        }
+        skipWhitespace();
+        if (pos_ != end_)
+        {
+            fail("extra data");
+        }
+        return result;
+    }
+
+  private:
+    std::vector<Node> const &nodes_;
+    char const              *begin_;
+    char const              *pos_;
+    char const              *end_;
+    storage_type             storage_;
+
+    [[noreturn]] void fail(char const *what) const
+    {
+        throw std::invalid_argument(
+            std::string{"cannot parse json: "} + what + " at offset " + std::to_string(pos_ - begin_)
+        );
+    }
+
+    void skipWhitespace()
+    {
+        while (pos_ != end_ && (*pos_ == ' ' || *pos_ == '\n' || *pos_ == '\r' || *pos_ == '\t'))
+        {
+            ++pos_;
+        }
+    }
+
+    char peek()
+    {
+        skipWhitespace();
+        if (pos_ == end_)
+        {
+            fail("unexpected end of input");
+        }
+        return *pos_;
+    }
+
+    void expect(char token)
+    {
+        if (peek() != token)
+        {
+            fail("unexpected character");
+        }
+        ++pos_;
+    }
+
+    /**
+     * @brief Move behind the string that starts at the current position; escapes are stepped over, not decoded.
+     */
+    void skipString()
+    {
+        ++pos_;
+        while (pos_ != end_)
+        {
+            char const current = *pos_++;
+            if (current == '"')
+            {
+                return;
+            }
+            if (current == '\\')
+            {
+                if (pos_ == end_)
+                {
+                    break;
+                }
+                ++pos_;
+            }
+        }
+        fail("unterminated string");
+    }
+
+    /**
+     * @brief Move behind the end of the container that the current position is nested in depth levels deep.
+     */
+    void skipNested(size_t depth)
+    {
+        while (pos_ != end_)
+        {
+            switch (*pos_)
+            {
+                case '"':
+                    skipString();
+                    continue;
+                case '{':
+                case '[':
+                    ++depth;
+                    break;
+                case '}':
+                case ']':
+                    if (--depth == 0)
+                    {
+                        ++pos_;
+                        return;
+                    }
+                    break;
+                default:
+                    break;
+            }
+            ++pos_;
+        }
+        fail("unterminated container");
+    }
+
+    void skipValue()
+    {
+        switch (peek())
+        {
+            case '"':
+                skipString();
+                return;
+            case '{':
+            case '[':
+                ++pos_;
+                skipNested(1);
+                return;
+            default:
+                break;
+        }
+        auto const *start = pos_;
+        while (pos_ != end_ && *pos_ != ',' && *pos_ != '}' && *pos_ != ']' && *pos_ != ' ' && *pos_ != '\n' &&
+               *pos_ != '\r' && *pos_ != '\t')
+        {
+            ++pos_;
+        }
+        if (pos_ == start)
+        {
+            fail("unexpected character");
+        }
+    }
+
+    value_type take()
+    {
+        skipWhitespace();
+        auto const *start = pos_;
+        skipValue();
+        boost::json::error_code ec;
+        auto value = boost::json::parse(std::string_view{start, static_cast<size_t>(pos_ - start)}, ec, storage_);
+        if (ec)
+        {
+            pos_ = start;
+            fail("invalid value");
+        }
+        return value;
+    }
+
+    /**
+     * @brief Read a member key; the raw text is used unless the key contains escapes.
+     */
+    std::string_view key(std::string &scratch)
+    {
+        if (peek() != '"')
+        {
+            fail("expected key");
+        }
+        auto const *start = pos_;
+        skipString();
+        std::string_view const raw{start + 1, static_cast<size_t>(pos_ - start - 2)};
+        if (raw.find('\\') == std::string_view::npos)
+        {
+            return raw;
+        }
+        boost::json::error_code ec;
+        auto const decoded = boost::json::parse(std::string_view{start, static_cast<size_t>(pos_ - start)}, ec);
+        if (ec)
+        {
+            fail("invalid key");
+        }
+        scratch.assign(decoded.as_string().data(), decoded.as_string().size());
+        return scratch;
+    }
+
+    bool project(uint32_t index, value_type &slot)
+    {
+        auto const &node = nodes_[index];
+        if (node.whole)
+        {
+            slot = take();
+            return true;
+        }
+        auto const next = peek();
+        if (next == '{' && !node.members.empty())
+        {
+            return projectObject(node, slot);
+        }
+        if (next == '[' && (!node.elements.empty() || node.last != npos))
+        {
+            return projectArray(node, slot);
+        }
+        skipValue();
+        return false;
+    }
+
+    bool projectObject(Node const &node, value_type &slot)
+    {
+        ++pos_;
+        if (peek() == '}')
+        {
+            ++pos_;
+            return false;
+        }
+        bool        matched = false;
+        size_t      found   = 0;
+        std::string scratch;
+        while (true)
+        {
+            auto const name = key(scratch);
+            expect(':');
+            auto const member = std::lower_bound(
+                node.members.begin(), node.members.end(), name, [](auto const &entry, std::string_view wanted) {
+                    return entry.first < wanted;
+                }
+            );
+            if (member != node.members.end() && member->first == name)
+            {
+                value_type value{nullptr, storage_};
+                if (project(member->second, value))
+                {
+                    if (!slot.is_object())
+                    {
+                        slot = object_type{storage_};
+                    }
+                    slot.as_object().insert_or_assign(name, std::move(value));
+                    matched = true;
+                }
+                ++found;
+            }
+            else
+            {
+                skipValue();
+            }
+            auto const separator = peek();
+            ++pos_;
+            if (separator == '}')
+            {
+                return matched;
+            }
+            if (separator != ',')
+            {
+                --pos_;
+                fail("expected ',' or '}'");
+            }
+            if (found == node.members.size())
+            {
+                // everything selected here has been seen: the rest of the object is not looked at
+                skipNested(1);
+                return matched;
+            }
+        }
+    }
+
+    void store(value_type &slot, size_t index, value_type &&value)
+    {
+        if (!slot.is_array())
+        {
+            slot = array_type{storage_};
+        }
+        auto &arr = slot.as_array();
+        if (arr.size() <= index)
+        {
+            arr.resize(index + 1);
+        }
+        arr[index] = std::move(value);
+    }
+
+    bool projectArray(Node const &node, value_type &slot)
+    {
+        ++pos_;
+        if (peek() == ']')
+        {
+            ++pos_;
+            return false;
+        }
+        bool        matched   = false;
+        size_t      index     = 0;
+        auto        element   = node.elements.begin();
+        char const *lastStart = nullptr;
+        while (true)
+        {
+            lastStart = pos_;
+            while (element != node.elements.end() && element->first < index)
+            {
+                ++element;
+            }
+            if (element != node.elements.end() && element->first == index)
+            {
+                value_type value{nullptr, storage_};
+                if (project(element->second, value))
+                {
+                    store(slot, index, std::move(value));
+                    matched = true;
+                }
+            }
+            else
+            {
+                skipValue();
+            }
+            ++index;
+            auto const separator = peek();
+            ++pos_;
+            if (separator == ']')
+            {
+                break;
+            }
+            if (separator != ',')
+            {
+                --pos_;
+                fail("expected ',' or ']'");
+            }
+            if (node.last == npos && (node.elements.empty() || node.elements.back().first < index))
+            {
+                skipNested(1);
+                return matched;
+            }
+        }
+        if (node.last != npos)
+        {
+            // the last element is known only now: scan it once more, into what an index path selected of it
+            auto const *after    = pos_;
+            auto const  lastIdx  = index - 1;
+            bool const  existing = slot.is_array() && slot.as_array().size() > lastIdx;
+            value_type  value    = existing ? std::move(slot.as_array()[lastIdx]) : value_type{nullptr, storage_};
+            pos_                 = lastStart;
+            bool const took      = project(node.last, value);
+            if (took || existing)
+            {
+                store(slot, lastIdx, std::move(value));
+            }
+            matched = matched || took;
+            pos_    = after;
+        }
+        return matched;
+    }
+};
+
+JsonProjection::JsonProjection(std::span<JsonKeyPath const> paths)
+{
+    nodes_.emplace_back();
+    for (auto const &path : paths)
+    {
+        uint32_t node = 0;
+        for (auto const &key : path.getKeys())
+        {
+            if (nodes_[node].whole)
+            {
+                break;
+            }
+            node = child(node, *key);
+        }
+        nodes_[node].whole = true;
+    }
+}
+
+uint32_t JsonProjection::child(uint32_t parent, JsonKey const &key)
+{
+    auto const next = static_cast<uint32_t>(nodes_.size());
+    if (key.isIndex())
+    {
+        auto const &indexKey = static_cast<JsonIndexKey const &>(key);
+        if (indexKey.isSelector())
+        {
+            throw std::invalid_argument("Projected paths cannot use selector '" + key.toString() + "'");
+        }
+        if (indexKey.isEndSymbol())
+        {
+            if (nodes_[parent].last == npos)
+            {
+                nodes_[parent].last = next;
+                nodes_.emplace_back();
+            }
+            return nodes_[parent].last;
+        }
+        auto const index    = static_cast<size_t>(indexKey.getIndex(size_t{0}));
+        auto      &elements = nodes_[parent].elements;
+        auto       found    = std::lower_bound(
+            elements.begin(), elements.end(), index, [](auto const &entry, size_t wanted) { return entry.first < wanted; }
+        );
+        if (found != elements.end() && found->first == index)
+        {
+            return found->second;
+        }
+        elements.emplace(found, index, next);
+    }
+    else
+    {
+        auto const &name    = static_cast<JsonStringKey const &>(key).getKey();
+        auto       &members = nodes_[parent].members;
+        auto        found   = std::lower_bound(members.begin(), members.end(), name, [](auto const &entry, auto const &wanted) {
+            return entry.first < wanted;
+        });
+        if (found != members.end() && found->first == name)
+        {
+            return found->second;
+        }
+        members.emplace(found, name, next);
+    }
+    nodes_.emplace_back();
+    return next;
+}
+
+value_type JsonProjection::parse(std::string_view text, storage_type storage) const
+{
+    return Scanner{nodes_, text, std::move(storage)}.run();
+}
+
+value_type JsonProjection::parseFile(std::string const &filename, storage_type storage) const
+{
+    int const fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    struct stat info{};
+    if (fd < 0 || ::fstat(fd, &info) != 0)
+    {
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+        throw std::invalid_argument(filename + " cannot be opened for reading");
+    }
+    auto const size = static_cast<size_t>(info.st_size);
+    if (size == 0)
+    {
+        ::close(fd);
+        return parse({}, std::move(storage));
+    }
+    void *mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        throw std::invalid_argument(filename + " cannot be opened for reading");
+    }
+    static_cast<void>(::madvise(mapped, size, MADV_SEQUENTIAL));
+    struct Unmap
+    {
+        void  *address;
+        size_t length;
+
+        ~Unmap()
+        {
+            ::munmap(address, length);
+        }
+    } const unmap{mapped, size};
+    return parse(std::string_view{static_cast<char const *>(mapped), size}, std::move(storage));
+}
+
+} // namespace util
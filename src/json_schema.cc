@@ -0,0 +1,841 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   src/json_schema.cc
+ * Description: precompiled json schema validator
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_schema.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+namespace util
+{
+namespace
+{
+enum TypeBit : uint8_t
+{
+    NULL_BIT    = 1U << 0U,
+    BOOLEAN_BIT = 1U << 1U,
+    INTEGER_BIT = 1U << 2U,
+    NUMBER_BIT  = 1U << 3U,
+    STRING_BIT  = 1U << 4U,
+    ARRAY_BIT   = 1U << 5U,
+    OBJECT_BIT  = 1U << 6U,
+};
+
+uint8_t typeBit(std::string_view name)
+{
+    if (name == "null")
+    {
+        return NULL_BIT;
+    }
+    if (name == "boolean")
+    {
+        return BOOLEAN_BIT;
+    }
+    if (name == "integer")
+    {
+        return INTEGER_BIT;
+    }
+    if (name == "number")
+    {
+        return NUMBER_BIT;
+    }
+    if (name == "string")
+    {
+        return STRING_BIT;
+    }
+    if (name == "array")
+    {
+        return ARRAY_BIT;
+    }
+    if (name == "object")
+    {
+        return OBJECT_BIT;
+    }
+    throw std::invalid_argument("Unknown schema type '" + std::string{name} + "'");
+}
+
+bool isInteger(value_type const &value)
+{
+    return value.is_int64() || value.is_uint64() || (value.is_double() && std::trunc(value.get_double()) == value.get_double());
+}
+
+bool hasType(uint8_t mask, value_type const &value)
+{
+    using enum util::kind;
+    switch (static_cast<kind>(value.kind()))
+    {
+        case null:
+            return (mask & NULL_BIT) != 0;
+        case bool_:
+            return (mask & BOOLEAN_BIT) != 0;
+        case int64:
+        case uint64:
+        case double_:
+            return (mask & NUMBER_BIT) != 0 || ((mask & INTEGER_BIT) != 0 && isInteger(value));
+        case string:
+            return (mask & STRING_BIT) != 0;
+        case array:
+            return (mask & ARRAY_BIT) != 0;
+        case object:
+            return (mask & OBJECT_BIT) != 0;
+    }
+    return false;
+}
+
+double asDouble(value_type const &value)
+{
+    return value_as<double>(value);
+}
+
+/**
+ * @brief Equality as JSON Schema defines it for enum, const and uniqueItems: numbers compare by value, so 1 equals
+ * 1.0, also inside arrays and objects.
+ */
+bool schemaEqual(value_type const &lhs, value_type const &rhs)
+{
+    if (lhs.is_number() && rhs.is_number())
+    {
+        if (lhs.is_double() || rhs.is_double())
+        {
+            return asDouble(lhs) == asDouble(rhs);
+        }
+        if (lhs.is_int64() && rhs.is_int64())
+        {
+            return lhs.get_int64() == rhs.get_int64();
+        }
+        if (lhs.is_uint64() && rhs.is_uint64())
+        {
+            return lhs.get_uint64() == rhs.get_uint64();
+        }
+        // a negative int64 never equals a uint64, and the others are in the range of both
+        auto const signedValue   = lhs.is_int64() ? lhs.get_int64() : rhs.get_int64();
+        auto const unsignedValue = lhs.is_uint64() ? lhs.get_uint64() : rhs.get_uint64();
+        return signedValue >= 0 && static_cast<uint64_t>(signedValue) == unsignedValue;
+    }
+    if (lhs.is_array() && rhs.is_array())
+    {
+        auto const &left  = lhs.get_array();
+        auto const &right = rhs.get_array();
+        return left.size() == right.size() &&
+               std::ranges::equal(left, right, [](auto const &l, auto const &r) { return schemaEqual(l, r); });
+    }
+    if (lhs.is_object() && rhs.is_object())
+    {
+        auto const &left  = lhs.get_object();
+        auto const &right = rhs.get_object();
+        return left.size() == right.size() && std::ranges::all_of(left, [&right](auto const &member) {
+                   auto const *other = right.if_contains(member.key());
+                   return other != nullptr && schemaEqual(member.value(), *other);
+               });
+    }
+    return lhs == rhs;
+}
+
+std::optional<double> numberKeyword(object_type const &schema, std::string_view keyword)
+{
+    auto const *found = schema.if_contains(keyword);
+    if (found == nullptr)
+    {
+        return std::nullopt;
+    }
+    if (!found->is_number())
+    {
+        throw std::invalid_argument("Schema keyword '" + std::string{keyword} + "' must be a number");
+    }
+    return asDouble(*found);
+}
+
+std::optional<size_t> sizeKeyword(object_type const &schema, std::string_view keyword)
+{
+    auto const *found = schema.if_contains(keyword);
+    if (found == nullptr)
+    {
+        return std::nullopt;
+    }
+    if (!isInteger(*found) || asDouble(*found) < 0)
+    {
+        throw std::invalid_argument("Schema keyword '" + std::string{keyword} + "' must be a non-negative integer");
+    }
+    return value_as<size_t>(*found);
+}
+
+size_t codePoints(std::string_view str)
+{
+    return static_cast<size_t>(
+        std::count_if(str.begin(), str.end(), [](char c) { return (static_cast<unsigned char>(c) & 0xC0U) != 0x80U; })
+    );
+}
+
+std::string unescapePointerToken(std::string token)
+{
+    size_t pos = 0;
+    while ((pos = token.find('~', pos)) != std::string::npos)
+    {
+        if (pos + 1 < token.size() && token[pos + 1] == '1')
+        {
+            token.replace(pos, 2, "/");
+        }
+        else if (pos + 1 < token.size() && token[pos + 1] == '0')
+        {
+            token.replace(pos, 2, "~");
+        }
+        ++pos;
+    }
+    return token;
+}
+} // namespace
+
+struct JsonSchema::Context
+{
+    struct Segment
+    {
+        std::string_view key;
+        size_t           index;
+        bool             isIndex;
+    };
+
+    std::vector<JsonSchemaViolation> *out = nullptr; ///< nullptr: stop at the first failed check
+    std::vector<Segment>              segments;
+
+    [[nodiscard]] bool collecting() const
+    {
+        return out != nullptr;
+    }
+
+    void pushKey(std::string_view key)
+    {
+        if (collecting())
+        {
+            segments.push_back(Segment{key, 0, false});
+        }
+    }
+
+    void pushIndex(size_t index)
+    {
+        if (collecting())
+        {
+            segments.push_back(Segment{{}, index, true});
+        }
+    }
+
+    void pop()
+    {
+        if (collecting())
+        {
+            segments.pop_back();
+        }
+    }
+
+    /**
+     * @brief Record a violation at the current location. The message is assembled from its parts, strings or
+     * numbers, only when collecting, so that isValid() does not allocate for it.
+     * @return false
+     */
+    template<typename... Parts>
+    bool fail(Parts const &...parts)
+    {
+        if (collecting())
+        {
+            std::string message;
+            (appendPart(message, parts), ...);
+            record(std::move(message));
+        }
+        return false;
+    }
+
+  private:
+    template<typename Part>
+    static void appendPart(std::string &message, Part const &part)
+    {
+        if constexpr (std::is_arithmetic_v<Part>)
+        {
+            message += std::to_string(part);
+        }
+        else
+        {
+            message += std::string_view{part};
+        }
+    }
+
+    void record(std::string message)
+    {
+        JsonKeyPath path{};
+        try
+        {
+            for (auto const &segment: segments)
+            {
+                if (segment.isIndex)
+                {
+                    path.append(std::make_shared<JsonIndexKey>(segment.index));
+                }
+                else
+                {
+                    path.append(std::make_shared<JsonStringKey>(std::string{segment.key}));
+                }
+            }
+        }
+        catch (std::invalid_argument const &)
+        {
+            // the key cannot be expressed as JsonKeyPath: report the location of its parent
+        }
+        out->push_back(JsonSchemaViolation{std::move(path), std::move(message)});
+    }
+};
+
+JsonSchema::JsonSchema(value_type const &schema)
+    : document_(schema)
+{
+    root_ = compile(document_);
+}
+
+JsonSchema::JsonSchema(std::string const &schemaStr)
+    : JsonSchema(from_json_string(schemaStr))
+{
+}
+
+JsonSchema::JsonSchema(char const *schemaStr)
+    : JsonSchema(std::string{schemaStr})
+{
+}
+
+uint32_t JsonSchema::intern(std::string_view name)
+{
+    auto found = nameIds_.find(name);
+    if (found != nameIds_.end())
+    {
+        return found->second;
+    }
+    auto const id = static_cast<uint32_t>(names_.size());
+    names_.emplace_back(name);
+    nameIds_.emplace(names_.back(), id);
+    return id;
+}
+
+uint32_t JsonSchema::compileRef(std::string const &ref)
+{
+    auto found = refs_.find(ref);
+    if (found != refs_.end())
+    {
+        return found->second;
+    }
+    if (ref.empty() || ref[0] != '#')
+    {
+        throw std::invalid_argument("Only local schema references are supported: '" + ref + "'");
+    }
+    value_type const *target = &document_;
+    std::istringstream tokens(ref.substr(1));
+    std::string        token;
+    while (std::getline(tokens, token, '/'))
+    {
+        if (token.empty())
+        {
+            continue;
+        }
+        token = unescapePointerToken(token);
+        if (target->is_object() && target->get_object().contains(token))
+        {
+            target = &target->get_object().at(token);
+        }
+        else if (target->is_array() && token.find_first_not_of("0123456789") == std::string::npos &&
+                 std::stoul(token) < target->get_array().size())
+        {
+            target = &target->get_array()[std::stoul(token)];
+        }
+        else
+        {
+            throw std::invalid_argument("Cannot resolve schema reference '" + ref + "'");
+        }
+    }
+    // reserve the node first, so that recursive references resolve to it
+    auto const index = static_cast<uint32_t>(nodes_.size());
+    nodes_.emplace_back();
+    refs_.emplace(ref, index);
+    auto const compiled = compile(*target);
+    nodes_[index].allOf.push_back(compiled);
+    return index;
+}
+
+uint32_t JsonSchema::compile(value_type const &schema)
+{
+    auto const index = static_cast<uint32_t>(nodes_.size());
+    nodes_.emplace_back();
+    Node node{};
+
+    if (schema.is_bool())
+    {
+        node.alwaysFalse = !schema.get_bool();
+        nodes_[index]    = std::move(node);
+        return index;
+    }
+    if (!schema.is_object())
+    {
+        throw std::invalid_argument("A schema must be an object or a boolean");
+    }
+    auto const &obj = schema.get_object();
+
+    if (auto const *ref = obj.if_contains("$ref"); ref != nullptr)
+    {
+        if (!ref->is_string())
+        {
+            throw std::invalid_argument("Schema keyword '$ref' must be a string");
+        }
+        node.allOf.push_back(compileRef(std::string{value_as<std::string_view>(*ref)}));
+    }
+
+    if (auto const *type = obj.if_contains("type"); type != nullptr)
+    {
+        if (type->is_string())
+        {
+            node.typeMask = typeBit(value_as<std::string_view>(*type));
+        }
+        else if (type->is_array())
+        {
+            for (auto const &name: type->get_array())
+            {
+                if (!name.is_string())
+                {
+                    throw std::invalid_argument("Schema keyword 'type' must contain strings");
+                }
+                node.typeMask |= typeBit(value_as<std::string_view>(name));
+            }
+        }
+        else
+        {
+            throw std::invalid_argument("Schema keyword 'type' must be a string or an array");
+        }
+    }
+
+    if (auto const *values = obj.if_contains("enum"); values != nullptr)
+    {
+        if (!values->is_array())
+        {
+            throw std::invalid_argument("Schema keyword 'enum' must be an array");
+        }
+        node.hasEnum = true;
+        node.enumValues.assign(values->get_array().begin(), values->get_array().end());
+    }
+    if (auto const *value = obj.if_contains("const"); value != nullptr)
+    {
+        node.hasEnum = true;
+        node.enumValues.assign(1, *value);
+    }
+
+    node.minimum          = numberKeyword(obj, "minimum");
+    node.maximum          = numberKeyword(obj, "maximum");
+    node.exclusiveMinimum = numberKeyword(obj, "exclusiveMinimum");
+    node.exclusiveMaximum = numberKeyword(obj, "exclusiveMaximum");
+    node.multipleOf       = numberKeyword(obj, "multipleOf");
+    if (node.multipleOf && *node.multipleOf <= 0.0)
+    {
+        throw std::invalid_argument("Schema keyword 'multipleOf' must be positive");
+    }
+
+    node.minLength = sizeKeyword(obj, "minLength");
+    node.maxLength = sizeKeyword(obj, "maxLength");
+    if (auto const *pattern = obj.if_contains("pattern"); pattern != nullptr)
+    {
+        if (!pattern->is_string())
+        {
+            throw std::invalid_argument("Schema keyword 'pattern' must be a string");
+        }
+        node.patternSource = std::string{value_as<std::string_view>(*pattern)};
+        try
+        {
+            node.pattern = std::make_shared<std::regex>(node.patternSource, std::regex::ECMAScript);
+        }
+        catch (std::regex_error const &)
+        {
+            throw std::invalid_argument("Schema keyword 'pattern' is not a valid regular expression");
+        }
+    }
+
+    if (auto const *prefix = obj.if_contains("prefixItems"); prefix != nullptr && prefix->is_array())
+    {
+        for (auto const &item: prefix->get_array())
+        {
+            node.prefixItems.push_back(compile(item));
+        }
+    }
+    if (auto const *items = obj.if_contains("items"); items != nullptr)
+    {
+        if (items->is_array())
+        {
+            // draft-04 tuple form
+            for (auto const &item: items->get_array())
+            {
+                node.prefixItems.push_back(compile(item));
+            }
+        }
+        else
+        {
+            node.items = compile(*items);
+        }
+    }
+    node.minItems = sizeKeyword(obj, "minItems");
+    node.maxItems = sizeKeyword(obj, "maxItems");
+    if (auto const *unique = obj.if_contains("uniqueItems"); unique != nullptr && unique->is_bool())
+    {
+        node.uniqueItems = unique->get_bool();
+    }
+
+    if (auto const *properties = obj.if_contains("properties"); properties != nullptr)
+    {
+        if (!properties->is_object())
+        {
+            throw std::invalid_argument("Schema keyword 'properties' must be an object");
+        }
+        for (auto const &property: properties->get_object())
+        {
+            auto const name = intern(property.key());
+            node.properties.push_back(Property{name, npos});
+            node.properties.back().schema = compile(property.value());
+        }
+    }
+    if (auto const *required = obj.if_contains("required"); required != nullptr)
+    {
+        if (!required->is_array())
+        {
+            throw std::invalid_argument("Schema keyword 'required' must be an array");
+        }
+        for (auto const &name: required->get_array())
+        {
+            if (!name.is_string())
+            {
+                throw std::invalid_argument("Schema keyword 'required' must contain strings");
+            }
+            auto const id = intern(value_as<std::string_view>(name));
+            if (std::ranges::none_of(node.properties, [id](Property const &p) { return p.name == id; }))
+            {
+                node.properties.push_back(Property{id, npos});
+            }
+        }
+    }
+    std::ranges::sort(node.properties, {}, &Property::name);
+    node.required.assign((node.properties.size() + 63) / 64, 0);
+    if (auto const *required = obj.if_contains("required"); required != nullptr)
+    {
+        for (auto const &name: required->get_array())
+        {
+            auto const id   = nameIds_.find(value_as<std::string_view>(name))->second;
+            auto const slot = static_cast<size_t>(
+                std::ranges::lower_bound(node.properties, id, {}, &Property::name) - node.properties.begin()
+            );
+            node.required[slot / 64] |= uint64_t{1} << (slot % 64);
+        }
+    }
+    if (auto const *additional = obj.if_contains("additionalProperties"); additional != nullptr)
+    {
+        if (additional->is_bool())
+        {
+            node.additionalAllowed = additional->get_bool();
+        }
+        else
+        {
+            node.additional = compile(*additional);
+        }
+    }
+    node.minProperties = sizeKeyword(obj, "minProperties");
+    node.maxProperties = sizeKeyword(obj, "maxProperties");
+
+    auto compileList = [this, &obj](std::string_view keyword, std::vector<uint32_t> &target) {
+        if (auto const *list = obj.if_contains(keyword); list != nullptr)
+        {
+            if (!list->is_array() || list->get_array().empty())
+            {
+                throw std::invalid_argument("Schema keyword '" + std::string{keyword} + "' must be a non-empty array");
+            }
+            for (auto const &sub: list->get_array())
+            {
+                target.push_back(compile(sub));
+            }
+        }
+    };
+    compileList("allOf", node.allOf);
+    compileList("anyOf", node.anyOf);
+    compileList("oneOf", node.oneOf);
+    if (auto const *negated = obj.if_contains("not"); negated != nullptr)
+    {
+        node.not_ = compile(*negated);
+    }
+
+    nodes_[index] = std::move(node);
+    return index;
+}
+
+bool JsonSchema::isValid(value_type const &value) const
+{
+    Context ctx{};
+    return check(root_, value, ctx);
+}
+
+std::vector<JsonSchemaViolation> JsonSchema::validate(value_type const &value) const
+{
+    std::vector<JsonSchemaViolation> violations;
+    Context                          ctx{};
+    ctx.out = &violations;
+    check(root_, value, ctx);
+    return violations;
+}
+
+bool JsonSchema::check(uint32_t index, value_type const &value, Context &ctx) const
+{
+    if (index == npos)
+    {
+        return true;
+    }
+    auto const &node = nodes_[index];
+    if (node.alwaysFalse)
+    {
+        return ctx.fail("value is not allowed by the schema");
+    }
+    bool valid = true;
+    // evaluate the next check only while the result can still matter
+    auto const proceed = [&valid, &ctx] { return valid || ctx.collecting(); };
+
+    if (node.typeMask != 0 && !hasType(node.typeMask, value))
+    {
+        valid = ctx.fail("value has the wrong type");
+    }
+    auto const equalsValue = [&value](value_type const &allowed) { return schemaEqual(allowed, value); };
+    if (proceed() && node.hasEnum && std::ranges::none_of(node.enumValues, equalsValue))
+    {
+        valid = ctx.fail("value is not one of the allowed values");
+    }
+
+    if (proceed() && value.is_number())
+    {
+        double const number = asDouble(value);
+        if (node.minimum && number < *node.minimum)
+        {
+            valid = ctx.fail("value is less than the minimum");
+        }
+        if (proceed() && node.maximum && number > *node.maximum)
+        {
+            valid = ctx.fail("value is greater than the maximum");
+        }
+        if (proceed() && node.exclusiveMinimum && number <= *node.exclusiveMinimum)
+        {
+            valid = ctx.fail("value is not greater than the exclusive minimum");
+        }
+        if (proceed() && node.exclusiveMaximum && number >= *node.exclusiveMaximum)
+        {
+            valid = ctx.fail("value is not less than the exclusive maximum");
+        }
+        if (proceed() && node.multipleOf)
+        {
+            double const quotient = number / *node.multipleOf;
+            if (std::abs(quotient - std::round(quotient)) > 1e-9 * std::max(1.0, std::abs(quotient)))
+            {
+                valid = ctx.fail("value is not a multiple of ", *node.multipleOf);
+            }
+        }
+    }
+    else if (proceed() && value.is_string())
+    {
+        auto const str = value_as<std::string_view>(value);
+        if (node.minLength || node.maxLength)
+        {
+            auto const length = codePoints(str);
+            if (node.minLength && length < *node.minLength)
+            {
+                valid = ctx.fail("string is shorter than the minimum length");
+            }
+            if (proceed() && node.maxLength && length > *node.maxLength)
+            {
+                valid = ctx.fail("string is longer than the maximum length");
+            }
+        }
+        if (proceed() && node.pattern && !std::regex_search(str.begin(), str.end(), *node.pattern))
+        {
+            valid = ctx.fail("string does not match pattern '", node.patternSource, "'");
+        }
+    }
+    else if (proceed() && value.is_array())
+    {
+        valid = checkArray(node, value.get_array(), ctx) && valid;
+    }
+    else if (proceed() && value.is_object())
+    {
+        valid = checkObject(node, value.get_object(), ctx) && valid;
+    }
+
+    for (auto sub: node.allOf)
+    {
+        if (!proceed())
+        {
+            break;
+        }
+        valid = check(sub, value, ctx) && valid;
+    }
+    if (proceed() && !node.anyOf.empty())
+    {
+        Context probe{};
+        if (std::ranges::none_of(node.anyOf, [&](uint32_t sub) { return check(sub, value, probe); }))
+        {
+            valid = ctx.fail("value does not match any of the alternatives");
+        }
+    }
+    if (proceed() && !node.oneOf.empty())
+    {
+        Context probe{};
+        auto    matches = std::ranges::count_if(node.oneOf, [&](uint32_t sub) { return check(sub, value, probe); });
+        if (matches != 1)
+        {
+            valid = ctx.fail("value matches ", matches, " alternatives instead of exactly one");
+        }
+    }
+    if (proceed() && node.not_ != npos)
+    {
+        Context probe{};
+        if (check(node.not_, value, probe))
+        {
+            valid = ctx.fail("value matches a schema it must not match");
+        }
+    }
+    return valid;
+}
+
+bool JsonSchema::checkArray(Node const &node, array_type const &arr, Context &ctx) const
+{
+    bool valid = true;
+    if (node.minItems && arr.size() < *node.minItems)
+    {
+        valid = ctx.fail("array has fewer items than the minimum");
+    }
+    if ((valid || ctx.collecting()) && node.maxItems && arr.size() > *node.maxItems)
+    {
+        valid = ctx.fail("array has more items than the maximum");
+    }
+    if ((valid || ctx.collecting()) && node.uniqueItems)
+    {
+        for (size_t i = 1; i < arr.size() && valid; ++i)
+        {
+            for (size_t j = 0; j < i; ++j)
+            {
+                if (schemaEqual(arr[i], arr[j]))
+                {
+                    valid = ctx.fail("array items are not unique");
+                    break;
+                }
+            }
+        }
+    }
+    for (size_t i = 0; i < arr.size() && (valid || ctx.collecting()); ++i)
+    {
+        auto const sub = i < node.prefixItems.size() ? node.prefixItems[i] : node.items;
+        if (sub == npos)
+        {
+            continue;
+        }
+        ctx.pushIndex(i);
+        valid = check(sub, arr[i], ctx) && valid;
+        ctx.pop();
+    }
+    return valid;
+}
+
+bool JsonSchema::checkObject(Node const &node, object_type const &obj, Context &ctx) const
+{
+    bool valid = true;
+    if (node.minProperties && obj.size() < *node.minProperties)
+    {
+        valid = ctx.fail("object has fewer properties than the minimum");
+    }
+    if ((valid || ctx.collecting()) && node.maxProperties && obj.size() > *node.maxProperties)
+    {
+        valid = ctx.fail("object has more properties than the maximum");
+    }
+
+    // seen-bits of the properties; the inline word covers schemas with up to 64 properties without allocating
+    uint64_t              seenInline = 0;
+    std::vector<uint64_t> seenHeap;
+    uint64_t             *seen = &seenInline;
+    if (node.required.size() > 1)
+    {
+        seenHeap.assign(node.required.size(), 0);
+        seen = seenHeap.data();
+    }
+
+    for (auto const &member: obj)
+    {
+        if (!valid && !ctx.collecting())
+        {
+            break;
+        }
+        uint32_t schema  = npos;
+        bool     matched = false;
+        auto     id      = nameIds_.find(std::string_view{member.key()});
+        if (id != nameIds_.end())
+        {
+            auto slot = std::ranges::lower_bound(node.properties, id->second, {}, &Property::name);
+            if (slot != node.properties.end() && slot->name == id->second)
+            {
+                auto const bit = static_cast<size_t>(slot - node.properties.begin());
+                seen[bit / 64] |= uint64_t{1} << (bit % 64);
+                schema  = slot->schema;
+                matched = true;
+            }
+        }
+        if (!matched)
+        {
+            if (!node.additionalAllowed)
+            {
+                ctx.pushKey(member.key());
+                valid = ctx.fail("property is not allowed");
+                ctx.pop();
+                continue;
+            }
+            schema = node.additional;
+        }
+        if (schema != npos)
+        {
+            ctx.pushKey(member.key());
+            valid = check(schema, member.value(), ctx) && valid;
+            ctx.pop();
+        }
+    }
+
+    for (size_t word = 0; word < node.required.size() && (valid || ctx.collecting()); ++word)
+    {
+        uint64_t missing = node.required[word] & ~seen[word];
+        while (missing != 0)
+        {
+            auto const bit = static_cast<size_t>(std::countr_zero(missing));
+            missing &= missing - 1;
+            valid = ctx.fail("required property '", names_[node.properties[word * 64 + bit].name], "' is missing");
+            if (!ctx.collecting())
+            {
+                break;
+            }
+        }
+    }
+    return valid;
+}
+
+} // namespace util
@@ -0,0 +1,548 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   src/json_struct_mapping.cc
+ * Description: compile-time mapping of C++ structs to json key paths, with direct parsing and serialization
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_struct_mapping.h"
+
+#include "json_key_path.h"
+
+#include <boost/json/basic_parser_impl.hpp>
+#include <exception>
+
+namespace util
+{
+JsonStructLayout::JsonStructLayout(std::span<std::string_view const> paths)
+    : nodes_(1)
+    , fieldCount_(paths.size())
+{
+    for (size_t field = 0; field < paths.size(); ++field)
+    {
+        JsonKeyPath const path{std::string{paths[field]}};
+        size_t            node = 0;
+        for (auto const &key: path.getKeys())
+        {
+            if (nodes_[node].field != npos)
+            {
+                throw std::invalid_argument("Mapped path '" + path.toString() + "' extends another mapped path");
+            }
+            size_t child = npos;
+            if (key->isIndex())
+            {
+                auto const *indexKey = static_cast<JsonIndexKey const *>(key.get());
+                if (indexKey->isEndSymbol() || indexKey->isSelector())
+                {
+                    throw std::invalid_argument("Mapped path '" + path.toString() + "' cannot use [$] or selectors");
+                }
+                if (!nodes_[node].keyChildren.empty())
+                {
+                    throw std::invalid_argument("Mapped path '" + path.toString() + "' uses an object as array");
+                }
+                auto const index = static_cast<size_t>(indexKey->getIndex(array_type{}));
+                child            = indexChild(node, index);
+                if (child == npos)
+                {
+                    child = nodes_.size();
+                    nodes_[node].indexChildren.emplace_back(index, child);
+                    nodes_.emplace_back();
+                }
+            }
+            else
+            {
+                auto const &name = static_cast<JsonStringKey const *>(key.get())->getKey();
+                if (!nodes_[node].indexChildren.empty())
+                {
+                    throw std::invalid_argument("Mapped path '" + path.toString() + "' uses an array as object");
+                }
+                child = keyChild(node, name);
+                if (child == npos)
+                {
+                    child = nodes_.size();
+                    nodes_[node].keyChildren.emplace_back(name, child);
+                    nodes_.emplace_back();
+                }
+            }
+            node = child;
+        }
+        if (nodes_[node].field != npos || !nodes_[node].keyChildren.empty() || !nodes_[node].indexChildren.empty())
+        {
+            throw std::invalid_argument("Mapped path '" + path.toString() + "' is duplicated or a prefix of another");
+        }
+        nodes_[node].field = field;
+    }
+}
+
+size_t JsonStructLayout::fieldCount() const
+{
+    return fieldCount_;
+}
+
+std::vector<JsonStructLayout::Node> const &JsonStructLayout::nodes() const
+{
+    return nodes_;
+}
+
+size_t JsonStructLayout::keyChild(size_t node, std::string_view key) const
+{
+    for (auto const &[name, child]: nodes_[node].keyChildren)
+    {
+        if (name == key)
+        {
+            return child;
+        }
+    }
+    return npos;
+}
+
+size_t JsonStructLayout::indexChild(size_t node, size_t index) const
+{
+    for (auto const &[idx, child]: nodes_[node].indexChildren)
+    {
+        if (idx == index)
+        {
+            return child;
+        }
+    }
+    return npos;
+}
+
+namespace
+{
+/**
+ * SAX handler that follows the layout trie while parsing. Subtrees that are not part of the layout are only counted,
+ * never built.
+ */
+class StructParseHandler
+{
+    struct Frame
+    {
+        size_t node;
+        bool   isArray;
+        size_t nextIndex;
+    };
+
+    JsonStructLayout const          &layout_;
+    std::span<JsonFieldSetter const> setters_;
+    void                            *target_;
+    std::vector<Frame>               frames_;
+    size_t                           skipDepth_ = 0;
+    std::string                      key_;
+    std::string                      text_;
+    size_t                           stringNode_ = JsonStructLayout::npos;
+    bool                             inString_   = false;
+    std::exception_ptr               error_;
+
+    size_t resolveValue()
+    {
+        if (frames_.empty())
+        {
+            return 0;
+        }
+        auto &frame = frames_.back();
+        if (frame.isArray)
+        {
+            return layout_.indexChild(frame.node, frame.nextIndex++);
+        }
+        return layout_.keyChild(frame.node, key_);
+    }
+
+    bool fail(boost::json::error_code &ec, std::exception_ptr error)
+    {
+        error_ = std::move(error);
+        ec     = boost::system::errc::make_error_code(boost::system::errc::invalid_argument);
+        return false;
+    }
+
+    bool scalar(JsonScalar const &scalar, size_t node, boost::json::error_code &ec)
+    {
+        if (node == JsonStructLayout::npos)
+        {
+            return true;
+        }
+        auto const field = layout_.nodes()[node].field;
+        if (field == JsonStructLayout::npos)
+        {
+            // a scalar where the layout expects a container: the mapped fields are simply absent
+            return true;
+        }
+        try
+        {
+            setters_[field](target_, scalar);
+        }
+        catch (...)
+        {
+            return fail(ec, std::current_exception());
+        }
+        return true;
+    }
+
+    bool scalar(value_type const &value, boost::json::error_code &ec)
+    {
+        if (skipDepth_ > 0)
+        {
+            return true;
+        }
+        return scalar(JsonScalar{value, {}, false}, resolveValue(), ec);
+    }
+
+    bool beginContainer(bool isArray, boost::json::error_code &ec)
+    {
+        if (skipDepth_ > 0)
+        {
+            ++skipDepth_;
+            return true;
+        }
+        auto const node = resolveValue();
+        if (node == JsonStructLayout::npos)
+        {
+            skipDepth_ = 1;
+            return true;
+        }
+        if (layout_.nodes()[node].field != JsonStructLayout::npos)
+        {
+            return fail(ec, std::make_exception_ptr(std::invalid_argument("Found a container where a scalar is mapped")));
+        }
+        frames_.push_back(Frame{node, isArray, 0});
+        return true;
+    }
+
+    bool endContainer()
+    {
+        if (skipDepth_ > 0)
+        {
+            --skipDepth_;
+        }
+        else
+        {
+            frames_.pop_back();
+        }
+        return true;
+    }
+
+  public:
+    static constexpr size_t max_object_size = static_cast<size_t>(-1);
+    static constexpr size_t max_array_size  = static_cast<size_t>(-1);
+    static constexpr size_t max_key_size    = static_cast<size_t>(-1);
+    static constexpr size_t max_string_size = static_cast<size_t>(-1);
+
+    StructParseHandler(JsonStructLayout const &layout, std::span<JsonFieldSetter const> setters, void *target)
+        : layout_(layout)
+        , setters_(setters)
+        , target_(target)
+    {
+    }
+
+    [[nodiscard]] std::exception_ptr error() const
+    {
+        return error_;
+    }
+
+    bool on_document_begin(boost::json::error_code & /*ec*/)
+    {
+        return true;
+    }
+
+    bool on_document_end(boost::json::error_code & /*ec*/)
+    {
+        return true;
+    }
+
+    bool on_object_begin(boost::json::error_code &ec)
+    {
+        return beginContainer(false, ec);
+    }
+
+    bool on_object_end(size_t /*n*/, boost::json::error_code & /*ec*/)
+    {
+        return endContainer();
+    }
+
+    bool on_array_begin(boost::json::error_code &ec)
+    {
+        return beginContainer(true, ec);
+    }
+
+    bool on_array_end(size_t /*n*/, boost::json::error_code & /*ec*/)
+    {
+        return endContainer();
+    }
+
+    bool on_key_part(boost::json::string_view part, size_t n, boost::json::error_code & /*ec*/)
+    {
+        if (skipDepth_ == 0)
+        {
+            if (n == part.size())
+            {
+                key_.clear();
+            }
+            key_.append(part.data(), part.size());
+        }
+        return true;
+    }
+
+    bool on_key(boost::json::string_view part, size_t n, boost::json::error_code & /*ec*/)
+    {
+        if (skipDepth_ == 0)
+        {
+            if (n == part.size())
+            {
+                key_.assign(part.data(), part.size());
+            }
+            else
+            {
+                key_.append(part.data(), part.size());
+            }
+        }
+        return true;
+    }
+
+    bool on_string_part(boost::json::string_view part, size_t /*n*/, boost::json::error_code & /*ec*/)
+    {
+        if (skipDepth_ > 0)
+        {
+            return true;
+        }
+        if (!inString_)
+        {
+            inString_   = true;
+            stringNode_ = resolveValue();
+            text_.clear();
+        }
+        if (stringNode_ != JsonStructLayout::npos)
+        {
+            text_.append(part.data(), part.size());
+        }
+        return true;
+    }
+
+    bool on_string(boost::json::string_view part, size_t /*n*/, boost::json::error_code &ec)
+    {
+        if (skipDepth_ > 0)
+        {
+            return true;
+        }
+        size_t node = stringNode_;
+        if (!inString_)
+        {
+            node = resolveValue();
+            if (node == JsonStructLayout::npos)
+            {
+                return true;
+            }
+            return scalar(JsonScalar{{}, std::string_view{part.data(), part.size()}, true}, node, ec);
+        }
+        inString_ = false;
+        if (node == JsonStructLayout::npos)
+        {
+            return true;
+        }
+        text_.append(part.data(), part.size());
+        return scalar(JsonScalar{{}, text_, true}, node, ec);
+    }
+
+    bool on_number_part(boost::json::string_view /*part*/, boost::json::error_code & /*ec*/)
+    {
+        return true;
+    }
+
+    bool on_int64(int64_t i, boost::json::string_view /*text*/, boost::json::error_code &ec)
+    {
+        return scalar(value_type{i}, ec);
+    }
+
+    bool on_uint64(uint64_t u, boost::json::string_view /*text*/, boost::json::error_code &ec)
+    {
+        return scalar(value_type{u}, ec);
+    }
+
+    bool on_double(double d, boost::json::string_view /*text*/, boost::json::error_code &ec)
+    {
+        return scalar(value_type{d}, ec);
+    }
+
+    bool on_bool(bool b, boost::json::error_code &ec)
+    {
+        return scalar(value_type{b}, ec);
+    }
+
+    bool on_null(boost::json::error_code &ec)
+    {
+        return scalar(value_type{nullptr}, ec);
+    }
+
+    bool on_comment_part(boost::json::string_view /*part*/, boost::json::error_code & /*ec*/)
+    {
+        return true;
+    }
+
+    bool on_comment(boost::json::string_view /*part*/, boost::json::error_code & /*ec*/)
+    {
+        return true;
+    }
+};
+
+void serializeNode(
+    JsonStructLayout const          &layout,
+    size_t                           node,
+    std::span<JsonFieldWriter const> writers,
+    void const                      *source,
+    std::string                     &out
+)
+{
+    auto const &current = layout.nodes()[node];
+    if (current.field != JsonStructLayout::npos)
+    {
+        writers[current.field](source, out);
+    }
+    else if (!current.indexChildren.empty())
+    {
+        size_t size = 0;
+        for (auto const &[idx, child]: current.indexChildren)
+        {
+            size = std::max(size, idx + 1);
+        }
+        out += '[';
+        for (size_t idx = 0; idx < size; ++idx)
+        {
+            if (idx > 0)
+            {
+                out += ',';
+            }
+            auto const child = layout.indexChild(node, idx);
+            if (child == JsonStructLayout::npos)
+            {
+                out += "null";
+            }
+            else
+            {
+                serializeNode(layout, child, writers, source, out);
+            }
+        }
+        out += ']';
+    }
+    else
+    {
+        out += '{';
+        for (auto it = current.keyChildren.begin(); it != current.keyChildren.end(); ++it)
+        {
+            if (it != current.keyChildren.begin())
+            {
+                out += ',';
+            }
+            append_json_string(out, it->first);
+            out += ':';
+            serializeNode(layout, it->second, writers, source, out);
+        }
+        out += '}';
+    }
+}
+} // namespace
+
+void parse_struct(
+    std::string_view                 json,
+    JsonStructLayout const          &layout,
+    std::span<JsonFieldSetter const> setters,
+    void                            *target
+)
+{
+    if (setters.size() != layout.fieldCount())
+    {
+        throw std::invalid_argument("Number of setters does not match the struct layout");
+    }
+    boost::json::basic_parser<StructParseHandler> parser{boost::json::parse_options{}, layout, setters, target};
+    boost::json::error_code                       ec;
+    auto const                                    consumed = parser.write_some(false, json.data(), json.size(), ec);
+    if (parser.handler().error())
+    {
+        std::rethrow_exception(parser.handler().error());
+    }
+    if (!ec && consumed < json.size())
+    {
+        // the parser stops after the document; anything behind it is not json
+        ec = boost::json::make_error_code(boost::json::error::extra_data);
+    }
+    if (ec)
+    {
+        throw std::invalid_argument("Cannot parse json: " + ec.message());
+    }
+}
+
+std::string serialize_struct(JsonStructLayout const &layout, std::span<JsonFieldWriter const> writers, void const *source)
+{
+    if (writers.size() != layout.fieldCount())
+    {
+        throw std::invalid_argument("Number of writers does not match the struct layout");
+    }
+    std::string out;
+    serializeNode(layout, 0, writers, source, out);
+    return out;
+}
+
+void append_json_string(std::string &out, std::string_view str)
+{
+    static constexpr char hex[] = "0123456789abcdef";
+    out.reserve(out.size() + str.size() + 2);
+    out += '"';
+    for (char c: str)
+    {
+        switch (c)
+        {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\b':
+                out += "\\b";
+                break;
+            case '\f':
+                out += "\\f";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    out += "\\u00";
+                    out += hex[(static_cast<unsigned char>(c) >> 4) & 0xF];
+                    out += hex[static_cast<unsigned char>(c) & 0xF];
+                }
+                else
+                {
+                    out += c;
+                }
+                break;
+        }
+    }
+    out += '"';
+}
+
+} // namespace util
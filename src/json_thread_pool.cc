@@ -0,0 +1,95 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   src/json_thread_pool.cc
+ * Description: small thread pool for background json work
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_thread_pool.h"
+
+#include <algorithm>
+
+namespace util
+{
+JsonThreadPool::JsonThreadPool(size_t threads)
+{
+    if (threads == 0)
+    {
+        threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i)
+    {
+        workers_.emplace_back([this] { run(); });
+    }
+}
+
+JsonThreadPool::~JsonThreadPool()
+{
+    {
+        std::lock_guard const lock(mutex_);
+        stopping_ = true;
+    }
+    available_.notify_all();
+    workers_.clear();
+}
+
+void JsonThreadPool::submit(Task task)
+{
+    {
+        std::lock_guard const lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    available_.notify_one();
+}
+
+size_t JsonThreadPool::size() const
+{
+    return workers_.size();
+}
+
+JsonThreadPool &JsonThreadPool::shared()
+{
+    // leaked, so tasks still running at exit do not race with the destruction of the pool
+    static auto *const pool = new JsonThreadPool{};
+    return *pool;
+}
+
+void JsonThreadPool::run()
+{
+    while (true)
+    {
+        Task task;
+        {
+            std::unique_lock lock(mutex_);
+            available_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty())
+            {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+} // namespace util
@@ -0,0 +1,147 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   src/json_traversal.cc
+ * Description: non-recursive depth-first traversal of json values
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_traversal.h"
+
+#include <memory>
+
+namespace util
+{
+JsonKeyPath to_key_path(std::span<JsonPathSegment const> path)
+{
+    JsonKeyPath keyPath{};
+    for (auto const &segment : path)
+    {
+        if (segment.isIndex)
+        {
+            keyPath.append(std::make_shared<JsonIndexKey>(segment.index));
+        }
+        else
+        {
+            keyPath.append(std::make_shared<JsonStringKey>(std::string{segment.key}));
+        }
+    }
+    return keyPath;
+}
+
+JsonTraversal::JsonTraversal(value_type const &root)
+    : root_(&root)
+{
+}
+
+bool JsonTraversal::next()
+{
+    if (!started_)
+    {
+        started_ = true;
+        arrive(*root_);
+        return true;
+    }
+    if (event_ != JsonVisitEvent::enter && !path_.empty())
+    {
+        // a scalar or a closed container is done with
+        path_.pop_back();
+    }
+    if (stack_.empty())
+    {
+        return false;
+    }
+
+    auto &frame = stack_.back();
+    if (frame.next == frame.size)
+    {
+        current_ = frame.node;
+        event_   = JsonVisitEvent::leave;
+        stack_.pop_back();
+        return true;
+    }
+    auto const index = frame.next++;
+    if (is_object(*frame.node))
+    {
+        auto const &member = frame.node->get_object().begin()[static_cast<std::ptrdiff_t>(index)];
+        path_.push_back(JsonPathSegment{std::string_view{member.key().data(), member.key().size()}, index, false});
+        arrive(member.value());
+    }
+    else
+    {
+        path_.push_back(JsonPathSegment{{}, index, true});
+        arrive(frame.node->get_array()[index]);
+    }
+    return true;
+}
+
+void JsonTraversal::arrive(value_type const &node)
+{
+    current_ = &node;
+    if (is_object(node))
+    {
+        event_ = JsonVisitEvent::enter;
+        stack_.push_back(Frame{&node, node.get_object().size()});
+    }
+    else if (is_array(node))
+    {
+        event_ = JsonVisitEvent::enter;
+        stack_.push_back(Frame{&node, node.get_array().size()});
+    }
+    else
+    {
+        event_ = JsonVisitEvent::value;
+    }
+}
+
+void JsonTraversal::skip()
+{
+    if (event_ == JsonVisitEvent::enter)
+    {
+        stack_.back().next = stack_.back().size;
+    }
+}
+
+JsonVisitEvent JsonTraversal::event() const
+{
+    return event_;
+}
+
+value_type const &JsonTraversal::value() const
+{
+    return *current_;
+}
+
+size_t JsonTraversal::depth() const
+{
+    return path_.size();
+}
+
+std::span<JsonPathSegment const> JsonTraversal::path() const
+{
+    return path_;
+}
+
+JsonKeyPath JsonTraversal::keyPath() const
+{
+    return to_key_path(path_);
+}
+
+} // namespace util
@@ -0,0 +1,218 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   test/json_array_index_tests.cc
+ * Description: Unit tests for selectors and secondary array indexes
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_frozen_object.h"
+#include "json_object.h"
+
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace util;
+
+class JsonArrayIndexTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // just in case
+    }
+
+    void TearDown() override
+    {
+        // just in case
+    }
+
+    static JsonObject makeUsers()
+    {
+        return JsonObject{R"({"users":[{"id":"a","n":1,"ok":true,"email":"a@x"},)"
+                          R"({"id":"b","n":2,"ok":false,"email":"b@x"},{"name":"no id"},"text",)"
+                          R"({"id":"c","n":3,"email":"c@x"}]})"};
+    }
+};
+
+TEST_F(JsonArrayIndexTest, selector_key_test)
+{
+    JsonKeyPath const path{"users/[id=abc123]/email"};
+    ASSERT_EQ(path.toString(), "users/[id=abc123]/email");
+    auto const* key = static_cast<JsonIndexKey const*>(path.getKeys()[1].get());
+    ASSERT_TRUE(key->isSelector());
+    ASSERT_EQ(key->selectorField(), "id");
+    ASSERT_EQ(key->selectorValue(), "abc123");
+    ASSERT_EQ(JsonIndexKey{"[v=a=b]"}.selectorValue(), "a=b");
+    ASSERT_FALSE(JsonIndexKey{"[3]"}.isSelector());
+
+    ASSERT_TRUE(JsonIndexKey::isValid("[id=1]"));
+    ASSERT_FALSE(JsonIndexKey::isValid("[=1]"));
+    ASSERT_FALSE(JsonIndexKey::isValid("[id=]"));
+    ASSERT_FALSE(JsonIndexKey::isValid("[12=1]"));
+    ASSERT_THROW(JsonKeyPath{"users/[ id=1]"}, std::invalid_argument);
+}
+
+TEST_F(JsonArrayIndexTest, selector_scan_test)
+{
+    auto jsonObj = makeUsers();
+    ASSERT_EQ(jsonObj.get<string>("users/[id=b]/email"), "b@x");
+    ASSERT_EQ(jsonObj.get<string>("users/[n=3]/id"), "c");
+    ASSERT_EQ(jsonObj.get<string>("users/[ok=false]/id"), "b");
+    ASSERT_EQ(jsonObj.get<string>("users/[name=no id]/name"), "no id");
+    ASSERT_THROW(static_cast<void>(jsonObj.get("users/[id=z]")), missing_key_error);
+    ASSERT_EQ(jsonObj.get("users/[id=z]/email", value_type{"none"}), value_type{"none"});
+    ASSERT_EQ(jsonObj.get<optional<int>>("users/[id=z]/n"), nullopt);
+    ASSERT_EQ(jsonObj.tryGet("users/[id=z]").error(), (JsonPathError{json_errc::missing_key, 1}));
+
+    jsonObj.set("users/[id=a]/email", value_type{"new@x"});
+    ASSERT_EQ(jsonObj.get<string>("users/[0]/email"), "new@x");
+    ASSERT_EQ(jsonObj.trySet("users/[id=z]/email", value_type{1}, true).error(),
+              (JsonPathError{json_errc::missing_key, 1}));
+
+    auto frozen = jsonObj.freeze();
+    ASSERT_EQ(frozen.get<int>("users/[id=c]/n"), 3);
+    ASSERT_EQ(frozen.get<optional<int>>("users/[id=z]/n"), nullopt);
+    ASSERT_THROW(static_cast<void>(frozen.get("users/[id=z]")), missing_key_error);
+}
+
+TEST_F(JsonArrayIndexTest, create_and_drop_test)
+{
+    auto jsonObj = makeUsers();
+    ASSERT_TRUE(jsonObj.createIndex("users", "id"));
+    ASSERT_FALSE(jsonObj.createIndex(JsonKeyPath{"users"}, "id"));
+    ASSERT_TRUE(jsonObj.createIndex("users", "n"));
+    ASSERT_TRUE(jsonObj.createIndex("later/[0]/list", "id"));
+    ASSERT_THROW(jsonObj.createIndex("users/[$]", "id"), std::invalid_argument);
+    ASSERT_THROW(jsonObj.createIndex("users/[id=a]", "id"), std::invalid_argument);
+    ASSERT_THROW(jsonObj.createIndex("users", "123"), std::invalid_argument);
+
+    ASSERT_EQ(jsonObj.get<string>("users/[id=c]/email"), "c@x");
+    ASSERT_EQ(jsonObj.get<string>("users/[n=2]/id"), "b");
+    ASSERT_EQ(jsonObj.get<optional<string>>("users/[id=z]/email"), nullopt);
+
+    ASSERT_TRUE(jsonObj.dropIndex("users", "n"));
+    ASSERT_FALSE(jsonObj.dropIndex("users", "n"));
+    ASSERT_EQ(jsonObj.get<string>("users/[n=2]/id"), "b");
+
+    jsonObj.set("later/[0]/list/[$]", from_json_string(R"({"id":"x","v":1})"), true);
+    ASSERT_EQ(jsonObj.get<int>("later/[0]/list/[id=x]/v"), 1);
+}
+
+TEST_F(JsonArrayIndexTest, incremental_maintenance_test)
+{
+    auto jsonObj = makeUsers();
+    jsonObj.createIndex("users", "id");
+
+    jsonObj.set("users/[$]", from_json_string(R"({"id":"d","email":"d@x"})"));
+    jsonObj.set("users/[^]", from_json_string(R"({"id":"first","email":"f@x"})"));
+    ASSERT_EQ(jsonObj.get<string>("users/[id=d]/email"), "d@x");
+    ASSERT_EQ(jsonObj.get<string>("users/[id=first]/email"), "f@x");
+    ASSERT_EQ(jsonObj.get<string>("users/[id=a]/email"), "a@x");
+
+    jsonObj.appendRange("users", {from_json_string(R"({"id":"e"})"), from_json_string(R"({"id":"f"})")});
+    jsonObj.prependRange("users", {from_json_string(R"({"id":"g"})")});
+    ASSERT_EQ(jsonObj.get("users/[id=f]"), jsonObj.get("users/[$]"));
+    ASSERT_EQ(jsonObj.get("users/[id=g]"), jsonObj.get("users/[0]"));
+    ASSERT_EQ(jsonObj.get("users/[id=c]"), jsonObj.get("users/[6]"));
+
+    // changing the indexed member moves the element to its new text
+    jsonObj.set("users/[id=b]/id", value_type{"bb"});
+    ASSERT_EQ(jsonObj.get<string>("users/[id=bb]/email"), "b@x");
+    ASSERT_EQ(jsonObj.get<optional<string>>("users/[id=b]/email"), nullopt);
+    jsonObj.set("users/[3]", from_json_string(R"({"id":"b2"})"));
+    ASSERT_EQ(jsonObj.get<optional<string>>("users/[id=bb]/id"), nullopt);
+    ASSERT_EQ(jsonObj.get<string>("users/[id=b2]/id"), "b2");
+
+    // duplicates resolve to the first element
+    jsonObj.set("users/[^]", from_json_string(R"({"id":"c","email":"dup"})"));
+    ASSERT_EQ(jsonObj.get<string>("users/[id=c]/email"), "dup");
+    jsonObj.set("users/[0]/id", value_type{"c0"});
+    ASSERT_EQ(jsonObj.get<string>("users/[id=c]/email"), "c@x");
+
+    // an unreported change through the mutable root
+    jsonObj.get().as_object()["users"].as_array().erase(jsonObj.get().as_object()["users"].as_array().begin());
+    ASSERT_EQ(jsonObj.get<string>("users/[id=c]/email"), "c@x");
+    jsonObj.clear();
+    ASSERT_EQ(jsonObj.get<optional<string>>("users/[id=c]/email"), nullopt);
+}
+
+TEST_F(JsonArrayIndexTest, cursor_test)
+{
+    auto jsonObj = makeUsers();
+    jsonObj.createIndex("users", "id");
+    auto users = jsonObj.cursor("users");
+    ASSERT_EQ(users.get<string>("[id=b]/email"), "b@x");
+    auto user = users.cursor("[id=c]");
+    ASSERT_EQ(user.path().toString(), "users/[4]");
+    users.set("[id=c]/id", value_type{"cc"});
+    ASSERT_EQ(jsonObj.get<string>("users/[id=cc]/email"), "c@x");
+    users.set("[$]", from_json_string(R"({"id":"z"})"));
+    ASSERT_EQ(jsonObj.get("users/[id=z]"), jsonObj.get("users/[$]"));
+    ASSERT_THROW(static_cast<void>(users.cursor("[id=none]")), missing_key_error);
+}
+
+TEST_F(JsonArrayIndexTest, index_matches_scan_test)
+{
+    auto indexed = JsonObject{R"({"data":{"rows":[]}})"};
+    auto scanned = indexed;
+    indexed.createIndex("data/rows", "k");
+
+    std::mt19937 random{4711};
+    for (int step = 0; step < 2000; ++step)
+    {
+        auto const key   = "k" + std::to_string(random() % 50);
+        auto const other = "k" + std::to_string(random() % 50);
+        auto const row   = from_json_string(R"({"k":")" + key + R"(","step":)" + std::to_string(step) + "}");
+        switch (random() % 6)
+        {
+            case 0:
+                indexed.set("data/rows/[$]", row);
+                scanned.set("data/rows/[$]", row);
+                break;
+            case 1:
+                indexed.set("data/rows/[^]", row);
+                scanned.set("data/rows/[^]", row);
+                break;
+            case 2:
+                static_cast<void>(indexed.trySet("data/rows/[k=" + other + "]/k", value_type{key}));
+                static_cast<void>(scanned.trySet("data/rows/[k=" + other + "]/k", value_type{key}));
+                break;
+            case 3:
+                indexed.appendRange("data/rows", {row, row});
+                scanned.appendRange("data/rows", {row, row});
+                break;
+            case 4:
+                indexed.insertRange("data/rows", indexed.get("data/rows").as_array().size() / 2, {row});
+                scanned.insertRange("data/rows", scanned.get("data/rows").as_array().size() / 2, {row});
+                break;
+            default:
+                static_cast<void>(indexed.trySet("data/rows/[k=" + other + "]", row));
+                static_cast<void>(scanned.trySet("data/rows/[k=" + other + "]", row));
+                break;
+        }
+        auto const probe = "data/rows/[k=" + other + "]/step";
+        ASSERT_EQ(indexed.get<optional<int>>(probe), scanned.get<optional<int>>(probe)) << "step " << step;
+    }
+    ASSERT_EQ(indexed.toString(0), scanned.toString(0));
+}
@@ -0,0 +1,234 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   test/json_async_tests.cc
+ * Description: Unit tests for asynchronous loading and writing
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_async.h"
+#include "json_object.h"
+#include "json_thread_pool.h"
+
+#include <coroutine>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <future>
+#include <gtest/gtest.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+using namespace std;
+using namespace util;
+
+namespace
+{
+struct Detached
+{
+    struct promise_type
+    {
+        Detached get_return_object()
+        {
+            return {};
+        }
+
+        suspend_never initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void()
+        {
+        }
+
+        void unhandled_exception()
+        {
+            terminate();
+        }
+    };
+};
+
+template<typename T>
+Detached awaitInto(JsonAsync<T> operation, shared_ptr<promise<T>> done)
+{
+    try
+    {
+        if constexpr (is_void_v<T>)
+        {
+            co_await operation;
+            done->set_value();
+        }
+        else
+        {
+            done->set_value(co_await operation);
+        }
+    }
+    catch (...)
+    {
+        done->set_exception(current_exception());
+    }
+}
+
+template<typename T>
+T awaitBlocking(JsonAsync<T> operation)
+{
+    auto done   = make_shared<promise<T>>();
+    auto result = done->get_future();
+    awaitInto(std::move(operation), done);
+    return result.get();
+}
+} // namespace
+
+class JsonAsyncTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // just in case
+    }
+
+    void TearDown() override
+    {
+        // just in case
+    }
+};
+
+TEST_F(JsonAsyncTest, write_and_load_async_test)
+{
+    string const   filename = "./JsonAsyncTest_write_and_load.json";
+    JsonThreadPool pool{1}; // chunks must not wait for a free worker
+    JsonObject     jsonObj{R"({"a":[1,2,3,{"b":"some longer text"}],"c":{"d":null,"e":1.5}})"};
+
+    for (size_t indent : {0UL, 4UL})
+    {
+        awaitBlocking(jsonObj.writeAsync(filename, indent, JsonAsyncOptions{.pool = &pool, .chunkSize = 7}));
+        JsonObject expected{};
+        expected.load(filename);
+        ASSERT_EQ(expected.toString(0), jsonObj.toString(0));
+
+        auto loaded = awaitBlocking(JsonObject::loadAsync(filename, JsonAsyncOptions{.pool = &pool, .chunkSize = 5}));
+        ASSERT_EQ(loaded.toString(0), jsonObj.toString(0));
+    }
+    ASSERT_FALSE(filesystem::exists(filename + ".tmp"));
+    std::remove(filename.c_str());
+
+    ASSERT_THROW(awaitBlocking(JsonObject::loadAsync("/definitely/not/a/real/file.json")), std::invalid_argument);
+    ASSERT_THROW(awaitBlocking(jsonObj.writeAsync("/definitely/not/a/real/file.json")), std::invalid_argument);
+}
+
+TEST_F(JsonAsyncTest, load_async_replays_journal_test)
+{
+    string const filename = "./JsonAsyncTest_journal.json";
+    {
+        JsonObject jsonObj{R"({"a":1})"};
+        jsonObj.enableJournal(filename);
+        jsonObj.set("list/[$]", value_type{2}, true);
+    }
+    auto loaded = awaitBlocking(JsonObject::loadAsync(filename, JsonAsyncOptions{.chunkSize = 3}));
+    ASSERT_EQ(loaded.toString(0), R"({"a":1,"list":[2]})");
+    std::remove(filename.c_str());
+    std::remove(JsonJournal::journalFileName(filename).c_str());
+}
+
+TEST_F(JsonAsyncTest, resume_on_executor_test)
+{
+    string const filename = "./JsonAsyncTest_executor.json";
+    JsonObject{R"({"a":1})"}.write(filename, 0);
+
+    // a minimal event loop: the handle is posted back and resumed by this thread
+    mutex                         queueMutex;
+    deque<coroutine_handle<>>     queue;
+    JsonAsyncOptions              options;
+    options.executor = [&](coroutine_handle<> handle) {
+        lock_guard const lock(queueMutex);
+        queue.push_back(handle);
+    };
+
+    auto done   = make_shared<promise<JsonObject>>();
+    auto result = done->get_future();
+    awaitInto(JsonObject::loadAsync(filename, options), done);
+    while (result.wait_for(chrono::milliseconds(1)) != future_status::ready)
+    {
+        coroutine_handle<> handle;
+        {
+            lock_guard const lock(queueMutex);
+            if (queue.empty())
+            {
+                continue;
+            }
+            handle = queue.front();
+            queue.pop_front();
+        }
+        handle.resume();
+    }
+    ASSERT_EQ(result.get().get("a"), value_type{1});
+    std::remove(filename.c_str());
+}
+
+TEST_F(JsonAsyncTest, cancellation_test)
+{
+    string const filename = "./JsonAsyncTest_cancellation.json";
+    JsonObject{R"({"a":1})"}.write(filename, 0);
+
+    stop_source stop;
+    stop.request_stop();
+    ASSERT_THROW(
+        awaitBlocking(JsonObject::loadAsync(filename, JsonAsyncOptions{.stop = stop.get_token()})),
+        cancelled_error
+    );
+    JsonObject other{R"({"a":2})"};
+    ASSERT_THROW(awaitBlocking(other.writeAsync(filename, 0, JsonAsyncOptions{.stop = stop.get_token()})),
+                 cancelled_error);
+
+    // the old file is left in place
+    JsonObject loaded{};
+    loaded.load(filename);
+    ASSERT_EQ(loaded.get("a"), value_type{1});
+    ASSERT_FALSE(filesystem::exists(filename + ".tmp"));
+    std::remove(filename.c_str());
+}
+
+TEST_F(JsonAsyncTest, pending_task_runs_inline_when_pool_is_busy_test)
+{
+    JsonThreadPool pool{1};
+    promise<void>  release;
+    auto           released = release.get_future().share();
+    pool.submit([released] { released.wait(); });
+
+    JsonPendingTask task;
+    auto const      caller = this_thread::get_id();
+    thread::id      ranOn;
+    task.start(pool, [&ranOn] { ranOn = this_thread::get_id(); });
+    task.wait();
+    ASSERT_EQ(ranOn, caller);
+    release.set_value();
+
+    task.start(pool, [] { throw std::runtime_error("failed"); });
+    ASSERT_THROW(task.wait(), std::runtime_error);
+}
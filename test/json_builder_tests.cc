@@ -0,0 +1,167 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   test/json_builder_tests.cc
+ * Description: Unit tests for the streaming builder and writer
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_builder.h"
+#include "json_memory.h"
+#include "json_object.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace std;
+using namespace util;
+
+class JsonBuilderTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // just in case
+    }
+
+    void TearDown() override
+    {
+        // just in case
+    }
+
+    /**
+     * Emit the same document to a JsonBuilder or a JsonWriter.
+     */
+    template<typename Sink>
+    static void emit(Sink& sink)
+    {
+        sink.beginObject(4)
+            .key("id")
+            .value(17)
+            .key("name")
+            .value("quote\" backslash\\ newline\n tab\t bell\x07")
+            .key("values")
+            .beginArray(3)
+            .value(1.5)
+            .value(-2)
+            .value(nullptr)
+            .end()
+            .key("nested")
+            .beginObject()
+            .key("flag")
+            .value(true)
+            .key("empty")
+            .beginArray()
+            .end()
+            .key("whole")
+            .value(from_json_string(R"({"a":[1,{"b":2.0}]})"))
+            .key("big")
+            .value(18446744073709551615ULL)
+            .end()
+            .end();
+    }
+};
+
+TEST_F(JsonBuilderTest, builder_matches_set_test)
+{
+    JsonBuilder builder;
+    ASSERT_FALSE(builder.complete());
+    emit(builder);
+    ASSERT_TRUE(builder.complete());
+    auto const built = builder.release();
+    ASSERT_FALSE(builder.complete());
+
+    JsonObject expected;
+    expected.set("id", value_type{17});
+    expected.set("name", value_type{"quote\" backslash\\ newline\n tab\t bell\x07"});
+    expected.set("values/[$]", value_type{1.5}, true);
+    expected.set("values/[$]", value_type{-2}, true);
+    expected.set("values/[$]", value_type{nullptr}, true);
+    expected.set("nested/flag", value_type{true}, true);
+    expected.set("nested/empty", array_type{}, true);
+    expected.set("nested/whole", from_json_string(R"({"a":[1,{"b":2.0}]})"), true);
+    expected.set("nested/big", value_type{18446744073709551615ULL}, true);
+    ASSERT_EQ(built, expected.get());
+
+    builder.beginArray().value(1).end();
+    ASSERT_EQ(builder.release(), from_json_string("[1]"));
+    builder.value("scalar");
+    ASSERT_EQ(builder.release(), value_type{"scalar"});
+}
+
+TEST_F(JsonBuilderTest, builder_uses_storage_test)
+{
+    auto        storage = boost::json::make_shared_resource<TrackingMemoryResource>();
+    JsonBuilder builder{storage};
+    builder.beginObject(1).key("list").beginArray(100);
+    for (int64_t i = 0; i < 100; ++i)
+    {
+        builder.value(i);
+    }
+    builder.end().end();
+    auto const built = builder.release();
+    ASSERT_EQ(built.storage().get(), storage.get());
+    ASSERT_EQ(built.as_object().at("list").as_array().size(), 100UL);
+    ASSERT_GE(built.as_object().at("list").as_array().capacity(), 100UL);
+    ASSERT_GT(dynamic_cast<TrackingMemoryResource const*>(storage.get())->usage().liveBytes, 0UL);
+}
+
+TEST_F(JsonBuilderTest, writer_matches_builder_test)
+{
+    string     text;
+    JsonWriter writer{text};
+    emit(writer);
+    ASSERT_TRUE(writer.complete());
+
+    JsonBuilder builder;
+    emit(builder);
+    ASSERT_EQ(from_json_string(text), builder.release());
+    ASSERT_NE(text.find(R"(\u0007)"), string::npos);
+
+    string     numbers;
+    JsonWriter numberWriter{numbers};
+    numberWriter.beginArray().value(2.0).value(0.1).value(-3).value(1e300).end();
+    ASSERT_EQ(numbers, "[2.0,0.1,-3,1e+300]");
+    ASSERT_TRUE(from_json_string(numbers).as_array()[0].is_double());
+}
+
+TEST_F(JsonBuilderTest, out_of_order_calls_test)
+{
+    JsonBuilder builder;
+    ASSERT_THROW(builder.key("a"), std::invalid_argument);
+    ASSERT_THROW(builder.end(), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(builder.release()), std::invalid_argument);
+    builder.beginObject();
+    ASSERT_THROW(builder.value(1), std::invalid_argument);
+    builder.key("a");
+    ASSERT_THROW(builder.key("b"), std::invalid_argument);
+    ASSERT_THROW(builder.end(), std::invalid_argument);
+    builder.value(1).end();
+    ASSERT_THROW(builder.value(2), std::invalid_argument);
+
+    string     text;
+    JsonWriter writer{text};
+    ASSERT_THROW(writer.key("a"), std::invalid_argument);
+    writer.beginArray();
+    ASSERT_THROW(writer.key("a"), std::invalid_argument);
+    writer.end();
+    ASSERT_THROW(writer.beginObject(), std::invalid_argument);
+    ASSERT_EQ(text, "[]");
+}
@@ -0,0 +1,173 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   test/json_column_tests.cc
+ * Description: Unit tests for numeric columns extracted from json arrays
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_column.h"
+#include "json_object.h"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <string>
+
+using namespace std;
+using namespace util;
+
+class JsonColumnTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // just in case
+    }
+
+    void TearDown() override
+    {
+        // just in case
+    }
+};
+
+TEST_F(JsonColumnTest, extract_test)
+{
+    JsonObject jsonObj{R"({"samples":[{"latency_ms":1.5},{"latency_ms":7},{"other":1},{"latency_ms":"slow"},)"
+                       R"({"latency_ms":-2},5,{"latency_ms":null},{"latency_ms":18446744073709551615},)"
+                       R"({"latency_ms":2.0}]})"};
+
+    auto const doubles = jsonObj.column<double>("samples", "latency_ms");
+    ASSERT_EQ(doubles.size(), 9UL);
+    ASSERT_EQ(doubles.validCount(), 5UL);
+    ASSERT_EQ(doubles.nullCount(), 4UL);
+    ASSERT_EQ(doubles[0], 1.5);
+    ASSERT_EQ(doubles[1], 7.0);
+    ASSERT_EQ(doubles[2], nullopt);
+    ASSERT_EQ(doubles[3], nullopt);
+    ASSERT_EQ(doubles[5], nullopt);
+    ASSERT_EQ(doubles[7], 18446744073709551615.0);
+    ASSERT_EQ(doubles.values()[3], 0.0);
+    ASSERT_EQ(doubles.validity().size(), 1UL);
+    ASSERT_EQ(doubles.validity()[0], 0b110010011UL);
+
+    // 1.5 is not integral and the uint64 is out of range; 2.0 is taken as 2
+    auto const ints = jsonObj.column<int64_t>(JsonKeyPath{"samples"}, JsonKeyPath{"latency_ms"});
+    ASSERT_EQ(ints.validCount(), 3UL);
+    ASSERT_EQ(ints[0], nullopt);
+    ASSERT_EQ(ints[1], 7);
+    ASSERT_EQ(ints[4], -2);
+    ASSERT_EQ(ints[8], 2);
+    ASSERT_EQ(ints.sum(), 7);
+    ASSERT_EQ(ints.min(), -2);
+    ASSERT_EQ(ints.max(), 7);
+    ASSERT_EQ(ints.mean(), 7.0 / 3.0);
+
+    JsonObject plain{R"({"list":[3,1,4,1,5],"deep":[{"a":[{"b":1}]},{"a":[{"b":2},{"b":3}]}],"text":"x"})"};
+    ASSERT_EQ(plain.column<int64_t>("list").sum(), 14);
+    auto const deep = plain.column<int64_t>("deep", "a/[$]/b");
+    ASSERT_EQ(deep[0], 1);
+    ASSERT_EQ(deep[1], 3);
+    ASSERT_EQ(plain.column<int64_t>("deep", "a/[b=2]/b").validCount(), 1UL);
+
+    ASSERT_THROW(static_cast<void>(plain.column<double>("text")), expected_array_error);
+    ASSERT_THROW(static_cast<void>(plain.column<double>("missing")), missing_key_error);
+}
+
+TEST_F(JsonColumnTest, empty_test)
+{
+    JsonColumn<double> column;
+    ASSERT_TRUE(column.empty());
+    ASSERT_EQ(column.sum(), 0.0);
+    ASSERT_EQ(column.min(), nullopt);
+    ASSERT_EQ(column.max(), nullopt);
+    ASSERT_EQ(column.mean(), nullopt);
+
+    for (int i = 0; i < 70; ++i)
+    {
+        column.pushNull();
+    }
+    ASSERT_EQ(column.validity().size(), 2UL);
+    ASSERT_EQ(column.sum(), 0.0);
+    ASSERT_EQ(column.max(), nullopt);
+    column.push_back(-1.0);
+    ASSERT_EQ(column.max(), -1.0);
+    ASSERT_EQ(column.min(), -1.0);
+    ASSERT_EQ(column.mean(), -1.0);
+}
+
+TEST_F(JsonColumnTest, kernels_agree_test)
+{
+    // nulls and lengths not divisible by four exercise the masks and the tails of the vectorized kernels
+    mt19937_64                             random{49};
+    uniform_real_distribution<double>      real{-1e6, 1e6};
+    uniform_int_distribution<int64_t>      integer{numeric_limits<int64_t>::min(), numeric_limits<int64_t>::max()};
+    bernoulli_distribution                 isNull{0.3};
+    for (size_t size: {1UL, 3UL, 4UL, 5UL, 63UL, 64UL, 65UL, 1000UL, 4099UL})
+    {
+        JsonColumn<double>  doubles;
+        JsonColumn<int64_t> ints;
+        double              doubleMin = numeric_limits<double>::infinity();
+        int64_t             intMax    = numeric_limits<int64_t>::min();
+        for (size_t i = 0; i < size; ++i)
+        {
+            if (isNull(random))
+            {
+                doubles.pushNull();
+                ints.pushNull();
+            }
+            else
+            {
+                doubles.push_back(real(random));
+                ints.push_back(integer(random));
+                doubleMin = std::min(doubleMin, *doubles[i]);
+                intMax    = std::max(intMax, *ints[i]);
+            }
+        }
+        ASSERT_EQ(doubles.sum(), doubles.sum(JsonColumnKernel::scalar));
+        ASSERT_EQ(doubles.min(), doubles.min(JsonColumnKernel::scalar));
+        ASSERT_EQ(doubles.max(), doubles.max(JsonColumnKernel::scalar));
+        ASSERT_EQ(doubles.mean(), doubles.mean(JsonColumnKernel::scalar));
+        ASSERT_EQ(ints.sum(), ints.sum(JsonColumnKernel::scalar));
+        ASSERT_EQ(ints.min(), ints.min(JsonColumnKernel::scalar));
+        ASSERT_EQ(ints.max(), ints.max(JsonColumnKernel::scalar));
+        if (doubles.validCount() > 0)
+        {
+            ASSERT_EQ(doubles.min(), doubleMin);
+            ASSERT_EQ(ints.max(), intMax);
+        }
+    }
+}
+
+TEST_F(JsonColumnTest, extreme_values_test)
+{
+    JsonColumn<int64_t> ints;
+    ints.push_back(numeric_limits<int64_t>::max());
+    ints.pushNull();
+    ints.push_back(numeric_limits<int64_t>::min());
+    ints.push_back(1);
+    ints.push_back(1);
+    // the sum wraps around
+    ASSERT_EQ(ints.sum(), 1);
+    ASSERT_EQ(ints.sum(JsonColumnKernel::scalar), 1);
+    ASSERT_EQ(ints.min(), numeric_limits<int64_t>::min());
+    ASSERT_EQ(ints.max(), numeric_limits<int64_t>::max());
+}
@@ -0,0 +1,158 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   test/json_compression_tests.cc
+ * Description: Unit tests for compressed loading and writing
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_compression.h"
+#include "json_object.h"
+
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#if defined(JSONOBJECT_ENABLE_ZLIB)
+    #include <zlib.h>
+#endif
+
+using namespace std;
+using namespace util;
+
+class JsonCompressionTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // just in case
+    }
+
+    void TearDown() override
+    {
+        // just in case
+    }
+
+    static string readFile(string const& filename)
+    {
+        ifstream      ifs(filename.c_str(), ios::binary);
+        ostringstream content;
+        content << ifs.rdbuf();
+        return content.str();
+    }
+
+    static void writeFile(string const& filename, string const& content)
+    {
+        ofstream ofs(filename.c_str(), ios::binary);
+        ofs << content;
+    }
+
+#if defined(JSONOBJECT_ENABLE_ZLIB)
+    static string zlibCompress(string const& text)
+    {
+        auto   size = compressBound(static_cast<uLong>(text.size()));
+        string compressed(size, '\0');
+        compress2(reinterpret_cast<Bytef*>(compressed.data()),
+                  &size,
+                  reinterpret_cast<Bytef const*>(text.data()),
+                  static_cast<uLong>(text.size()),
+                  Z_BEST_SPEED);
+        compressed.resize(size);
+        return compressed;
+    }
+#endif
+};
+
+TEST_F(JsonCompressionTest, write_and_load_compressed_test)
+{
+#if defined(JSONOBJECT_ENABLE_ZLIB)
+    string const filename = "./JsonCompressionTest_round_trip.json.gz";
+    JsonObject   jsonObj{};
+    for (int i = 0; i < 200; ++i)
+    {
+        jsonObj.set("items/[$]", from_json_string(R"({"id":)" + to_string(i) + R"(,"name":"item","tags":["a","b"]})"),
+                    true);
+    }
+
+    for (size_t indent : {0UL, 2UL})
+    {
+        // small buffers, so the threads hand over many chunks
+        JsonCompressionOptions const options{.level = 9, .chunkSize = 100, .ringSlots = 2};
+        jsonObj.writeCompressed(filename, indent, options);
+        auto const compressed = readFile(filename);
+        ASSERT_EQ(compressed.substr(0, 2), "\x1f\x8b");
+        ASSERT_LT(compressed.size(), jsonObj.toString(indent).size() / 4);
+
+        JsonObject loaded{};
+        loaded.loadCompressed(filename, options);
+        ASSERT_EQ(loaded.toString(0), jsonObj.toString(0));
+        loaded.loadCompressed(filename);
+        ASSERT_EQ(loaded.toString(0), jsonObj.toString(0));
+    }
+    std::remove(filename.c_str());
+#else
+    GTEST_SKIP() << "built without JSONOBJECT_ENABLE_ZLIB";
+#endif
+}
+
+TEST_F(JsonCompressionTest, load_zlib_and_concatenated_streams_test)
+{
+#if defined(JSONOBJECT_ENABLE_ZLIB)
+    string const filename = "./JsonCompressionTest_formats.json.z";
+    writeFile(filename, zlibCompress(R"({"a":[1,2,3]})"));
+    JsonObject loaded{};
+    loaded.loadCompressed(filename);
+    ASSERT_EQ(loaded.toString(0), R"({"a":[1,2,3]})");
+
+    // a file of two streams, as appending to a gzip file produces
+    writeFile(filename, zlibCompress(R"({"a":[1,)") + zlibCompress(R"(2,3],"b":true})"));
+    loaded.loadCompressed(filename, JsonCompressionOptions{.chunkSize = 3});
+    ASSERT_EQ(loaded.toString(0), R"({"a":[1,2,3],"b":true})");
+    std::remove(filename.c_str());
+#else
+    GTEST_SKIP() << "built without JSONOBJECT_ENABLE_ZLIB";
+#endif
+}
+
+TEST_F(JsonCompressionTest, compressed_errors_test)
+{
+#if defined(JSONOBJECT_ENABLE_ZLIB)
+    string const filename = "./JsonCompressionTest_errors.json.gz";
+    JsonObject   jsonObj{};
+    ASSERT_THROW(jsonObj.loadCompressed("/definitely/not/a/real/file.json.gz"), std::invalid_argument);
+    ASSERT_THROW(jsonObj.writeCompressed("/definitely/not/a/real/file.json.gz"), std::invalid_argument);
+
+    writeFile(filename, R"({"not":"compressed"})");
+    ASSERT_THROW(jsonObj.loadCompressed(filename), std::invalid_argument);
+
+    auto const compressed = zlibCompress(R"({"a":"some text that is long enough to be cut"})");
+    writeFile(filename, compressed.substr(0, compressed.size() - 6));
+    ASSERT_THROW(jsonObj.loadCompressed(filename), std::invalid_argument);
+
+    writeFile(filename, zlibCompress(R"({"a":)"));
+    ASSERT_THROW(jsonObj.loadCompressed(filename), std::invalid_argument);
+    writeFile(filename, zlibCompress(R"({"a":1} trailing)"));
+    ASSERT_THROW(jsonObj.loadCompressed(filename), std::invalid_argument);
+    std::remove(filename.c_str());
+#else
+    GTEST_SKIP() << "built without JSONOBJECT_ENABLE_ZLIB";
+#endif
+}
@@ -0,0 +1,231 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   test/json_cursor_tests.cc
+ * Description: Unit tests for cursors pinning a node of a json object
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_journal.h"
+#include "json_object.h"
+
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace std;
+using namespace util;
+
+class JsonCursorTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // just in case
+    }
+
+    void TearDown() override
+    {
+        // just in case
+    }
+
+    static JsonObject makeTenants()
+    {
+        return JsonObject{R"({"tenants":[{"name":"a","limits":{"rps":10,"burst":20,"quota":{"gb":1}}},)"
+                          R"({"name":"b","limits":{"rps":30,"burst":40}}],"version":3})"};
+    }
+};
+
+TEST_F(JsonCursorTest, relative_get_test)
+{
+    auto jsonObj = makeTenants();
+    auto limits  = jsonObj.cursor("tenants/[$]/limits");
+    ASSERT_EQ(limits.depth(), 3UL);
+    ASSERT_EQ(limits.path().toString(), "tenants/[1]/limits");
+    ASSERT_EQ(limits.get<int>("rps"), 30);
+    ASSERT_EQ(limits.get<int>(JsonKeyPath{"burst"}), 40);
+    ASSERT_EQ(limits.get<int>("missing", 5), 5);
+    ASSERT_EQ(limits.get<optional<int>>("missing"), nullopt);
+    ASSERT_EQ(limits.get("burst"), value_type{40});
+    ASSERT_EQ(limits.get(JsonKeyPath{}), jsonObj.get("tenants/[1]/limits"));
+    ASSERT_EQ(limits.value(), jsonObj.get("tenants/[1]/limits"));
+
+    ASSERT_THROW(static_cast<void>(limits.get("missing")), missing_key_error);
+    ASSERT_THROW(static_cast<void>(limits.get("rps/x")), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(jsonObj.cursor("tenants/[7]")), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(jsonObj.cursor("tenants/[0]/nothing")), missing_key_error);
+
+    auto root = jsonObj.cursor();
+    ASSERT_FALSE(root.hasParent());
+    ASSERT_EQ(root.get<int>("version"), 3);
+}
+
+TEST_F(JsonCursorTest, relative_set_test)
+{
+    auto jsonObj = makeTenants();
+    jsonObj.enableFragmentCache();
+    ASSERT_FALSE(jsonObj.toString(0).empty());
+
+    auto limits = jsonObj.cursor("tenants/[0]/limits");
+    limits.set("rps", value_type{11});
+    limits.set(JsonKeyPath{"extra/deep"}, value_type{true}, true);
+    ASSERT_EQ(jsonObj.get<int>("tenants/[0]/limits/rps"), 11);
+    ASSERT_EQ(jsonObj.get<bool>("tenants/[0]/limits/extra/deep"), true);
+    ASSERT_EQ(limits.get<int>("rps"), 11);
+    // the fragment cache sees the full path
+    ASSERT_EQ(from_json_string(jsonObj.toString(0)).as_object().at("tenants").as_array()[0].as_object().at("limits"),
+              limits.value());
+
+    ASSERT_THROW(limits.set("rps/x", value_type{1}), expected_object_error);
+    ASSERT_THROW(limits.set("none/x", value_type{1}), missing_key_error);
+    ASSERT_TRUE(limits.isValid());
+}
+
+TEST_F(JsonCursorTest, relative_set_journal_test)
+{
+    string const filename = "./JsonCursorTest_journal.json";
+    std::remove(filename.c_str());
+    std::remove(JsonJournal::journalFileName(filename).c_str());
+    {
+        auto jsonObj = makeTenants();
+        jsonObj.enableJournal(filename);
+        auto quota = jsonObj.cursor("tenants/[^]/limits/quota");
+        quota.set("gb", value_type{2});
+        quota.set("list/[$]", value_type{"x"}, true);
+        jsonObj.flushJournal();
+
+        JsonObject loaded{};
+        loaded.load(filename);
+        ASSERT_EQ(loaded.toString(0), jsonObj.toString(0));
+        ASSERT_EQ(loaded.get<int>("tenants/[0]/limits/quota/gb"), 2);
+    }
+    std::remove(filename.c_str());
+    std::remove(JsonJournal::journalFileName(filename).c_str());
+}
+
+TEST_F(JsonCursorTest, navigation_test)
+{
+    auto jsonObj = makeTenants();
+    auto rps     = jsonObj.cursor("tenants/[0]/limits/rps");
+
+    auto limits = rps.parent();
+    ASSERT_EQ(limits.path().toString(), "tenants/[0]/limits");
+    ASSERT_EQ(limits.cursor("quota").get<int>("gb"), 1);
+    ASSERT_EQ(limits.cursor(JsonKeyPath{"quota/gb"}).path().toString(), "tenants/[0]/limits/quota/gb");
+
+    auto burst = rps.nextSibling();
+    ASSERT_TRUE(burst.has_value());
+    ASSERT_EQ(burst->path().toString(), "tenants/[0]/limits/burst");
+    ASSERT_EQ(burst->value(), value_type{20});
+    ASSERT_EQ(burst->previousSibling()->value(), value_type{10});
+    ASSERT_FALSE(rps.previousSibling().has_value());
+    ASSERT_FALSE(limits.cursor("quota").nextSibling().has_value());
+
+    auto first  = limits.parent();
+    auto second = first.nextSibling();
+    ASSERT_TRUE(second.has_value());
+    ASSERT_EQ(second->get<string>("name"), "b");
+    ASSERT_FALSE(second->nextSibling().has_value());
+    ASSERT_EQ(second->previousSibling()->get<string>("name"), "a");
+
+    auto root = first.parent().parent();
+    ASSERT_FALSE(root.hasParent());
+    ASSERT_FALSE(root.nextSibling().has_value());
+    ASSERT_THROW(static_cast<void>(root.parent()), std::invalid_argument);
+}
+
+TEST_F(JsonCursorTest, invalidation_test)
+{
+    auto jsonObj = makeTenants();
+    auto second  = jsonObj.cursor("tenants/[1]/limits");
+    ASSERT_TRUE(second.isValid());
+
+    // removing the first tenant moves the second one
+    jsonObj.get().as_object()["tenants"].as_array().erase(jsonObj.get().as_object()["tenants"].as_array().begin());
+    ASSERT_FALSE(second.isValid());
+#ifdef NDEBUG
+    GTEST_SKIP() << "cursors are only checked on access without NDEBUG";
+#else
+    ASSERT_THROW(static_cast<void>(second.get("rps")), invalid_cursor_error);
+    ASSERT_THROW(static_cast<void>(second.value()), invalid_cursor_error);
+    ASSERT_THROW(second.set("rps", value_type{1}), invalid_cursor_error);
+
+    auto root = jsonObj.cursor();
+    jsonObj.clear();
+    ASSERT_TRUE(root.isValid());
+    ASSERT_EQ(root.value(), from_json_string("{}"));
+#endif
+}
+
+TEST_F(JsonCursorTest, shift_invalidation_test)
+{
+    JsonObject jsonObj;
+    jsonObj.reserve("arr", 16, true);
+    for (int i = 0; i < 5; ++i)
+    {
+        jsonObj.set("arr/[$]", value_type{i});
+    }
+    auto third = jsonObj.cursor("arr/[3]");
+    auto arr   = jsonObj.cursor("arr");
+    ASSERT_EQ(third.value(), value_type{3});
+
+    // appending and replacing elements keeps the indices
+    jsonObj.set("arr/[$]", value_type{5});
+    jsonObj.set("arr/[0]", value_type{-1});
+    jsonObj.appendRange("arr", {value_type{6}});
+    ASSERT_TRUE(third.isValid());
+
+    // the reserved capacity keeps the element in place, but [3] now addresses the former [2]
+    jsonObj.set("arr/[^]", value_type{-2});
+    ASSERT_FALSE(third.isValid());
+    ASSERT_TRUE(arr.isValid());
+
+    auto fourth = jsonObj.cursor("arr/[4]");
+    jsonObj.insertRange("arr", 2, {value_type{7}});
+    ASSERT_FALSE(fourth.isValid());
+    ASSERT_TRUE(arr.isValid());
+
+    auto first = jsonObj.cursor("arr/[1]");
+    static_cast<void>(jsonObj.get());
+    ASSERT_FALSE(first.isValid());
+    ASSERT_TRUE(jsonObj.cursor("arr/[1]").isValid());
+}
+
+TEST_F(JsonCursorTest, many_shifted_arrays_test)
+{
+    // prepending into more arrays than are tracked one by one still invalidates the cursors through them
+    JsonObject jsonObj;
+    for (int i = 0; i < 2000; ++i)
+    {
+        jsonObj.set("lists/l" + std::to_string(i) + "/[$]", value_type{i}, true);
+    }
+    auto early = jsonObj.cursor("lists/l1999/[0]");
+    for (int i = 0; i < 2000; ++i)
+    {
+        jsonObj.set("lists/l" + std::to_string(i) + "/[^]", value_type{-i});
+    }
+    ASSERT_FALSE(early.isValid());
+
+    auto late = jsonObj.cursor("lists/l1999/[1]");
+    ASSERT_TRUE(late.isValid());
+    ASSERT_EQ(late.value(), value_type{1999});
+    jsonObj.set("lists/l5/[$]", value_type{5});
+    ASSERT_TRUE(late.isValid());
+}
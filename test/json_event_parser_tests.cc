@@ -0,0 +1,298 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   test/json_event_parser_tests.cc
+ * Description: Unit tests for the event-driven parser
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_event_parser.h"
+#include "json_types.h"
+
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace util;
+
+class JsonEventParserTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // just in case
+    }
+
+    void TearDown() override
+    {
+        // just in case
+    }
+
+    /**
+     * Records every event as "<event> <path>"; the actions can be chosen per event and path.
+     */
+    struct Recorder : JsonEventHandler
+    {
+        vector<string>                                                   events;
+        vector<value_type>                                               subtrees;
+        function<JsonParseAction(string const&, JsonEventParser const&)> decide = [](auto const&, auto const&) {
+            return JsonParseAction::proceed;
+        };
+
+        JsonParseAction record(string const& event, JsonEventParser const& parser)
+        {
+            events.push_back(event + " " + parser.keyPath().toString());
+            return decide(event, parser);
+        }
+
+        JsonParseAction onObjectBegin(JsonEventParser const& parser) override
+        {
+            return record("{", parser);
+        }
+
+        JsonParseAction onObjectEnd(JsonEventParser const& parser) override
+        {
+            return record("}", parser);
+        }
+
+        JsonParseAction onArrayBegin(JsonEventParser const& parser) override
+        {
+            return record("[", parser);
+        }
+
+        JsonParseAction onArrayEnd(JsonEventParser const& parser) override
+        {
+            return record("]", parser);
+        }
+
+        JsonParseAction onKey(JsonEventParser const& parser, string_view key) override
+        {
+            return record("key:" + string{key}, parser);
+        }
+
+        JsonParseAction onValue(JsonEventParser const& parser, value_type const& value) override
+        {
+            return record("value:" + to_json_string(value), parser);
+        }
+
+        JsonParseAction onSubtree(JsonEventParser const& parser, value_type&& subtree) override
+        {
+            subtrees.push_back(std::move(subtree));
+            return record("subtree", parser);
+        }
+    };
+};
+
+TEST_F(JsonEventParserTest, events_and_paths_test)
+{
+    Recorder recorder;
+    ASSERT_TRUE(JsonEventParser::parse(R"({"a":{"b":[1,{"c":true}]},"d":"x","e":[]})", recorder));
+    vector<string> const expected{"{ ",
+                                  "key:a a",
+                                  "{ a",
+                                  "key:b a/b",
+                                  "[ a/b",
+                                  "value:1 a/b/[0]",
+                                  "{ a/b/[1]",
+                                  "key:c a/b/[1]/c",
+                                  "value:true a/b/[1]/c",
+                                  "} a/b/[1]",
+                                  "] a/b",
+                                  "} a",
+                                  "key:d d",
+                                  "value:\"x\" d",
+                                  "key:e e",
+                                  "[ e",
+                                  "] e",
+                                  "} "};
+    ASSERT_EQ(recorder.events, expected);
+
+    Recorder scalar;
+    ASSERT_TRUE(JsonEventParser::parse("42", scalar));
+    ASSERT_EQ(scalar.events, vector<string>{"value:42 "});
+}
+
+TEST_F(JsonEventParserTest, depth_test)
+{
+    struct DepthRecorder : JsonEventHandler
+    {
+        vector<size_t> depths;
+
+        JsonParseAction onObjectBegin(JsonEventParser const& parser) override
+        {
+            depths.push_back(parser.depth());
+            return JsonParseAction::proceed;
+        }
+
+        JsonParseAction onValue(JsonEventParser const& parser, value_type const& /*value*/) override
+        {
+            depths.push_back(parser.depth());
+            return JsonParseAction::proceed;
+        }
+    } recorder;
+    ASSERT_TRUE(JsonEventParser::parse(R"({"a":[{"b":1}],"c":2})", recorder));
+    ASSERT_EQ(recorder.depths, (vector<size_t>{0, 2, 3, 1}));
+}
+
+TEST_F(JsonEventParserTest, skip_test)
+{
+    Recorder recorder;
+    recorder.decide = [](string const& event, JsonEventParser const& parser) {
+        if (event == "key:a" || (event == "[" && parser.depth() == 1))
+        {
+            return JsonParseAction::skip;
+        }
+        return JsonParseAction::proceed;
+    };
+    ASSERT_TRUE(JsonEventParser::parse(R"({"a":{"b":[1,2]},"c":[3,{"d":4}],"e":5})", recorder));
+    vector<string> const expected{"{ ", "key:a a", "key:c c", "[ c", "key:e e", "value:5 e", "} "};
+    ASSERT_EQ(recorder.events, expected);
+}
+
+TEST_F(JsonEventParserTest, capture_test)
+{
+    Recorder recorder;
+    recorder.decide = [](string const& event, JsonEventParser const& parser) {
+        if (event == "key:big" || event == "key:flag" || (event == "[" && parser.keyPath().toString() == "list/[1]"))
+        {
+            return JsonParseAction::capture;
+        }
+        return JsonParseAction::proceed;
+    };
+    ASSERT_TRUE(JsonEventParser::parse(
+        R"({"big":{"x":[1,2,{"y":null}],"z":"s"},"flag":false,"list":[0,[1.5,-2],3]})", recorder
+    ));
+    ASSERT_EQ(recorder.subtrees.size(), 3UL);
+    ASSERT_EQ(recorder.subtrees[0], from_json_string(R"({"x":[1,2,{"y":null}],"z":"s"})"));
+    ASSERT_EQ(recorder.subtrees[1], value_type{false});
+    ASSERT_EQ(recorder.subtrees[2], from_json_string("[1.5,-2]"));
+    vector<string> const expected{"{ ",
+                                  "key:big big",
+                                  "subtree big",
+                                  "key:flag flag",
+                                  "subtree flag",
+                                  "key:list list",
+                                  "[ list",
+                                  "value:0 list/[0]",
+                                  "[ list/[1]",
+                                  "subtree list/[1]",
+                                  "value:3 list/[2]",
+                                  "] list",
+                                  "} "};
+    ASSERT_EQ(recorder.events, expected);
+}
+
+TEST_F(JsonEventParserTest, stop_test)
+{
+    Recorder recorder;
+    recorder.decide = [](string const& event, JsonEventParser const& /*parser*/) {
+        return event == "value:2" ? JsonParseAction::stop : JsonParseAction::proceed;
+    };
+    JsonEventParser parser(recorder);
+    ASSERT_FALSE(parser.write(R"({"a":[1,2,3],"b":4})") && parser.finish());
+    ASSERT_FALSE(parser.write("garbage"));
+    ASSERT_FALSE(parser.finish());
+    vector<string> const expected{"{ ", "key:a a", "[ a", "value:1 a/[0]", "value:2 a/[1]"};
+    ASSERT_EQ(recorder.events, expected);
+}
+
+TEST_F(JsonEventParserTest, chunked_input_test)
+{
+    string const text = R"({"long key with \"escapes\"":["a string that spans chunks",12345678901,-0.25e3,null],"k":{}})";
+
+    Recorder whole;
+    ASSERT_TRUE(JsonEventParser::parse(text, whole));
+
+    for (size_t chunkSize : {1UL, 3UL, 7UL})
+    {
+        Recorder        chunked;
+        JsonEventParser parser(chunked);
+        for (size_t pos = 0; pos < text.size(); pos += chunkSize)
+        {
+            ASSERT_TRUE(parser.write(string_view{text}.substr(pos, chunkSize)));
+        }
+        ASSERT_TRUE(parser.finish());
+        ASSERT_EQ(chunked.events, whole.events);
+    }
+    ASSERT_EQ(whole.events[1], "key:long key with \"escapes\" long key with \"escapes\"");
+}
+
+TEST_F(JsonEventParserTest, invalid_input_test)
+{
+    Recorder recorder;
+    ASSERT_THROW(JsonEventParser::parse(R"({"a":[1,2})", recorder), std::invalid_argument);
+
+    Recorder        incomplete;
+    JsonEventParser parser(incomplete);
+    parser.write(R"({"a":)");
+    ASSERT_THROW(parser.finish(), std::invalid_argument);
+
+    ASSERT_THROW(JsonEventParser::parseFile("/definitely/not/a/real/file.json", recorder), std::invalid_argument);
+}
+
+TEST_F(JsonEventParserTest, trailing_data_test)
+{
+    Recorder recorder;
+    ASSERT_TRUE(JsonEventParser::parse("{} \n", recorder));
+    ASSERT_THROW(JsonEventParser::parse("{} xyz", recorder), std::invalid_argument);
+    ASSERT_THROW(JsonEventParser::parse("[1] [2]", recorder), std::invalid_argument);
+
+    // the trailing document may arrive in a later chunk
+    Recorder        chunked;
+    JsonEventParser parser(chunked);
+    ASSERT_TRUE(parser.write("[1]"));
+    ASSERT_THROW(
+        {
+            parser.write(" [2]");
+            parser.finish();
+        },
+        std::invalid_argument
+    );
+    ASSERT_THROW(parser.finish(), std::invalid_argument);
+}
+
+TEST_F(JsonEventParserTest, parse_file_test)
+{
+    string const filename = "./JsonEventParserTest_parse_file.json";
+    {
+        ofstream ofs(filename);
+        ofs << R"({"items":[{"id":1},{"id":2},{"id":3}]})";
+    }
+    struct Ids : JsonEventHandler
+    {
+        vector<int64_t> ids;
+
+        JsonParseAction onValue(JsonEventParser const& parser, value_type const& value) override
+        {
+            if (!parser.path().empty() && parser.path().back().key == "id")
+            {
+                ids.push_back(value.as_int64());
+            }
+            return JsonParseAction::proceed;
+        }
+    } handler;
+    ASSERT_TRUE(JsonEventParser::parseFile(filename, handler, {}, 5));
+    ASSERT_EQ(handler.ids, (vector<int64_t>{1, 2, 3}));
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,169 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   test/json_fragment_cache_tests.cc
+ * Description: Unit tests for cached serialization fragments
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_fragment_cache.h"
+#include "json_object.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace std;
+using namespace util;
+
+class JsonFragmentCacheTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // just in case
+    }
+
+    void TearDown() override
+    {
+        // just in case
+    }
+};
+
+TEST_F(JsonFragmentCacheTest, cached_serialization_matches_test)
+{
+    auto const json = R"({"a":{"b":[1,2,{"c":"x\"y"}],"d":true},"e":[[1],[2]],"f":null,"g":1.5})";
+    JsonObject plain{json};
+    JsonObject cached{json};
+    cached.enableFragmentCache();
+
+    auto const check = [&]()
+    {
+        ASSERT_EQ(cached.toString(0), plain.toString(0));
+    };
+    check();
+    check();
+
+    for (auto const* path: {"a/b/[2]/c", "a/d", "e/[1]/[0]", "a/b/[^]", "e/[$]", "new/deep/[$]", "a/b/[7]"})
+    {
+        plain.set(path, value_type{"changed"}, true);
+        cached.set(path, value_type{"changed"}, true);
+        check();
+    }
+
+    // force replaces a container of another kind
+    plain.set("e/x", value_type{1}, true);
+    cached.set("e/x", value_type{1}, true);
+    check();
+    plain.set("e/[0]", value_type{2}, true);
+    cached.set("e/[0]", value_type{2}, true);
+    check();
+
+    // failed sets may still have created containers
+    ASSERT_FALSE(plain.trySet("h/[3]/x", value_type{1}, false).has_value());
+    ASSERT_FALSE(cached.trySet("h/[3]/x", value_type{1}, false).has_value());
+    check();
+    ASSERT_TRUE(cached.trySet("a/d", value_type{false}).has_value());
+    ASSERT_TRUE(plain.trySet("a/d", value_type{false}).has_value());
+    check();
+
+    // direct access invalidates everything
+    cached.get().as_object()["f"] = "direct";
+    plain.get().as_object()["f"] = "direct";
+    check();
+
+    JsonObject copy = cached;
+    copy.set("g", value_type{2});
+    plain.set("g", value_type{2});
+    ASSERT_EQ(copy.toString(0), plain.toString(0));
+
+    cached.enableFragmentCache(false);
+    ASSERT_EQ(cached.toString(0), to_json_string(cached.get()));
+}
+
+TEST_F(JsonFragmentCacheTest, fragment_cache_reuse_test)
+{
+    JsonFragmentCache cache;
+    value_type        doc = from_json_string(R"({"x":{"y":[1,2]},"z":{"w":3}})");
+    ASSERT_EQ(cache.serialize(doc), to_json_string(doc));
+
+    // a change the cache is not told about is not seen: the cached fragment of "z" is reused
+    doc.as_object()["z"].as_object()["w"] = 4;
+    ASSERT_EQ(cache.serialize(doc), R"({"x":{"y":[1,2]},"z":{"w":3}})");
+
+    cache.invalidate(JsonKeyPath{"z/w"});
+    ASSERT_EQ(cache.serialize(doc), to_json_string(doc));
+    cache.invalidateAll();
+    ASSERT_EQ(cache.serialize(doc), to_json_string(doc));
+}
+
+TEST_F(JsonFragmentCacheTest, nested_fragments_are_not_copied_test)
+{
+    // every level holds a payload and the next level, so copying children into parents would cost depth * size
+    value_type doc = from_json_string(R"({"payload":"leaf"})");
+    for (int depth = 0; depth < 200; ++depth)
+    {
+        object_type level;
+        level["payload"] = std::string(20, 'x');
+        level["next"]    = std::move(doc);
+        doc              = std::move(level);
+    }
+    JsonFragmentCache cache;
+    auto const        text = cache.serialize(doc);
+    ASSERT_EQ(text, to_json_string(doc));
+    ASSERT_EQ(cache.cachedBytes(), text.size());
+
+    // change a payload deep down: its ancestors re-render only their own text
+    std::string path = "next";
+    value_type* node = &doc.as_object()["next"];
+    for (int depth = 1; depth < 150; ++depth)
+    {
+        path += "/next";
+        node = &node->as_object()["next"];
+    }
+    node->as_object()["payload"] = "changed";
+    cache.invalidate(JsonKeyPath{path + "/payload"});
+    auto const changed = cache.serialize(doc);
+    ASSERT_EQ(changed, to_json_string(doc));
+    ASSERT_EQ(cache.cachedBytes(), changed.size());
+}
+
+TEST_F(JsonFragmentCacheTest, range_insertion_into_last_element_test)
+{
+    // "[$]" resolves to the last element here, which the insertion changes
+    JsonObject cached{R"({"a":[[1],[2]]})"};
+    cached.enableFragmentCache();
+    ASSERT_EQ(cached.toString(0), R"({"a":[[1],[2]]})");
+
+    cached.appendRange("a/[$]", {value_type{3}});
+    ASSERT_EQ(cached.toString(0), R"({"a":[[1],[2,3]]})");
+    cached.prependRange("a/[$]", {value_type{0}});
+    ASSERT_EQ(cached.toString(0), R"({"a":[[1],[0,2,3]]})");
+}
+
+TEST_F(JsonFragmentCacheTest, transform_last_element_test)
+{
+    JsonObject cached{R"({"a":[[1],[2]]})"};
+    cached.enableFragmentCache();
+    ASSERT_EQ(cached.toString(0), R"({"a":[[1],[2]]})");
+
+    cached.transform("a/[$]", [](value_type& element) { element = 9; });
+    ASSERT_EQ(cached.get("a/[1]/[0]"), value_type{9});
+    ASSERT_EQ(cached.toString(0), R"({"a":[[1],[9]]})");
+}
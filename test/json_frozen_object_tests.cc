@@ -0,0 +1,145 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   test/json_frozen_object_tests.cc
+ * Description: Unit tests for frozen json objects
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_frozen_object.h"
+#include "json_object.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+using namespace std;
+using namespace util;
+
+class JsonFrozenObjectTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // just in case
+    }
+
+    void TearDown() override
+    {
+        // just in case
+    }
+};
+
+TEST_F(JsonFrozenObjectTest, frozen_get_test)
+{
+    auto jsonObj = JsonObject{
+        R"({"name":"cfg","version":3,"ratio":0.5,"big":18446744073709551615,"on":true,"none":null,
+            "list":[1,"two",{"three":3}],"nested":{"a":{"b":{"c":"deep"}}}})"
+    };
+    auto const frozen = jsonObj.freeze();
+
+    ASSERT_EQ(frozen.get("name"), value_type{"cfg"});
+    ASSERT_EQ(frozen.get<int>("version"), 3);
+    ASSERT_EQ(frozen.get<double>("ratio"), 0.5);
+    ASSERT_EQ(frozen.get<uint64_t>("big"), 18446744073709551615ULL);
+    ASSERT_TRUE(frozen.get<bool>("on"));
+    ASSERT_FALSE(frozen.get<std::optional<int>>("none").has_value());
+    ASSERT_EQ(frozen.get<std::string_view>("list/[1]"), "two");
+    ASSERT_EQ(frozen.get<int>("list/[$]/three"), 3);
+    ASSERT_EQ(frozen.get<int>("list/[^]"), 1);
+    ASSERT_EQ(frozen.get<std::string>("nested/a/b/c"), "deep");
+    ASSERT_EQ(frozen.get("nested/a"), jsonObj.get("nested/a"));
+    ASSERT_EQ(frozen.toValue(), jsonObj.get());
+    ASSERT_EQ(frozen.nodeCount(), 16UL);
+    ASSERT_GT(frozen.memoryUsage(), 0UL);
+}
+
+TEST_F(JsonFrozenObjectTest, frozen_defaults_and_errors_test)
+{
+    auto const frozen = JsonObject{R"({"key":"value","arr":[1,2]})"}.freeze();
+
+    ASSERT_EQ(frozen.get("missing", value_type{5}), value_type{5});
+    ASSERT_EQ(frozen.get<int>("arr/[7]", -1), -1);
+    ASSERT_EQ(frozen.get<std::optional<int>>("missing"), std::nullopt);
+
+    ASSERT_THROW(static_cast<void>(frozen.get("missing")), missing_key_error);
+    ASSERT_THROW(static_cast<void>(frozen.get("arr/[2]")), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(frozen.get("key/[0]")), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(frozen.get("arr/key")), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(frozen.get<int>("key")), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(frozen.get<std::string>("arr/[0]")), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(frozen.get<int>("arr/key", 1)), std::invalid_argument);
+}
+
+TEST_F(JsonFrozenObjectTest, frozen_large_object_test)
+{
+    JsonObject jsonObj;
+    for (int i = 0; i < 1000; ++i)
+    {
+        jsonObj.set("table/key" + to_string(i), value_type{i}, true);
+    }
+    auto const frozen = jsonObj.freeze();
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        ASSERT_EQ(frozen.get<int>("table/key" + to_string(i)), i);
+    }
+    ASSERT_FALSE(frozen.get<std::optional<int>>("table/key1000").has_value());
+    ASSERT_FALSE(frozen.get<std::optional<int>>("table/other").has_value());
+    ASSERT_EQ(frozen.toValue(), jsonObj.get());
+}
+
+TEST_F(JsonFrozenObjectTest, frozen_interned_keys_test)
+{
+    auto       table = make_shared<JsonKeyInternTable>();
+    JsonObject obj1{R"({"id":1,"pos":{"x":1.0,"y":2.0}})"};
+    JsonObject obj2{R"({"id":2,"pos":{"x":3.0,"y":4.0}})"};
+
+    auto const frozen1 = obj1.freeze(table);
+    auto const frozen2 = obj2.freeze(table);
+    ASSERT_EQ(table->size(), 4UL);
+    ASSERT_EQ(frozen1.get<double>("pos/y"), 2.0);
+    ASSERT_EQ(frozen2.get<double>(JsonKeyPath{"pos/x", table}), 3.0);
+    ASSERT_EQ(frozen2.get<double>(JsonKeyPath{"pos/x"}), 3.0);
+    ASSERT_EQ(frozen2.get<double>(JsonKeyPath{"pos/x", make_shared<JsonKeyInternTable>()}), 3.0);
+
+    // keys unknown to the table are missing without a search, and lookups do not add them
+    ASSERT_FALSE(frozen1.get<std::optional<int>>("nothing").has_value());
+    ASSERT_THROW(static_cast<void>(frozen1.get("pos/z")), missing_key_error);
+    ASSERT_EQ(table->size(), 4UL);
+    ASSERT_EQ(frozen1.toValue(), obj1.get());
+
+    // large objects use the perfect hash over handles
+    JsonObject wide{};
+    for (int i = 0; i < 40; ++i)
+    {
+        wide.set("k" + std::to_string(i), value_type{i});
+    }
+    auto const frozenWide = wide.freeze(table);
+    for (int i = 0; i < 40; ++i)
+    {
+        ASSERT_EQ(frozenWide.get<int>("k" + std::to_string(i)), i);
+    }
+    ASSERT_FALSE(frozenWide.get<std::optional<int>>("id").has_value());
+    ASSERT_EQ(frozenWide.toValue(), wide.get());
+
+    auto const copy = frozen1;
+    ASSERT_EQ(copy.get<int>("id"), 1);
+}
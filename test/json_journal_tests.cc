@@ -0,0 +1,271 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   test/json_journal_tests.cc
+ * Description: Unit tests for the journal of json object updates
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_journal.h"
+#include "json_object.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace util;
+
+class JsonJournalTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // just in case
+    }
+
+    void TearDown() override
+    {
+        // just in case
+    }
+
+    static string readFile(string const& filename)
+    {
+        ifstream      ifs(filename.c_str());
+        ostringstream content;
+        content << ifs.rdbuf();
+        return content.str();
+    }
+
+    static void removeFiles(string const& filename)
+    {
+        std::remove(filename.c_str());
+        std::remove(JsonJournal::journalFileName(filename).c_str());
+    }
+};
+
+TEST_F(JsonJournalTest, replay_journal_on_load_test)
+{
+    string const filename = "./JsonJournalTest_replay.json";
+    removeFiles(filename);
+    {
+        JsonObject jsonObj{R"({"a":{"b":1},"list":[1,2]})"};
+        jsonObj.enableJournal(filename);
+        ASSERT_EQ(readFile(filename), "{\"a\":{\"b\":1},\"list\":[1,2]}\n");
+
+        jsonObj.set("a/b", value_type{2});
+        jsonObj.set("list/[$]", value_type{3});
+        jsonObj.set("list/[^]", value_type{0});
+        jsonObj.set("new/deep", value_type{"x\ny"}, true);
+        ASSERT_FALSE(jsonObj.trySet("missing/[3]", value_type{1}, false).has_value());
+        jsonObj.flushJournal();
+
+        // the snapshot is untouched, the changes are in the journal
+        ASSERT_EQ(readFile(filename), "{\"a\":{\"b\":1},\"list\":[1,2]}\n");
+        ASSERT_GT(jsonObj.journal()->journalBytes(), 0);
+
+        JsonObject loaded{};
+        loaded.load(filename);
+        ASSERT_EQ(loaded.toString(0), jsonObj.toString(0));
+        ASSERT_EQ(loaded.get("list"), from_json_string("[0,1,2,3]"));
+
+        jsonObj.clear();
+        jsonObj.set("only", value_type{true});
+    }
+
+    // the destructor commits the records that are still buffered
+    JsonObject loaded{};
+    loaded.load(filename);
+    ASSERT_EQ(loaded.toString(0), R"({"only":true})");
+    removeFiles(filename);
+}
+
+TEST_F(JsonJournalTest, compaction_test)
+{
+    string const filename = "./JsonJournalTest_compaction.json";
+    removeFiles(filename);
+    JsonObject jsonObj{};
+    jsonObj.enableJournal(filename, JsonJournalOptions{.compactAfterBytes = 200});
+    for (int i = 0; i < 50; ++i)
+    {
+        jsonObj.set("counter", value_type{i});
+    }
+    jsonObj.set("items/[$]", value_type{"last"}, true);
+    jsonObj.flushJournal();
+
+    // the journal's thread compacts in the background; set() does not wait for it
+    for (int wait = 0; wait < 500 && readFile(filename) == "{}\n"; ++wait)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+    ASSERT_NE(readFile(filename), "{}\n");
+    ASSERT_TRUE(jsonObj.journal()->failure().empty());
+
+    JsonObject loaded{};
+    loaded.load(filename);
+    ASSERT_EQ(loaded.toString(0), jsonObj.toString(0));
+
+    jsonObj.compactJournal();
+    ASSERT_EQ(jsonObj.journal()->journalBytes(), 0);
+    ASSERT_EQ(readFile(filename), jsonObj.toString(0) + "\n");
+
+    // loading into a journaled object continues the journal from the loaded state, without a new snapshot
+    string const other = "./JsonJournalTest_compaction_other.json";
+    JsonObject{R"({"other":1})"}.write(other, 0);
+    auto const snapshot = readFile(filename);
+    jsonObj.load(other);
+    jsonObj.set("other", value_type{2});
+    jsonObj.flushJournal();
+    ASSERT_EQ(readFile(filename), snapshot);
+    loaded.load(filename);
+    ASSERT_EQ(loaded.toString(0), R"({"other":2})");
+    removeFiles(other);
+
+    jsonObj.disableJournal();
+    ASSERT_EQ(jsonObj.journal(), nullptr);
+    removeFiles(filename);
+}
+
+TEST_F(JsonJournalTest, failure_does_not_fail_set_test)
+{
+    string const filename = "./JsonJournalTest_failure.json";
+    removeFiles(filename);
+    JsonObject jsonObj{R"({"a":1})"};
+    jsonObj.enableJournal(filename, JsonJournalOptions{.compactAfterBytes = 100});
+
+    // a directory in place of the temporary snapshot makes the background compaction fail
+    std::filesystem::create_directory(filename + ".tmp");
+    for (int i = 0; i < 10; ++i)
+    {
+        jsonObj.set("a", value_type{i});
+    }
+    for (int wait = 0; wait < 500 && jsonObj.journal()->failure().empty(); ++wait)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{10});
+    }
+    ASSERT_FALSE(jsonObj.journal()->failure().empty());
+    ASSERT_NO_THROW(jsonObj.set("a", value_type{42}));
+    ASSERT_EQ(jsonObj.get("a"), value_type{42});
+    ASSERT_THROW(jsonObj.compactJournal(), std::runtime_error);
+
+    std::filesystem::remove(filename + ".tmp");
+    jsonObj.compactJournal();
+    ASSERT_TRUE(jsonObj.journal()->failure().empty());
+    jsonObj.set("b", value_type{true}, true);
+    jsonObj.flushJournal();
+    JsonObject loaded{};
+    loaded.load(filename);
+    ASSERT_EQ(loaded.toString(0), jsonObj.toString(0));
+    removeFiles(filename);
+}
+
+TEST_F(JsonJournalTest, stale_and_torn_journal_test)
+{
+    string const filename = "./JsonJournalTest_stale.json";
+    removeFiles(filename);
+    {
+        JsonObject jsonObj{R"({"a":1})"};
+        jsonObj.enableJournal(filename, JsonJournalOptions{.waitForSync = true});
+        jsonObj.set("a", value_type{2});
+        // synced before set() returns
+        ASSERT_NE(readFile(JsonJournal::journalFileName(filename)).find(R"("path":"a")"), string::npos);
+    }
+
+    // a record without newline was torn by a crash and is ignored
+    {
+        ofstream ofs(JsonJournal::journalFileName(filename).c_str(), ios::app);
+        ofs << R"({"op":"set","path":"a","force":false,"val)";
+    }
+    JsonObject loaded{};
+    loaded.load(filename);
+    ASSERT_EQ(loaded.get("a"), value_type{2});
+
+    // a corrupt record in the middle is an error
+    {
+        ofstream ofs(JsonJournal::journalFileName(filename).c_str(), ios::app);
+        ofs << "\n" << R"({"op":"set","path":"a","force":false,"value":3})" << "\n";
+    }
+    ASSERT_THROW(loaded.load(filename), std::invalid_argument);
+
+    // a snapshot written without the journal makes the journal stale
+    JsonObject{R"({"a":10})"}.write(filename, 0);
+    loaded.load(filename);
+    ASSERT_EQ(loaded.get("a"), value_type{10});
+    removeFiles(filename);
+}
+
+TEST_F(JsonJournalTest, copies_are_not_journaled_test)
+{
+    string const filename = "./JsonJournalTest_copies.json";
+    removeFiles(filename);
+    JsonObject jsonObj{R"({"a":1})"};
+    jsonObj.enableJournal(filename);
+    JsonObject copy{jsonObj};
+    ASSERT_EQ(copy.journal(), nullptr);
+    copy.set("a", value_type{5});
+    jsonObj.flushJournal();
+
+    JsonObject loaded{};
+    loaded.load(filename);
+    ASSERT_EQ(loaded.get("a"), value_type{1});
+
+    jsonObj = copy;
+    ASSERT_EQ(jsonObj.journal(), nullptr);
+    removeFiles(filename);
+}
+
+TEST_F(JsonJournalTest, range_insertion_replay_test)
+{
+    string const filename = "./JsonJournalTest_ranges.json";
+    removeFiles(filename);
+    JsonObject jsonObj{R"({"lists":[[1],[2]]})"};
+    jsonObj.enableJournal(filename);
+    jsonObj.appendRange("lists/[$]", {value_type{3}, value_type{4}});
+    jsonObj.prependRange("lists/[^]", {value_type{0}});
+    jsonObj.insertRange("created/list", 1, {value_type{"x"}}, true);
+    JsonPrependBatch batch{jsonObj, JsonKeyPath{"lists/[1]"}};
+    batch.push(value_type{"b"});
+    batch.push(value_type{"a"});
+    batch.commit();
+    jsonObj.flushJournal();
+
+    JsonObject loaded{};
+    loaded.load(filename);
+    ASSERT_EQ(loaded.toString(0), jsonObj.toString(0));
+    ASSERT_EQ(loaded.get("lists"), from_json_string(R"([[0,1],["a","b",2,3,4]])"));
+
+    // only the inserted values are journaled, not the array they go into
+    std::vector<value_type> many(1000, value_type{"some longer value"});
+    jsonObj.appendRange("big", std::move(many), true);
+    auto const before = jsonObj.journal()->journalBytes();
+    jsonObj.prependRange("big", {value_type{0}});
+    jsonObj.insertRange("big", 500, {value_type{1}});
+    ASSERT_LT(jsonObj.journal()->journalBytes() - before, 200UL);
+    jsonObj.flushJournal();
+    loaded.load(filename);
+    ASSERT_EQ(loaded.toString(0), jsonObj.toString(0));
+    removeFiles(filename);
+}
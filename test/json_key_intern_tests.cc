@@ -0,0 +1,133 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   test/json_key_intern_tests.cc
+ * Description: Unit tests for interned json keys
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_key_intern.h"
+#include "json_key_path.h"
+#include "json_object.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace util;
+
+class JsonKeyInternTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // just in case
+    }
+
+    void TearDown() override
+    {
+        // just in case
+    }
+};
+
+TEST_F(JsonKeyInternTest, intern_table_test)
+{
+    JsonKeyInternTable table;
+    auto               key1 = table.intern("name");
+    auto               key2 = table.intern(string{"na"} + "me");
+    auto               key3 = table.intern("other");
+
+    ASSERT_TRUE(key1.valid());
+    ASSERT_EQ(key1, key2);
+    ASSERT_NE(key1, key3);
+    ASSERT_EQ(&key1.str(), &key2.str());
+    ASSERT_EQ(key1.view(), "name");
+    ASSERT_EQ(table.size(), 2UL);
+    ASSERT_EQ(table.bytes(), 9UL);
+    ASSERT_EQ(table.find("other"), key3);
+    ASSERT_FALSE(table.find("missing").has_value());
+    ASSERT_FALSE(InternedKey{}.valid());
+}
+
+TEST_F(JsonKeyInternTest, intern_concurrently_test)
+{
+    JsonKeyInternTable  table;
+    vector<InternedKey> seen(8);
+    vector<thread>      threads;
+    for (size_t t = 0; t < seen.size(); ++t)
+    {
+        threads.emplace_back(
+            [&table, &seen, t]
+            {
+                for (int i = 0; i < 1000; ++i)
+                {
+                    table.intern("key" + to_string(i));
+                }
+                seen[t] = table.intern("key500");
+            }
+        );
+    }
+    for (auto& thr : threads)
+    {
+        thr.join();
+    }
+    ASSERT_EQ(table.size(), 1000UL);
+    for (auto const& key : seen)
+    {
+        ASSERT_EQ(key, seen[0]);
+    }
+}
+
+TEST_F(JsonKeyInternTest, interned_key_path_test)
+{
+    auto              table = make_shared<JsonKeyInternTable>();
+    JsonKeyPath const path1{"a/[0]/b", table};
+    JsonKeyPath const path2{"b/a", table};
+
+    ASSERT_EQ(path1.toString(), "a/[0]/b");
+    ASSERT_EQ(table->size(), 2UL);
+    auto const* a1 = dynamic_cast<JsonStringKey const*>(path1.getKeys()[0].get());
+    auto const* a2 = dynamic_cast<JsonStringKey const*>(path2.getKeys()[1].get());
+    ASSERT_EQ(a1->getInterned(), a2->getInterned());
+    ASSERT_EQ(&a1->getKey(), &a2->getKey());
+    ASSERT_EQ(a1->internTable(), table.get());
+    ASSERT_FALSE(JsonStringKey{"a"}.getInterned().valid());
+    ASSERT_EQ(JsonStringKey{"a"}.internTable(), nullptr);
+    ASSERT_EQ(JsonKeyPath("a/b", nullptr).toString(), "a/b");
+
+    ASSERT_THROW(JsonKeyPath("a/123", table), std::invalid_argument);
+    ASSERT_THROW(JsonKeyPath("a/ b", table), std::invalid_argument);
+}
+
+TEST_F(JsonKeyInternTest, key_keeps_table_alive_test)
+{
+    auto              table = make_shared<JsonKeyInternTable>();
+    JsonKeyPath const path{"pos/x", table};
+    weak_ptr const    watch{table};
+    table.reset();
+
+    ASSERT_FALSE(watch.expired());
+    auto const* key = dynamic_cast<JsonStringKey const*>(path.getKeys()[1].get());
+    ASSERT_EQ(key->getKey(), "x");
+    ASSERT_EQ(key->getInterned().view(), "x");
+}
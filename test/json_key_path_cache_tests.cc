@@ -0,0 +1,154 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   test/json_key_path_cache_tests.cc
+ * Description: Unit tests for the cache of parsed key-paths
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_key_path_cache.h"
+#include "json_metrics.h"
+#include "json_object.h"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace util;
+
+class JsonKeyPathCacheTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // just in case
+    }
+
+    void TearDown() override
+    {
+        // just in case
+    }
+};
+
+TEST_F(JsonKeyPathCacheTest, hits_and_misses_test)
+{
+    JsonKeyPathCache cache{16};
+    string const     tenant = "tenant-7";
+    auto const       first  = cache.get(tenant + "/settings/[2]/name");
+    auto const       second = cache.get(string_view{"tenant-7/settings/[2]/name"});
+    ASSERT_EQ(first.get(), second.get());
+    ASSERT_EQ(first->toString(), "tenant-7/settings/[2]/name");
+
+    auto const tried = cache.tryGet("tenant-7/settings/[2]/name");
+    ASSERT_TRUE(tried.has_value());
+    ASSERT_EQ(tried->get(), first.get());
+
+    ASSERT_EQ(cache.tryGet("a/ b").error(), (JsonPathError{json_errc::invalid_key, 1}));
+    ASSERT_THROW(static_cast<void>(cache.get("a/ b")), std::invalid_argument);
+
+    auto const stats = cache.stats();
+    ASSERT_EQ(stats.hits, 2UL);
+    ASSERT_EQ(stats.misses, 3UL);
+    ASSERT_EQ(stats.size, 1UL);
+
+    cache.clear();
+    ASSERT_EQ(cache.stats().size, 0UL);
+    ASSERT_EQ(first->toString(), "tenant-7/settings/[2]/name");
+}
+
+TEST_F(JsonKeyPathCacheTest, least_recently_used_eviction_test)
+{
+    JsonKeyPathCache cache{3, nullptr, 1};
+    ASSERT_EQ(cache.capacity(), 3UL);
+    static_cast<void>(cache.get("a"));
+    static_cast<void>(cache.get("b"));
+    static_cast<void>(cache.get("c"));
+    static_cast<void>(cache.get("a")); // b is now the least recently used
+    static_cast<void>(cache.get("d"));
+    ASSERT_EQ(cache.stats().evictions, 1UL);
+    ASSERT_EQ(cache.stats().size, 3UL);
+
+    auto const hits = cache.stats().hits;
+    static_cast<void>(cache.get("a"));
+    static_cast<void>(cache.get("c"));
+    static_cast<void>(cache.get("d"));
+    ASSERT_EQ(cache.stats().hits, hits + 3);
+    static_cast<void>(cache.get("b"));
+    ASSERT_EQ(cache.stats().hits, hits + 3);
+    ASSERT_EQ(cache.stats().evictions, 2UL);
+}
+
+TEST_F(JsonKeyPathCacheTest, concurrent_lookups_test)
+{
+    JsonKeyPathCache cache{64, nullptr, 4};
+    vector<jthread>  threads;
+    for (size_t t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&cache] {
+            for (size_t i = 0; i < 2000; ++i)
+            {
+                auto const path = "tenant-" + to_string(i % 100) + "/value";
+                EXPECT_EQ(cache.get(path)->toString(), path);
+            }
+        });
+    }
+    threads.clear();
+    auto const stats = cache.stats();
+    ASSERT_EQ(stats.hits + stats.misses, 8000UL);
+    ASSERT_LE(stats.size, cache.capacity());
+}
+
+TEST_F(JsonKeyPathCacheTest, json_object_uses_cache_test)
+{
+    auto jsonObj = JsonObject{R"({"tenant-1":{"limit":5}})"};
+    ASSERT_EQ(jsonObj.keyPathCache(), JsonKeyPathCache::shared());
+
+    auto cache = make_shared<JsonKeyPathCache>(8);
+    jsonObj.useKeyPathCache(cache);
+    for (int i = 0; i < 3; ++i)
+    {
+        ASSERT_EQ(jsonObj.get<int>("tenant-1/limit"), 5);
+        jsonObj.set("tenant-1/limit", value_type{5});
+    }
+    ASSERT_TRUE(jsonObj.trySet(string_view{"tenant-1/other"}, value_type{1}).has_value());
+    ASSERT_EQ(jsonObj.tryGet<int>(string_view{"tenant-1/other"}).value(), 1);
+    ASSERT_EQ(cache->stats().misses, 2UL);
+    ASSERT_EQ(cache->stats().hits, 6UL);
+
+    jsonObj.useKeyPathCache(nullptr);
+    ASSERT_EQ(jsonObj.get<int>("tenant-1/limit"), 5);
+}
+
+TEST_F(JsonKeyPathCacheTest, cache_metrics_test)
+{
+    if (!JsonMetrics::enabled)
+    {
+        GTEST_SKIP() << "built without JSONOBJECT_ENABLE_METRICS";
+    }
+    JsonMetrics::reset();
+    JsonKeyPathCache cache;
+    static_cast<void>(cache.get("metrics/path"));
+    static_cast<void>(cache.get("metrics/path"));
+    auto const snapshot = JsonMetrics::snapshot();
+    ASSERT_EQ(snapshot[JsonCounter::keyPathCacheHits], 1UL);
+    ASSERT_EQ(snapshot[JsonCounter::keyPathCacheMisses], 1UL);
+}
@@ -26,6 +26,7 @@
 
 #include <gtest/gtest.h>
 #include <string>
+#include <string_view>
 
 using namespace std;
 using namespace util;
@@ -130,3 +131,48 @@ TEST_F(JsonKeyPathTest, index_key_get_index_test)
     ASSERT_EQ(last.getIndex(arr), 1);
     ASSERT_EQ(middle.getIndex(arr), 1);
 }
+
+TEST_F(JsonKeyPathTest, build_key_path_test)
+{
+    JsonKeyPath root{};
+    ASSERT_EQ(root.size(), 0UL);
+    ASSERT_EQ(root.toString(), "");
+
+    root.append(std::make_shared<JsonStringKey>("a")).append(std::make_shared<JsonIndexKey>(3UL));
+    ASSERT_EQ(root.size(), 2UL);
+    ASSERT_EQ(root.toString(), "a/[3]");
+}
+
+TEST_F(JsonKeyPathTest, try_parse_test)
+{
+    auto path = JsonKeyPath::tryParse("a/[0]//b/[$]");
+    ASSERT_TRUE(path.has_value());
+    ASSERT_EQ(path->toString(), "a/[0]/b/[$]");
+
+    ASSERT_EQ(JsonKeyPath::tryParse("").error(), JsonPathError{json_errc::empty_path});
+    ASSERT_EQ(JsonKeyPath::tryParse("a/123").error(), (JsonPathError{json_errc::invalid_key, 1}));
+    ASSERT_EQ(JsonKeyPath::tryParse("a/b/[x]").error(), (JsonPathError{json_errc::invalid_key, 2}));
+    ASSERT_EQ(JsonKeyPath::tryParse(" a").error(), (JsonPathError{json_errc::invalid_key, 0}));
+    ASSERT_EQ(JsonKeyPath::tryParse("a/[1^2]").error(), (JsonPathError{json_errc::invalid_key, 1}));
+
+    ASSERT_TRUE(JsonStringKey::isValid("key"));
+    ASSERT_FALSE(JsonStringKey::isValid("42"));
+    ASSERT_TRUE(JsonIndexKey::isValid("[42]"));
+    ASSERT_FALSE(JsonIndexKey::isValid("[99999999999999999999]"));
+}
+
+TEST_F(JsonKeyPathTest, string_view_path_test)
+{
+    // a view into a larger buffer is not NUL-terminated after the path
+    std::string const      buffer = "a/[2]/long_enough_to_not_fit_inline|trailing";
+    std::string_view const view{buffer.data(), buffer.find('|')};
+    JsonKeyPath const      path{view};
+    ASSERT_EQ(path.size(), 3UL);
+    ASSERT_EQ(path.toString(), "a/[2]/long_enough_to_not_fit_inline");
+
+    auto              table = make_shared<JsonKeyInternTable>();
+    JsonKeyPath const interned{view.substr(0, 5), table};
+    ASSERT_EQ(interned.toString(), "a/[2]");
+    ASSERT_EQ(JsonStringKey{view.substr(0, 1)}.getKey(), "a");
+    ASSERT_THROW(JsonKeyPath{view.substr(0, 0)}, std::invalid_argument);
+}
@@ -0,0 +1,102 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   test/json_memory_tests.cc
+ * Description: Unit tests for json memory accounting
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_memory.h"
+#include "json_object.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace std;
+using namespace util;
+
+class JsonMemoryTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // just in case
+    }
+
+    void TearDown() override
+    {
+        // just in case
+    }
+};
+
+TEST_F(JsonMemoryTest, tracking_resource_test)
+{
+    TrackingMemoryResource resource;
+    void*                  block1 = resource.allocate(100, 8);
+    void*                  block2 = resource.allocate(50, 8);
+    resource.deallocate(block1, 100, 8);
+
+    auto usage = resource.usage();
+    ASSERT_EQ(usage.liveBytes, 50UL);
+    ASSERT_EQ(usage.peakBytes, 150UL);
+    ASSERT_EQ(usage.allocations, 2UL);
+    ASSERT_EQ(usage.deallocations, 1UL);
+
+    resource.resetPeak();
+    ASSERT_EQ(resource.usage().peakBytes, 50UL);
+    resource.deallocate(block2, 50, 8);
+    ASSERT_EQ(resource.usage().liveBytes, 0UL);
+    ASSERT_TRUE(resource.is_equal(resource));
+}
+
+TEST_F(JsonMemoryTest, json_object_memory_usage_test)
+{
+    ASSERT_FALSE(JsonObject{}.memoryUsage().has_value());
+
+    auto       storage = boost::json::make_shared_resource<TrackingMemoryResource>();
+    JsonObject jsonObj{R"({"name":"a fairly long string value that needs its own buffer","list":[1,2,3]})", storage};
+    ASSERT_EQ(jsonObj.storage().get(), storage.get());
+
+    auto const afterParse = jsonObj.memoryUsage();
+    ASSERT_TRUE(afterParse.has_value());
+    ASSERT_GT(afterParse->liveBytes, 0UL);
+    ASSERT_GT(afterParse->allocations, 0UL);
+
+    jsonObj.set("more", value_type{"another fairly long string value that needs its own buffer"});
+    ASSERT_GT(jsonObj.memoryUsage()->liveBytes, afterParse->liveBytes);
+
+    jsonObj.clear();
+    ASSERT_EQ(jsonObj.storage().get(), storage.get());
+    ASSERT_LT(jsonObj.memoryUsage()->liveBytes, afterParse->liveBytes);
+    ASSERT_GE(jsonObj.memoryUsage()->peakBytes, afterParse->liveBytes);
+}
+
+TEST_F(JsonMemoryTest, memory_by_top_level_key_test)
+{
+    JsonObject jsonObj{R"({"small":1,"big":["a fairly long string value that needs its own buffer",
+                                             "another fairly long string value that needs its own buffer"]})"};
+    auto const breakdown = jsonObj.memoryByTopLevelKey();
+    ASSERT_EQ(breakdown.size(), 2UL);
+    ASSERT_EQ(breakdown[0].first, "big");
+    ASSERT_EQ(breakdown[1].first, "small");
+    ASSERT_GT(breakdown[0].second, breakdown[1].second);
+
+    ASSERT_TRUE(JsonObject{"[1,2]"}.memoryByTopLevelKey().empty());
+}
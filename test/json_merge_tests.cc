@@ -0,0 +1,179 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   test/json_merge_tests.cc
+ * Description: Unit tests for the deep merge of layers
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_merge.h"
+#include "json_object.h"
+#include "json_thread_pool.h"
+
+#include <chrono>
+#include <future>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace util;
+
+class JsonMergeTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // just in case
+    }
+
+    void TearDown() override
+    {
+        // just in case
+    }
+};
+
+TEST_F(JsonMergeTest, merge_policies_test)
+{
+    vector<JsonObject> const layers{
+        JsonObject{R"({"name":"base","list":[1,{"a":1}],"nested":{"x":1,"y":2}})"},
+        JsonObject{R"({"name":"override","list":[2,{"b":2},3],"nested":{"y":3,"z":4}})"}
+    };
+
+    auto merged = JsonObject::merge(layers);
+    ASSERT_EQ(merged.toString(0), R"({"name":"override","list":[2,{"b":2},3],"nested":{"x":1,"y":3,"z":4}})");
+
+    merged = JsonObject::merge(layers, JsonMergePolicy{.arrays = JsonArrayMergePolicy::concat});
+    ASSERT_EQ(merged.get("list"), from_json_string(R"([1,{"a":1},2,{"b":2},3])"));
+
+    merged = JsonObject::merge(layers, JsonMergePolicy{.arrays = JsonArrayMergePolicy::byIndex});
+    ASSERT_EQ(merged.get("list"), from_json_string(R"([2,{"a":1,"b":2},3])"));
+
+    merged = JsonObject::merge(layers, JsonMergePolicy{.conflicts = JsonConflictPolicy::firstWins});
+    ASSERT_EQ(merged.toString(0), R"({"name":"base","list":[1,{"a":1}],"nested":{"x":1,"y":2,"z":4}})");
+
+    try
+    {
+        merged = JsonObject::merge(
+            layers, JsonMergePolicy{.arrays = JsonArrayMergePolicy::byIndex, .conflicts = JsonConflictPolicy::error}
+        );
+        FAIL() << "conflict not detected";
+    }
+    catch (merge_conflict_error const& error)
+    {
+        ASSERT_STREQ(error.what(), "Conflicting values at key: name");
+    }
+
+    // equal values do not conflict
+    vector<JsonObject> const agreeing{JsonObject{R"({"a":{"b":[1,2]}})"}, JsonObject{R"({"a":{"b":[1,2],"c":1}})"}};
+    merged = JsonObject::merge(agreeing, JsonMergePolicy{.conflicts = JsonConflictPolicy::error});
+    ASSERT_EQ(merged.toString(0), R"({"a":{"b":[1,2],"c":1}})");
+
+    ASSERT_EQ(JsonObject::merge(vector<JsonObject>{}).toString(0), "{}");
+}
+
+TEST_F(JsonMergeTest, merge_non_object_layers_test)
+{
+    vector<value_type> layers{from_json_string("[1,2]"), from_json_string("[3]")};
+    ASSERT_EQ(json_merge(std::move(layers), JsonMergePolicy{.arrays = JsonArrayMergePolicy::concat}),
+              from_json_string("[1,2,3]"));
+
+    value_type const              base    = from_json_string(R"({"a":[{"b":1}]})");
+    value_type const              scalar  = from_json_string(R"({"a":[{"b":"x"}]})");
+    vector<value_type const*> const layerPtrs{&base, &scalar};
+    try
+    {
+        static_cast<void>(json_merge(
+            layerPtrs,
+            JsonMergePolicy{.arrays = JsonArrayMergePolicy::byIndex, .conflicts = JsonConflictPolicy::error}
+        ));
+        FAIL() << "conflict not detected";
+    }
+    catch (merge_conflict_error const& error)
+    {
+        ASSERT_STREQ(error.what(), "Conflicting values at key: a/[0]/b");
+    }
+}
+
+TEST_F(JsonMergeTest, parallel_merge_matches_serial_merge_test)
+{
+    vector<JsonObject> layers;
+    for (int layer = 0; layer < 12; ++layer)
+    {
+        JsonObject jsonObj{};
+        for (int key = layer; key < 40; key += 1 + layer % 3)
+        {
+            auto const prefix = "key" + to_string(key);
+            jsonObj.set(prefix + "/layer", value_type{layer}, true);
+            jsonObj.set(prefix + "/from" + to_string(layer), value_type{key});
+            jsonObj.set(prefix + "/list/[$]", value_type{layer}, true);
+        }
+        layers.push_back(jsonObj);
+    }
+
+    JsonThreadPool pool{4};
+    for (auto arrays : {JsonArrayMergePolicy::replace, JsonArrayMergePolicy::concat, JsonArrayMergePolicy::byIndex})
+    {
+        auto const serial   = JsonObject::merge(layers, JsonMergePolicy{.arrays = arrays, .parallel = false});
+        auto const parallel = JsonObject::merge(layers, JsonMergePolicy{.arrays = arrays, .pool = &pool});
+        ASSERT_EQ(parallel.toString(0), serial.toString(0));
+
+        auto copies = layers;
+        auto moved  = JsonObject::merge(std::move(copies), JsonMergePolicy{.arrays = arrays, .pool = &pool});
+        ASSERT_EQ(moved.toString(0), serial.toString(0));
+    }
+    auto const merged = JsonObject::merge(layers);
+    ASSERT_EQ(merged.get("key38/layer"), value_type{11});
+    ASSERT_EQ(merged.get("key0/from0"), value_type{0});
+}
+
+TEST_F(JsonMergeTest, parallel_merge_on_pool_worker_test)
+{
+    vector<JsonObject> layers;
+    for (int layer = 0; layer < 3; ++layer)
+    {
+        JsonObject jsonObj{};
+        for (int key = 0; key < 20; ++key)
+        {
+            jsonObj.set("key" + to_string(key), value_type{key == 7 ? layer : 0});
+        }
+        layers.push_back(jsonObj);
+    }
+
+    // the only worker runs the merge, so the merge has to do all the work itself
+    JsonThreadPool       pool{1};
+    std::promise<string> result;
+    auto                 future = result.get_future();
+    pool.submit([&] {
+        try
+        {
+            static_cast<void>(
+                JsonObject::merge(layers, JsonMergePolicy{.conflicts = JsonConflictPolicy::error, .pool = &pool})
+            );
+            result.set_value("merged");
+        }
+        catch (merge_conflict_error const& error)
+        {
+            result.set_value(error.what());
+        }
+    });
+    ASSERT_EQ(future.wait_for(std::chrono::seconds{10}), std::future_status::ready);
+    ASSERT_NE(future.get().find("key7"), string::npos);
+}
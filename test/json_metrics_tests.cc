@@ -0,0 +1,130 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   test/json_metrics_tests.cc
+ * Description: Unit tests for json object metrics
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_metrics.h"
+#include "json_object.h"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+using namespace std;
+using namespace util;
+
+class JsonMetricsTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        JsonMetrics::reset();
+    }
+
+    void TearDown() override
+    {
+        // just in case
+    }
+};
+
+TEST_F(JsonMetricsTest, metrics_disabled_test)
+{
+    if (JsonMetrics::enabled)
+    {
+        GTEST_SKIP() << "built with JSONOBJECT_ENABLE_METRICS";
+    }
+    auto jsonObj = JsonObject{R"({"key":"value"})"};
+    ASSERT_EQ(jsonObj.get("key"), value_type{"value"});
+
+    auto const snapshot = JsonMetrics::snapshot();
+    ASSERT_EQ(snapshot[JsonOperation::get].calls, 0UL);
+    ASSERT_EQ(snapshot[JsonCounter::bytesParsed], 0UL);
+}
+
+TEST_F(JsonMetricsTest, metrics_recorded_test)
+{
+    if (!JsonMetrics::enabled)
+    {
+        GTEST_SKIP() << "built without JSONOBJECT_ENABLE_METRICS";
+    }
+    string const json    = R"({"key":"value","n":1})";
+    auto         jsonObj = JsonObject{json};
+    jsonObj.useKeyPathCache(nullptr); // every path string is parsed
+    ASSERT_EQ(jsonObj.get("key"), value_type{"value"});
+    ASSERT_EQ(jsonObj.get<int>("n"), 1);
+    ASSERT_EQ(jsonObj.get("missing", value_type{2}), value_type{2});
+    ASSERT_EQ(jsonObj.get<int>("missing", 3), 3);
+    ASSERT_THROW(static_cast<void>(jsonObj.get("missing")), missing_key_error);
+    jsonObj.set("other", value_type{true});
+    auto const text = jsonObj.toString(0);
+
+    auto const snapshot = JsonMetrics::snapshot();
+    ASSERT_EQ(snapshot[JsonOperation::keyPathParse].calls, 6UL);
+    ASSERT_EQ(snapshot[JsonOperation::get].calls, 5UL);
+    ASSERT_EQ(snapshot[JsonOperation::get].exceptions, 1UL);
+    ASSERT_EQ(snapshot[JsonOperation::find].calls, 5UL);
+    ASSERT_EQ(snapshot[JsonOperation::set].calls, 1UL);
+    ASSERT_EQ(snapshot[JsonOperation::toString].calls, 1UL);
+    ASSERT_EQ(snapshot[JsonCounter::bytesParsed], json.size());
+    ASSERT_EQ(snapshot[JsonCounter::bytesSerialized], text.size());
+    ASSERT_EQ(snapshot[JsonCounter::defaultFallbacks], 2UL);
+
+    uint64_t histogramCalls = 0;
+    for (auto const bucket : snapshot[JsonOperation::get].latencyHistogram)
+    {
+        histogramCalls += bucket;
+    }
+    ASSERT_EQ(histogramCalls, 5UL);
+
+    auto const json2 = snapshot.toJson();
+    ASSERT_EQ(json2.as_object().at("get").as_object().at("calls"), value_type{5UL});
+    ASSERT_EQ(json2.as_object().at("default_fallbacks"), value_type{2UL});
+}
+
+TEST_F(JsonMetricsTest, metrics_aggregate_threads_test)
+{
+    if (!JsonMetrics::enabled)
+    {
+        GTEST_SKIP() << "built without JSONOBJECT_ENABLE_METRICS";
+    }
+    auto const        jsonObj = JsonObject{R"({"key":"value"})"};
+    JsonKeyPath const path{"key"};
+    thread            worker(
+        [&jsonObj, &path]
+        {
+            for (int i = 0; i < 100; ++i)
+            {
+                ASSERT_EQ(jsonObj.get(path), value_type{"value"});
+            }
+        }
+    );
+    worker.join();
+    for (int i = 0; i < 50; ++i)
+    {
+        ASSERT_EQ(jsonObj.get(path), value_type{"value"});
+    }
+
+    ASSERT_EQ(JsonMetrics::snapshot()[JsonOperation::get].calls, 150UL);
+    JsonMetrics::reset();
+    ASSERT_EQ(JsonMetrics::snapshot()[JsonOperation::get].calls, 0UL);
+}
@@ -27,7 +27,17 @@
 #include <cstdio>
 #include <fstream>
 #include <gtest/gtest.h>
+#include <iterator>
+#include <span>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <vector>
+#include <version>
+
+#if defined(__cpp_lib_format)
+#include <format>
+#endif
 
 using namespace std;
 using namespace util;
@@ -307,3 +317,229 @@ TEST_F(JsonObjectTest, pretty_print_exercises_all_local_print_functions_tests)
     // Round-trip check ensures the produced pretty JSON is valid and equivalent.
     ASSERT_EQ(from_json_string(pretty), jsonObj.get());
 }
+
+TEST_F(JsonObjectTest, typed_get_tests)
+{
+    auto jsonObj = JsonObject{R"({
+        "i": -7,
+        "u": 9223372036854775808,
+        "d": 3.25,
+        "whole": 4.0,
+        "b": true,
+        "s": "text",
+        "n": null,
+        "arr": [1, 2, 3]
+    })"};
+
+    ASSERT_EQ(jsonObj.get<int>("i"), -7);
+    ASSERT_EQ(jsonObj.get<int64_t>("i"), -7);
+    ASSERT_EQ(jsonObj.get<uint64_t>("u"), 9'223'372'036'854'775'808ULL);
+    ASSERT_EQ(jsonObj.get<double>("d"), 3.25);
+    ASSERT_EQ(jsonObj.get<double>("i"), -7.0);
+    ASSERT_EQ(jsonObj.get<int>("whole"), 4);
+    ASSERT_TRUE(jsonObj.get<bool>("b"));
+    ASSERT_EQ(jsonObj.get<std::string_view>("s"), "text");
+    ASSERT_EQ(jsonObj.get<std::string>("s"), "text");
+    ASSERT_EQ(jsonObj.get<int>(JsonKeyPath{"arr/[$]"}), 3);
+    ASSERT_EQ(jsonObj.get<value_type>("arr/[0]"), 1);
+
+    ASSERT_EQ(jsonObj.get<std::optional<int>>("i"), -7);
+    ASSERT_EQ(jsonObj.get<std::optional<int>>("n"), std::nullopt);
+    ASSERT_EQ(jsonObj.get<std::optional<int>>("missing"), std::nullopt);
+    ASSERT_EQ(jsonObj.get<std::optional<int>>("arr/[7]"), std::nullopt);
+}
+
+TEST_F(JsonObjectTest, typed_get_default_tests)
+{
+    auto jsonObj = JsonObject{R"({"key":"value","arr":[]})"};
+
+    ASSERT_EQ(jsonObj.get<int>("missing", 42), 42);
+    ASSERT_EQ(jsonObj.get<std::string>("missing", "default"), "default");
+    ASSERT_EQ(jsonObj.get<std::string_view>("key", "default"), "value");
+    ASSERT_EQ(jsonObj.get<int>("arr/[0]", -1), -1);
+
+    // the default does not turn an incompatible path into a valid one
+    ASSERT_THROW(static_cast<void>(jsonObj.get<int>("arr/key", 1)), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(jsonObj.get<std::optional<int>>("key/[0]")), std::invalid_argument);
+
+    // non-template overload is still selected when the type is not given explicitly
+    ASSERT_EQ(jsonObj.get("missing", 5), 5);
+}
+
+TEST_F(JsonObjectTest, typed_get_conversion_failure_tests)
+{
+    auto jsonObj = JsonObject{R"({"big":70000,"neg":-1,"frac":1.5,"s":"text","b":false})"};
+
+    ASSERT_THROW(static_cast<void>(jsonObj.get<int16_t>("big")), std::out_of_range);
+    ASSERT_THROW(static_cast<void>(jsonObj.get<uint32_t>("neg")), std::out_of_range);
+    ASSERT_THROW(static_cast<void>(jsonObj.get<int>("frac")), std::out_of_range);
+    ASSERT_THROW(static_cast<void>(jsonObj.get<int>("s")), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(jsonObj.get<std::string>("b")), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(jsonObj.get<bool>("neg")), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(jsonObj.get<int>("missing")), missing_key_error);
+}
+
+TEST_F(JsonObjectTest, try_get_tests)
+{
+    auto jsonObj = JsonObject{R"({"key":"value","arr":[1,2,3],"obj":{"n":-1}})"};
+
+    ASSERT_EQ(jsonObj.tryGet("key").value(), value_type{"value"});
+    ASSERT_EQ(jsonObj.tryGet<int>("arr/[$]").value(), 3);
+    ASSERT_EQ(jsonObj.tryGet<std::string_view>("key").value(), "value");
+    ASSERT_EQ(jsonObj.tryGet<std::optional<int>>("obj/missing").value(), std::nullopt);
+
+    ASSERT_EQ(jsonObj.tryGet("missing").error(), (JsonPathError{json_errc::missing_key, 0}));
+    ASSERT_EQ(jsonObj.tryGet("obj/n/x").error(), (JsonPathError{json_errc::expected_object, 2}));
+    ASSERT_EQ(jsonObj.tryGet("key/[0]").error(), (JsonPathError{json_errc::expected_array, 1}));
+    ASSERT_EQ(jsonObj.tryGet("arr/[3]").error(), (JsonPathError{json_errc::index_out_of_bounds, 1}));
+    ASSERT_EQ(jsonObj.tryGet<std::optional<int>>("key/x").error().code, json_errc::expected_object);
+    ASSERT_EQ(jsonObj.tryGet<int>("key").error(), JsonPathError{json_errc::type_mismatch});
+    ASSERT_EQ(jsonObj.tryGet<unsigned>("obj/n").error(), JsonPathError{json_errc::out_of_range});
+    ASSERT_EQ(jsonObj.tryGet("").error(), JsonPathError{json_errc::empty_path});
+    ASSERT_EQ(jsonObj.tryGet("obj/123").error(), (JsonPathError{json_errc::invalid_key, 1}));
+
+    // the throwing interface reports the same failures as before
+    ASSERT_THROW(static_cast<void>(jsonObj.get("arr/[3]")), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(jsonObj.get("missing")), missing_key_error);
+    ASSERT_THROW(static_cast<void>(jsonObj.get("key/[0]", value_type{1})), std::invalid_argument);
+}
+
+TEST_F(JsonObjectTest, try_set_tests)
+{
+    auto jsonObj = JsonObject{R"({"key":"value","arr":[1,2,3]})"};
+
+    ASSERT_TRUE(jsonObj.trySet("new/deep", value_type{1}, true).has_value());
+    ASSERT_EQ(jsonObj.get("new/deep"), value_type{1});
+    ASSERT_TRUE(jsonObj.trySet("arr/[$]", value_type{4}).has_value());
+    ASSERT_EQ(jsonObj.get("arr/[3]"), value_type{4});
+
+    ASSERT_EQ(jsonObj.trySet("key/[0]", value_type{1}).error(), (JsonPathError{json_errc::expected_array, 1}));
+    ASSERT_EQ(jsonObj.trySet("arr/x", value_type{1}).error(), (JsonPathError{json_errc::expected_object, 1}));
+    ASSERT_EQ(jsonObj.trySet("other/x", value_type{1}).error(), (JsonPathError{json_errc::missing_key, 0}));
+    ASSERT_EQ(jsonObj.trySet("arr/[9]/x", value_type{1}).error(), (JsonPathError{json_errc::index_out_of_bounds, 1}));
+    ASSERT_EQ(jsonObj.trySet("a/ b", value_type{1}).error(), (JsonPathError{json_errc::invalid_key, 1}));
+
+    ASSERT_THROW(jsonObj.set("key/[0]", value_type{1}), expected_array_error);
+    ASSERT_THROW(jsonObj.set("arr/x", value_type{1}), expected_object_error);
+    ASSERT_THROW(jsonObj.set("other/x", value_type{1}), missing_key_error);
+    ASSERT_THROW(jsonObj.set("arr/[9]/x", value_type{1}), std::invalid_argument);
+}
+
+TEST_F(JsonObjectTest, string_view_api_tests)
+{
+    std::vector<char> const frame{'{', '"', 'a', '"', ':', '[', '1', ',', '2', ']', '}', 'X', 'X'};
+    auto jsonObj = JsonObject{as_json_text(std::span{frame}.first(11))};
+    ASSERT_EQ(jsonObj.toString(0), R"({"a":[1,2]})");
+
+    std::string const paths = "a/[1] a/[0]";
+    std::string_view  view{paths};
+    ASSERT_EQ(jsonObj.get<int>(view.substr(0, 5)), 2);
+    jsonObj.set(view.substr(6), value_type{3});
+    ASSERT_EQ(jsonObj.get(view.substr(6)), value_type{3});
+    ASSERT_EQ(jsonObj.get<int>(std::string{view.substr(6, 2)} + "[1]"), 2);
+    ASSERT_EQ(json_parse(std::string_view{"[1],[2]"}.substr(0, 3)).as_array().size(), 1UL);
+}
+
+TEST_F(JsonObjectTest, range_insertion_tests)
+{
+    auto jsonObj = JsonObject{R"({"arr":[3,4],"nested":[{"list":[]}],"key":"value"})"};
+
+    jsonObj.appendRange("arr", {value_type{5}, value_type{6}});
+    jsonObj.prependRange("arr", {value_type{1}, value_type{2}});
+    jsonObj.insertRange("arr", 3, {value_type{"x"}});
+    ASSERT_EQ(jsonObj.get("arr"), from_json_string(R"([1,2,3,"x",4,5,6])"));
+
+    jsonObj.appendRange("nested/[$]/list", {value_type{true}});
+    jsonObj.prependRange("nested/[^]/list", {value_type{false}});
+    ASSERT_EQ(jsonObj.get("nested/[0]/list"), from_json_string("[false,true]"));
+
+    jsonObj.reserve("arr", 100);
+    ASSERT_GE(jsonObj.get().as_object()["arr"].as_array().capacity(), 100UL);
+
+    jsonObj.insertRange("new/list", 2, {value_type{1}}, true);
+    ASSERT_EQ(jsonObj.get("new/list"), from_json_string("[null,null,1]"));
+    jsonObj.appendRange("key", {value_type{1}}, true);
+    ASSERT_EQ(jsonObj.get("key"), from_json_string("[1]"));
+
+    ASSERT_THROW(jsonObj.appendRange("missing", {value_type{1}}), missing_key_error);
+    ASSERT_THROW(jsonObj.appendRange("nested/[0]", {value_type{1}}), expected_array_error);
+    ASSERT_THROW(jsonObj.insertRange("arr", 100, {value_type{1}}), std::invalid_argument);
+    ASSERT_THROW(jsonObj.reserve("nested/[7]", 1), std::invalid_argument);
+    ASSERT_EQ(jsonObj.get("arr"), from_json_string(R"([1,2,3,"x",4,5,6])"));
+}
+
+TEST_F(JsonObjectTest, prepend_batch_tests)
+{
+    auto jsonObj = JsonObject{R"({"queue":[0]})"};
+    auto expected = JsonObject{R"({"queue":[0]})"};
+
+    JsonPrependBatch batch{jsonObj, JsonKeyPath{"queue"}};
+    for (int64_t i = 1; i <= 1000; ++i)
+    {
+        batch.push(value_type{i});
+        expected.set("queue/[^]", value_type{i});
+    }
+    ASSERT_EQ(batch.size(), 1000UL);
+    ASSERT_EQ(jsonObj.get<int64_t>("queue/[^]"), 0);
+    batch.commit();
+    ASSERT_EQ(batch.size(), 0UL);
+    ASSERT_EQ(jsonObj.get("queue"), expected.get("queue"));
+    ASSERT_EQ(jsonObj.get<int64_t>("queue/[^]"), 1000);
+
+    JsonPrependBatch created{jsonObj, JsonKeyPath{"other/queue"}, true};
+    created.push(value_type{"b"});
+    created.push(value_type{"a"});
+    created.commit();
+    ASSERT_EQ(jsonObj.get("other/queue"), from_json_string(R"(["a","b"])"));
+}
+
+TEST_F(JsonObjectTest, serialize_to_buffer_tests)
+{
+    JsonObject jsonObj{R"({"text":"a \"quoted\"\nline","k\\ey":[0.1,1e20,123456789.0,-0.5,3,-4,true,null],)"
+                       R"("empty":{},"none":[]})"};
+    for (int i = 0; i < 1000; ++i)
+    {
+        jsonObj.set("bulk/[$]", value_type{"element " + std::to_string(i)}, true);
+    }
+
+    for (size_t indent : {0UL, 2UL, 4UL, 100UL})
+    {
+        auto const expected = jsonObj.toString(indent);
+        ASSERT_GT(expected.size(), 8192UL);
+        ASSERT_EQ(jsonObj.serializedSize(indent), expected.size());
+
+        std::vector<char> buffer(expected.size());
+        ASSERT_EQ(jsonObj.serializeTo(std::span{buffer}, indent), expected.size());
+        ASSERT_EQ(std::string_view(buffer.data(), buffer.size()), expected);
+
+        std::vector<char> small(expected.size() - 1);
+        ASSERT_THROW(static_cast<void>(jsonObj.serializeTo(std::span{small}, indent)), std::length_error);
+
+        std::string appended{"prefix:"};
+        jsonObj.serializeTo(std::back_inserter(appended), indent);
+        ASSERT_EQ(appended, "prefix:" + expected);
+    }
+
+    // doubles in indented text are printed as an std::ostream prints them
+    std::ostringstream doubles;
+    doubles << 0.1 << ",\n  " << 1e20 << ",\n  " << 123456789.0 << ",\n  " << -0.5;
+    auto const pretty = jsonObj.toString(1);
+    ASSERT_NE(pretty.find(doubles.str()), std::string::npos);
+    ASSERT_NE(pretty.find(R"("k\\ey" : [)"), std::string::npos);
+    ASSERT_NE(pretty.find(R"("text" : "a \"quoted\"\nline")"), std::string::npos);
+}
+
+#if defined(__cpp_lib_format)
+TEST_F(JsonObjectTest, format_tests)
+{
+    JsonObject const jsonObj{R"({"a":[1,2],"b":"x"})"};
+    ASSERT_EQ(std::format("{}", jsonObj), jsonObj.toString());
+    ASSERT_EQ(std::format("{:0}", jsonObj), R"({"a":[1,2],"b":"x"})");
+    ASSERT_EQ(std::format("<{:2}>", jsonObj), "<" + jsonObj.toString(2) + ">");
+
+    std::string out;
+    std::format_to(std::back_inserter(out), "{:0}|{:0}", jsonObj, jsonObj);
+    ASSERT_EQ(out, R"({"a":[1,2],"b":"x"}|{"a":[1,2],"b":"x"})");
+    ASSERT_THROW(static_cast<void>(std::vformat("{:x}", std::make_format_args(jsonObj))), std::format_error);
+}
+#endif
@@ -0,0 +1,329 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   test/json_parallel_tests.cc
+ * Description: Unit tests for the parallel array operations of json objects
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_journal.h"
+#include "json_memory.h"
+#include "json_object.h"
+#include "json_parallel.h"
+#include "json_thread_pool.h"
+
+#include <atomic>
+#include <cstdio>
+#include <future>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace util;
+
+class JsonParallelTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // just in case
+    }
+
+    void TearDown() override
+    {
+        // just in case
+    }
+
+    static JsonObject makeNumbers(int64_t count)
+    {
+        JsonObject jsonObj{};
+        vector<value_type> values;
+        for (int64_t i = 0; i < count; ++i)
+        {
+            values.emplace_back(i);
+        }
+        jsonObj.appendRange("numbers", std::move(values), true);
+        return jsonObj;
+    }
+
+    static JsonParallelOptions smallChunks(JsonThreadPool& pool)
+    {
+        return JsonParallelOptions{.pool = &pool, .chunkSize = 16, .minParallelSize = 0};
+    }
+};
+
+TEST_F(JsonParallelTest, parallel_for_test)
+{
+    JsonThreadPool       pool{4};
+    vector<atomic<int>>  visits(1000);
+    atomic<size_t>       chunks{0};
+    json_parallel_for(
+        visits.size(),
+        [&](size_t begin, size_t end) {
+            ++chunks;
+            for (size_t i = begin; i < end; ++i)
+            {
+                ++visits[i];
+            }
+        },
+        smallChunks(pool)
+    );
+    for (auto const& visit : visits)
+    {
+        ASSERT_EQ(visit.load(), 1);
+    }
+    ASSERT_EQ(chunks.load(), 63UL);
+
+    size_t calls = 0;
+    json_parallel_for(0, [&](size_t, size_t) { ++calls; }, smallChunks(pool));
+    ASSERT_EQ(calls, 0UL);
+
+    // below minParallelSize everything runs as one chunk on the calling thread
+    json_parallel_for(100, [&](size_t begin, size_t end) { calls += end - begin; }, JsonParallelOptions{.pool = &pool});
+    ASSERT_EQ(calls, 100UL);
+}
+
+TEST_F(JsonParallelTest, exception_test)
+{
+    JsonThreadPool pool{4};
+    ASSERT_THROW(
+        json_parallel_for(
+            1000,
+            [](size_t begin, size_t) {
+                if (begin == 512)
+                {
+                    throw std::runtime_error("chunk failed");
+                }
+            },
+            smallChunks(pool)
+        ),
+        std::runtime_error
+    );
+
+    auto jsonObj = makeNumbers(1000);
+    ASSERT_THROW(
+        jsonObj.forEach(
+            "numbers",
+            [](value_type const& element) {
+                if (element.as_int64() == 700)
+                {
+                    throw std::out_of_range("700");
+                }
+            },
+            smallChunks(pool)
+        ),
+        std::out_of_range
+    );
+}
+
+TEST_F(JsonParallelTest, nested_in_pool_test)
+{
+    // the only worker of the pool runs the outer call, so the inner chunks must not wait for it
+    JsonThreadPool pool{1};
+    auto           jsonObj = makeNumbers(1000);
+    promise<int64_t> result;
+    pool.submit([&] {
+        try
+        {
+            result.set_value(jsonObj.reduce(
+                "numbers",
+                int64_t{0},
+                [](int64_t sum, value_type const& element) { return sum + element.as_int64(); },
+                std::plus<>{},
+                smallChunks(pool)
+            ));
+        }
+        catch (...)
+        {
+            result.set_exception(std::current_exception());
+        }
+    });
+    ASSERT_EQ(result.get_future().get(), 499500);
+}
+
+TEST_F(JsonParallelTest, for_each_test)
+{
+    JsonThreadPool pool{4};
+    auto           jsonObj = makeNumbers(5000);
+    atomic<int64_t> sum{0};
+    jsonObj.forEach("numbers", [&sum](value_type const& element) { sum += element.as_int64(); }, smallChunks(pool));
+    ASSERT_EQ(sum.load(), 12497500);
+
+    atomic<size_t> matching{0};
+    jsonObj.forEach(
+        JsonKeyPath{"numbers"},
+        [&matching](value_type const& element, size_t index) {
+            if (element.as_int64() == static_cast<int64_t>(index))
+            {
+                ++matching;
+            }
+        },
+        smallChunks(pool)
+    );
+    ASSERT_EQ(matching.load(), 5000UL);
+
+    // the shared pool with the default chunking
+    sum = 0;
+    jsonObj.forEach("numbers", [&sum](value_type const& element) { sum += element.as_int64(); });
+    ASSERT_EQ(sum.load(), 12497500);
+
+    jsonObj.set("text", value_type{"x"});
+    ASSERT_THROW(jsonObj.forEach("text", [](value_type const&) {}), expected_array_error);
+    ASSERT_THROW(jsonObj.forEach("missing", [](value_type const&) {}), missing_key_error);
+}
+
+TEST_F(JsonParallelTest, reduce_test)
+{
+    JsonThreadPool pool{4};
+    auto           jsonObj = makeNumbers(3000);
+    auto const     sum     = jsonObj.reduce(
+        "numbers",
+        int64_t{0},
+        [](int64_t acc, value_type const& element) { return acc + element.as_int64(); },
+        std::plus<>{},
+        smallChunks(pool)
+    );
+    ASSERT_EQ(sum, 4498500);
+
+    // string concatenation is associative but not commutative: the chunks must be joined in order
+    auto const digits = jsonObj.reduce(
+        JsonKeyPath{"numbers"},
+        string{},
+        [](string acc, value_type const& element) { return acc + to_string(element.as_int64() % 10); },
+        std::plus<>{},
+        smallChunks(pool)
+    );
+    ASSERT_EQ(digits.size(), 3000UL);
+    for (size_t i = 0; i < digits.size(); ++i)
+    {
+        ASSERT_EQ(digits[i], static_cast<char>('0' + i % 10));
+    }
+
+    jsonObj.set("empty", value_type{array_type{}});
+    ASSERT_EQ(jsonObj.reduce("empty", 0, [](int acc, value_type const&) { return acc + 1; }), 0);
+    ASSERT_EQ(jsonObj.reduce("numbers", 0, [](int acc, value_type const&) { return acc + 1; }), 3000);
+}
+
+TEST_F(JsonParallelTest, transform_test)
+{
+    JsonThreadPool pool{4};
+    auto           jsonObj = makeNumbers(2000);
+
+    // in place
+    jsonObj.transform("numbers", [](value_type& element) { element = element.as_int64() * 2; }, smallChunks(pool));
+    ASSERT_EQ(jsonObj.get<int64_t>("numbers/[1999]"), 3998);
+
+    // by returning the replacement
+    jsonObj.transform(
+        JsonKeyPath{"numbers"},
+        [](value_type const& element) {
+            object_type wrapped;
+            wrapped["id"] = element.as_int64() / 2;
+            return value_type{std::move(wrapped)};
+        },
+        smallChunks(pool)
+    );
+    ASSERT_EQ(jsonObj.get<int64_t>("numbers/[1234]/id"), 1234);
+
+    jsonObj.set("text", value_type{"x"});
+    ASSERT_THROW(jsonObj.transform("text", [](value_type&) {}), expected_array_error);
+    ASSERT_THROW(jsonObj.transform("missing", [](value_type&) {}), missing_key_error);
+}
+
+TEST_F(JsonParallelTest, transform_tracking_storage_test)
+{
+    // a non-default storage is not assumed to be thread-safe: all elements are changed on the calling thread
+    JsonThreadPool pool{4};
+    JsonObject     jsonObj{R"({"list":[1,2,3,4,5,6,7,8,9,10]})", boost::json::make_shared_resource<TrackingMemoryResource>()};
+    auto const     caller = this_thread::get_id();
+    atomic<bool>   elsewhere{false};
+    jsonObj.transform(
+        "list",
+        [&](value_type& element) {
+            elsewhere = elsewhere || this_thread::get_id() != caller;
+            element   = value_type{to_string(element.as_int64())};
+        },
+        JsonParallelOptions{.pool = &pool, .chunkSize = 1, .minParallelSize = 0}
+    );
+    ASSERT_FALSE(elsewhere.load());
+    ASSERT_EQ(jsonObj.get<string>("list/[9]"), "10");
+    ASSERT_GT(jsonObj.memoryUsage()->liveBytes, 0UL);
+}
+
+TEST_F(JsonParallelTest, transform_keeps_indexes_test)
+{
+    JsonThreadPool pool{4};
+    JsonObject     jsonObj{};
+    for (int i = 0; i < 1000; ++i)
+    {
+        jsonObj.set("users/[$]/id", value_type{i}, true);
+    }
+    ASSERT_TRUE(jsonObj.createIndex("users", "id"));
+    ASSERT_EQ(jsonObj.get<int>("users/[id=500]/id"), 500);
+
+    jsonObj.transform(
+        "users",
+        [](value_type& user) { user.as_object()["id"] = user.as_object()["id"].as_int64() + 10000; },
+        smallChunks(pool)
+    );
+    ASSERT_EQ(jsonObj.get<int>("users/[id=10500]/id"), 10500);
+    ASSERT_THROW(static_cast<void>(jsonObj.get("users/[id=500]")), missing_key_error);
+
+    // elements changed before a failure are still seen by the index
+    ASSERT_THROW(
+        jsonObj.transform(
+            "users",
+            [](value_type& user) {
+                auto& id = user.as_object()["id"];
+                if (id.as_int64() == 10100)
+                {
+                    throw std::runtime_error("stop");
+                }
+                id = id.as_int64() + 10000;
+            }
+        ),
+        std::runtime_error
+    );
+    ASSERT_EQ(jsonObj.get<int>("users/[id=20050]/id"), 20050);
+    ASSERT_EQ(jsonObj.get<int>("users/[id=10100]/id"), 10100);
+}
+
+TEST_F(JsonParallelTest, transform_journal_test)
+{
+    string const filename = "./JsonParallelTest_journal.json";
+    std::remove(filename.c_str());
+    std::remove(JsonJournal::journalFileName(filename).c_str());
+    {
+        JsonThreadPool pool{4};
+        auto           jsonObj = makeNumbers(1000);
+        jsonObj.enableJournal(filename);
+        jsonObj.transform("numbers", [](value_type& element) { element = element.as_int64() + 1; }, smallChunks(pool));
+        jsonObj.flushJournal();
+
+        JsonObject loaded{};
+        loaded.load(filename);
+        ASSERT_EQ(loaded.toString(0), jsonObj.toString(0));
+        ASSERT_EQ(loaded.get<int>("numbers/[999]"), 1000);
+    }
+    std::remove(filename.c_str());
+    std::remove(JsonJournal::journalFileName(filename).c_str());
+}
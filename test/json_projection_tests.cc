@@ -0,0 +1,155 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   test/json_projection_tests.cc
+ * Description: Unit tests for parsing selected paths only
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_object.h"
+#include "json_projection.h"
+
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace util;
+
+class JsonProjectionTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // just in case
+    }
+
+    void TearDown() override
+    {
+        // just in case
+    }
+
+    static vector<JsonKeyPath> makePaths(vector<string> const& paths)
+    {
+        vector<JsonKeyPath> result;
+        for (auto const& path : paths)
+        {
+            result.emplace_back(path);
+        }
+        return result;
+    }
+
+    static string const& telemetry()
+    {
+        static string const text = R"({
+            "device": {"id": "dev-17", "firmware": {"version": "2.4.1", "build": 991}},
+            "noise": {"blob": "a \"quoted\" ] } [ { string", "nested": [[1, [2, [3]]], {"x": {"y": [true, null]}}]},
+            "readings": [
+                {"t": 1, "temp": 20.5, "tags": ["a", "b"]},
+                {"t": 2, "temp": 21.0, "tags": []},
+                {"t": 3, "temp": -4e-1, "tags": ["c"]}
+            ],
+            "we\"ird": 7,
+            "status": "ok"
+        })";
+        return text;
+    }
+};
+
+TEST_F(JsonProjectionTest, projection_matches_full_parse_test)
+{
+    auto const paths = makePaths({"device/id",
+                                  "device/firmware/version",
+                                  "readings/[1]/temp",
+                                  "readings/[$]/tags",
+                                  "readings/[^]/t",
+                                  "status",
+                                  "missing/key",
+                                  "status/not_an_object"});
+    auto const projected = JsonObject::parseProjected(telemetry(), paths);
+    JsonObject const full{telemetry()};
+
+    ASSERT_EQ(projected.get<string>("device/id"), full.get<string>("device/id"));
+    ASSERT_EQ(projected.get<string>("device/firmware/version"), "2.4.1");
+    ASSERT_EQ(projected.get<double>("readings/[1]/temp"), full.get<double>("readings/[1]/temp"));
+    ASSERT_EQ(projected.get<int64_t>("readings/[0]/t"), 1);
+    ASSERT_EQ(projected.get("readings/[2]/tags"), full.get("readings/[2]/tags"));
+    ASSERT_EQ(projected.get<string>("status"), "ok");
+
+    auto const expected = from_json_string(
+        R"({"device":{"id":"dev-17","firmware":{"version":"2.4.1"}},)"
+        R"("readings":[{"t":1},{"temp":21.0},{"tags":["c"]}],"status":"ok"})"
+    );
+    ASSERT_EQ(from_json_string(projected.toString(0)), expected);
+}
+
+TEST_F(JsonProjectionTest, prefix_and_overlap_test)
+{
+    auto const paths     = makePaths({"device/firmware/build", "device", "readings/[2]/t", "readings/[$]/temp"});
+    auto const projected = JsonProjection{paths}.parse(telemetry());
+
+    ASSERT_EQ(projected.as_object().at("device"), JsonObject{telemetry()}.get("device"));
+    auto const& readings = projected.as_object().at("readings").as_array();
+    ASSERT_EQ(readings.size(), 3UL);
+    ASSERT_TRUE(readings[0].is_null());
+    ASSERT_TRUE(readings[1].is_null());
+    ASSERT_EQ(readings[2], from_json_string(R"({"t":3,"temp":-0.4})"));
+}
+
+TEST_F(JsonProjectionTest, escaped_keys_and_edge_cases_test)
+{
+    vector<JsonKeyPath> paths;
+    paths.push_back(JsonKeyPath{}.append(make_shared<JsonStringKey>("we\"ird")));
+    ASSERT_EQ(JsonProjection{paths}.parse(telemetry()), from_json_string(R"({"we\"ird":7})"));
+
+    ASSERT_EQ(JsonProjection{vector<JsonKeyPath>{}}.parse(telemetry()), from_json_string("{}"));
+    ASSERT_EQ(JsonProjection{vector<JsonKeyPath>{JsonKeyPath{}}}.parse(telemetry()), from_json_string(telemetry()));
+    ASSERT_EQ(JsonProjection{makePaths({"[$]"})}.parse("[1,[2,3],4]"), from_json_string("[null,null,4]"));
+    ASSERT_EQ(JsonProjection{makePaths({"[1]/[0]"})}.parse("[1,[2,3],4]"), from_json_string("[null,[2]]"));
+    ASSERT_EQ(JsonProjection{makePaths({"a"})}.parse(R"({"a":[]})"), from_json_string(R"({"a":[]})"));
+    ASSERT_EQ(JsonProjection{makePaths({"a/[0]"})}.parse(R"({"a":[]})"), from_json_string("{}"));
+}
+
+TEST_F(JsonProjectionTest, invalid_input_test)
+{
+    auto const paths = makePaths({"a/b"});
+    ASSERT_THROW(static_cast<void>(JsonProjection{paths}.parse(R"({"a":{"b":tru}})")), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(JsonProjection{paths}.parse(R"({"x":[1,2)")), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(JsonProjection{paths}.parse(R"({"x":"open)")), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(JsonProjection{paths}.parse(R"({"a":{"b":1}} extra)")), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(JsonProjection{paths}.parse("")), std::invalid_argument);
+    ASSERT_THROW(
+        static_cast<void>(JsonObject::loadProjected("/definitely/not/a/real/file.json", paths)), std::invalid_argument
+    );
+}
+
+TEST_F(JsonProjectionTest, load_projected_file_test)
+{
+    string const filename = "./JsonProjectionTest_load.json";
+    {
+        ofstream ofs(filename);
+        ofs << telemetry();
+    }
+    auto const projected = JsonObject::loadProjected(filename, makePaths({"readings/[1]/t", "device/id"}));
+    ASSERT_EQ(from_json_string(projected.toString(0)), from_json_string(R"({"device":{"id":"dev-17"},"readings":[null,{"t":2}]})"));
+    std::remove(filename.c_str());
+}
@@ -0,0 +1,183 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   test/json_schema_tests.cc
+ * Description: Unit tests for the json schema validator
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+#include "json_schema.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace std;
+using namespace util;
+
+class JsonSchemaTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // just in case
+    }
+
+    void TearDown() override
+    {
+        // just in case
+    }
+};
+
+namespace
+{
+JsonSchema const &userSchema()
+{
+    static JsonSchema const schema{R"({
+        "type": "object",
+        "required": ["id", "name"],
+        "additionalProperties": false,
+        "properties": {
+            "id": {"type": "integer", "minimum": 1},
+            "name": {"type": "string", "minLength": 2, "maxLength": 8, "pattern": "^[A-Z]"},
+            "role": {"enum": ["admin", "user"]},
+            "score": {"type": "number", "exclusiveMaximum": 100, "multipleOf": 0.5},
+            "tags": {"type": "array", "items": {"type": "string"}, "uniqueItems": true, "maxItems": 3},
+            "manager": {"$ref": "#"}
+        }
+    })"};
+    return schema;
+}
+} // namespace
+
+TEST_F(JsonSchemaTest, valid_documents_test)
+{
+    ASSERT_TRUE(userSchema().isValid(from_json_string(R"({"id":1,"name":"Ada"})")));
+    ASSERT_TRUE(userSchema().isValid(
+        from_json_string(R"({"id":2,"name":"Bob","role":"admin","score":99.5,"tags":["a","b"],"manager":{"id":1,"name":"Ada"}})")
+    ));
+    ASSERT_TRUE(userSchema().validate(from_json_string(R"({"id":3.0,"name":"Eve"})")).empty());
+}
+
+TEST_F(JsonSchemaTest, violations_report_paths_test)
+{
+    auto const violations = userSchema().validate(from_json_string(R"({
+        "id": 0,
+        "role": "guest",
+        "tags": ["a", 7, "a"],
+        "manager": {"id": 1, "name": "x"},
+        "extra": true
+    })"));
+
+    std::vector<std::string> locations;
+    for (auto const &violation: violations)
+    {
+        locations.push_back(violation.path.toString());
+    }
+    ASSERT_NE(std::ranges::find(locations, "id"), locations.end());
+    ASSERT_NE(std::ranges::find(locations, "role"), locations.end());
+    ASSERT_NE(std::ranges::find(locations, "tags"), locations.end());      // not unique
+    ASSERT_NE(std::ranges::find(locations, "tags/[1]"), locations.end());  // not a string
+    ASSERT_NE(std::ranges::find(locations, "manager/name"), locations.end());
+    ASSERT_NE(std::ranges::find(locations, "extra"), locations.end());
+    ASSERT_NE(std::ranges::find(locations, ""), locations.end()); // required "name" is missing at the root
+
+    ASSERT_FALSE(userSchema().isValid(from_json_string(R"({"id":1})")));
+}
+
+TEST_F(JsonSchemaTest, combinators_test)
+{
+    JsonSchema const schema{R"({
+        "$defs": {"positive": {"type": "integer", "exclusiveMinimum": 0}},
+        "type": "array",
+        "prefixItems": [{"type": "string"}],
+        "items": {
+            "oneOf": [{"$ref": "#/$defs/positive"}, {"type": "null"}]
+        },
+        "minItems": 1,
+        "not": {"maxItems": 1}
+    })"};
+
+    ASSERT_TRUE(schema.isValid(from_json_string(R"(["head", 1, null, 5])")));
+    ASSERT_FALSE(schema.isValid(from_json_string(R"(["head"])")));       // matches "not"
+    ASSERT_FALSE(schema.isValid(from_json_string(R"([1, 2])")));         // prefix item is not a string
+    ASSERT_FALSE(schema.isValid(from_json_string(R"(["head", -1])")));   // no alternative matches
+    ASSERT_FALSE(schema.isValid(from_json_string(R"(["head", 1.5])")));
+
+    JsonSchema const anyOf{R"({"anyOf": [{"type": "string"}, {"type": "boolean"}]})"};
+    ASSERT_TRUE(anyOf.isValid(from_json_string("true")));
+    ASSERT_FALSE(anyOf.isValid(from_json_string("1")));
+    ASSERT_EQ(anyOf.validate(from_json_string("1")).size(), 1UL);
+
+    JsonSchema const never{"false"};
+    ASSERT_FALSE(never.isValid(from_json_string("{}")));
+    JsonSchema const always{"true"};
+    ASSERT_TRUE(always.isValid(from_json_string("{}")));
+}
+
+TEST_F(JsonSchemaTest, numbers_compare_by_value_test)
+{
+    JsonSchema const oneOf{R"({"enum": [1, "one", [2, {"k": 3}]]})"};
+    ASSERT_TRUE(oneOf.isValid(from_json_string("1.0")));
+    ASSERT_TRUE(oneOf.isValid(from_json_string(R"([2.0, {"k": 3.0}])")));
+    ASSERT_FALSE(oneOf.isValid(from_json_string("1.5")));
+    ASSERT_FALSE(oneOf.isValid(from_json_string("true")));
+
+    JsonSchema const constant{R"({"const": 18446744073709551615})"};
+    ASSERT_TRUE(constant.isValid(value_type{uint64_t{18446744073709551615UL}}));
+    ASSERT_FALSE(constant.isValid(value_type{int64_t{-1}}));
+
+    JsonSchema const unique{R"({"uniqueItems": true})"};
+    ASSERT_FALSE(unique.isValid(from_json_string("[1, 1.0]")));
+
+    JsonSchema const multiple{R"({"multipleOf": 0.5})"};
+    auto const       violations = multiple.validate(from_json_string("0.75"));
+    ASSERT_EQ(violations.size(), 1UL);
+    ASSERT_NE(violations[0].message.find("0.5"), std::string::npos);
+}
+
+TEST_F(JsonSchemaTest, many_required_properties_test)
+{
+    std::string schemaStr = R"({"type":"object","required":[)";
+    std::string document  = "{";
+    for (int i = 0; i < 70; ++i)
+    {
+        schemaStr += (i > 0 ? "," : "") + std::string{"\"k"} + std::to_string(i) + "\"";
+        if (i != 65)
+        {
+            document += (document.size() > 1 ? "," : "") + std::string{"\"k"} + std::to_string(i) + "\":" + "1";
+        }
+    }
+    schemaStr += "]}";
+    document += "}";
+
+    JsonSchema const schema{schemaStr};
+    auto const       violations = schema.validate(from_json_string(document));
+    ASSERT_EQ(violations.size(), 1UL);
+    ASSERT_NE(violations[0].message.find("k65"), std::string::npos);
+}
+
+TEST_F(JsonSchemaTest, invalid_schema_test)
+{
+    ASSERT_THROW(JsonSchema{R"({"type": "thing"})"}, std::invalid_argument);
+    ASSERT_THROW(JsonSchema{R"({"minLength": -1})"}, std::invalid_argument);
+    ASSERT_THROW(JsonSchema{R"({"$ref": "#/nowhere"})"}, std::invalid_argument);
+    ASSERT_THROW(JsonSchema{R"({"$ref": "other.json#/a"})"}, std::invalid_argument);
+    ASSERT_THROW(JsonSchema{R"({"pattern": "("})"}, std::invalid_argument);
+    ASSERT_THROW(JsonSchema{"42"}, std::invalid_argument);
+}
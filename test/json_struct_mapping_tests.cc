@@ -0,0 +1,162 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   test/json_struct_mapping_tests.cc
+ * Description: Unit tests for compile-time struct mappings
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+#include "json_object.h"
+#include "json_struct_mapping.h"
+
+#include <gtest/gtest.h>
+#include <optional>
+#include <string>
+
+using namespace std;
+using namespace util;
+
+struct Order
+{
+    int64_t               id{};
+    std::string           customer{};
+    double                total{};
+    bool                  paid{};
+    std::optional<int>    priority{};
+    uint16_t              firstQuantity{};
+    std::optional<string> note{};
+};
+
+template<>
+struct util::JsonMapping<Order>
+{
+    static constexpr auto fields = std::make_tuple(
+        jsonField("id", &Order::id),
+        jsonField("customer/name", &Order::customer),
+        jsonField("total", &Order::total),
+        jsonField("paid", &Order::paid),
+        jsonField("priority", &Order::priority),
+        jsonField("lines/[0]/quantity", &Order::firstQuantity),
+        jsonField("note", &Order::note)
+    );
+};
+
+struct BadOrder
+{
+    int id{};
+};
+
+template<>
+struct util::JsonMapping<BadOrder>
+{
+    static constexpr auto fields = std::make_tuple(jsonField("lines/[$]", &BadOrder::id));
+};
+
+class JsonStructMappingTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // just in case
+    }
+
+    void TearDown() override
+    {
+        // just in case
+    }
+};
+
+TEST_F(JsonStructMappingTest, parse_mapped_fields_test)
+{
+    auto order = struct_from_json<Order>(R"({
+        "id": 4711,
+        "ignored": {"deep": [1, 2, {"x": "y"}], "more": "text"},
+        "customer": {"name": "Ada \"the\" Countess", "address": {"city": "London"}},
+        "total": 12.5,
+        "paid": true,
+        "priority": null,
+        "lines": [{"quantity": 3, "sku": "a"}, {"quantity": 9}],
+        "note": "fragile"
+    })");
+
+    ASSERT_EQ(order.id, 4711);
+    ASSERT_EQ(order.customer, "Ada \"the\" Countess");
+    ASSERT_EQ(order.total, 12.5);
+    ASSERT_TRUE(order.paid);
+    ASSERT_EQ(order.priority, std::nullopt);
+    ASSERT_EQ(order.firstQuantity, 3);
+    ASSERT_EQ(order.note, "fragile");
+}
+
+TEST_F(JsonStructMappingTest, missing_fields_keep_values_test)
+{
+    Order order{};
+    order.customer = "unchanged";
+    struct_from_json(R"({"id": 1, "customer": 17})", order);
+    ASSERT_EQ(order.id, 1);
+    ASSERT_EQ(order.customer, "unchanged");
+}
+
+TEST_F(JsonStructMappingTest, parse_errors_test)
+{
+    ASSERT_THROW(static_cast<void>(struct_from_json<Order>(R"({"id": "text"})")), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(struct_from_json<Order>(R"({"id": {"nested": 1}})")), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(struct_from_json<Order>(R"({"lines": [{"quantity": 70000}]})")), std::out_of_range);
+    ASSERT_THROW(static_cast<void>(struct_from_json<Order>(R"({"id": )")), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(struct_from_json<Order>(R"({"id": 1} {"id": 2})")), std::invalid_argument);
+    ASSERT_THROW(static_cast<void>(struct_from_json<BadOrder>(R"({})")), std::invalid_argument);
+}
+
+TEST_F(JsonStructMappingTest, serialize_round_trip_test)
+{
+    Order order{};
+    order.id            = 7;
+    order.customer      = "Bob\n";
+    order.total         = 0.5;
+    order.paid          = false;
+    order.firstQuantity = 2;
+
+    auto const json = struct_to_json(order);
+    ASSERT_EQ(
+        json,
+        R"({"id":7,"customer":{"name":"Bob\n"},"total":0.5,"paid":false,"priority":null,"lines":[{"quantity":2}],)"
+        R"("note":null})"
+    );
+
+    auto const parsed = struct_from_json<Order>(json);
+    ASSERT_EQ(parsed.id, order.id);
+    ASSERT_EQ(parsed.customer, order.customer);
+    ASSERT_EQ(parsed.total, order.total);
+    ASSERT_EQ(parsed.firstQuantity, order.firstQuantity);
+
+    JsonObject const jsonObj{json};
+    ASSERT_EQ(jsonObj.get<std::string>("customer/name"), "Bob\n");
+}
+
+TEST_F(JsonStructMappingTest, layout_validation_test)
+{
+    std::array<std::string_view, 2> prefix{"a/b", "a/b/c"};
+    ASSERT_THROW(JsonStructLayout{prefix}, std::invalid_argument);
+    std::array<std::string_view, 2> duplicate{"a/b", "a/b"};
+    ASSERT_THROW(JsonStructLayout{duplicate}, std::invalid_argument);
+    std::array<std::string_view, 2> mixed{"a/b", "a/[0]"};
+    ASSERT_THROW(JsonStructLayout{mixed}, std::invalid_argument);
+    std::array<std::string_view, 2> valid{"a/[1]", "a/[0]/b"};
+    ASSERT_NO_THROW(JsonStructLayout{valid});
+}
@@ -0,0 +1,133 @@
+/*
+ * Repository:  https://github.com/kingkybel/JsonObject
+ * File Name:   test/json_traversal_tests.cc
+ * Description: Unit tests for the non-recursive traversal
+ *
+ * Copyright (C) 2024 Dieter J Kybelksties <github@kybelksties.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+ *
+ * @date: 2026-10-19
+ * @author: Dieter J Kybelksties
+ */
+
+#include "json_object.h"
+#include "json_traversal.h"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace util;
+
+class JsonTraversalTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // just in case
+    }
+
+    void TearDown() override
+    {
+        // just in case
+    }
+};
+
+TEST_F(JsonTraversalTest, traversal_steps_and_paths_test)
+{
+    JsonObject const jsonObj{R"({"a":{"b":[1,{"c":true}]},"d":"x","e":[]})"};
+
+    vector<string> steps;
+    for (auto walk = jsonObj.traverse(); walk.next();)
+    {
+        auto const event = walk.event() == JsonVisitEvent::enter   ? "enter "
+                           : walk.event() == JsonVisitEvent::leave ? "leave "
+                                                                   : "value ";
+        steps.push_back(event + walk.keyPath().toString());
+    }
+    vector<string> const expected{"enter ",
+                                  "enter a",
+                                  "enter a/b",
+                                  "value a/b/[0]",
+                                  "enter a/b/[1]",
+                                  "value a/b/[1]/c",
+                                  "leave a/b/[1]",
+                                  "leave a/b",
+                                  "leave a",
+                                  "value d",
+                                  "enter e",
+                                  "leave e",
+                                  "leave "};
+    ASSERT_EQ(steps, expected);
+
+    JsonTraversal scalar{value_type{42}};
+    ASSERT_TRUE(scalar.next());
+    ASSERT_EQ(scalar.event(), JsonVisitEvent::value);
+    ASSERT_EQ(scalar.depth(), 0);
+    ASSERT_FALSE(scalar.next());
+}
+
+TEST_F(JsonTraversalTest, visitor_skip_and_stop_test)
+{
+    JsonObject const jsonObj{R"({"skip":{"x":1,"y":2},"keep":{"z":3},"after":4})"};
+
+    vector<string> values;
+    ASSERT_TRUE(jsonObj.visit([&values](JsonTraversal const& walk) {
+        if (walk.event() == JsonVisitEvent::enter && walk.depth() == 1 && walk.path().back().key == "skip")
+        {
+            return JsonVisitAction::skipChildren;
+        }
+        if (walk.event() == JsonVisitEvent::value)
+        {
+            values.emplace_back(walk.path().back().key);
+        }
+        return JsonVisitAction::proceed;
+    }));
+    ASSERT_EQ(values, (vector<string>{"z", "after"}));
+
+    size_t steps = 0;
+    ASSERT_FALSE(jsonObj.visit([&steps](JsonTraversal const& walk) {
+        ++steps;
+        return walk.event() == JsonVisitEvent::value ? JsonVisitAction::stop : JsonVisitAction::proceed;
+    }));
+    ASSERT_EQ(steps, 3);
+}
+
+TEST_F(JsonTraversalTest, deep_document_printing_test)
+{
+    size_t const depth = 2000;
+    value_type   deep  = value_type{1};
+    for (size_t i = 0; i < depth; ++i)
+    {
+        array_type wrapper;
+        wrapper.push_back(std::move(deep));
+        deep = std::move(wrapper);
+    }
+    JsonObject jsonObj{};
+    jsonObj.set("deep", deep);
+
+    auto const text = jsonObj.toString(1);
+    ASSERT_EQ(text.find('1'), text.find(string(depth + 1, ' ') + "1") + depth + 1);
+    ASSERT_EQ(jsonObj.toString(0), R"({"deep":)" + to_json_string(deep) + "}");
+
+    size_t maxDepth = 0;
+    jsonObj.visit([&maxDepth](JsonTraversal const& walk) {
+        maxDepth = std::max(maxDepth, walk.depth());
+        return JsonVisitAction::proceed;
+    });
+    ASSERT_EQ(maxDepth, depth + 1);
+}